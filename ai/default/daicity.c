@@ -920,6 +920,7 @@ void dai_manage_cities(struct ai_type *ait, struct player *pplayer)
 
   /* Initialize the infrastructure cache, which is used shortly. */
   initialize_infrastructure_cache(pplayer);
+  dai_danger_round_begin(ait, pplayer);
   city_list_iterate(pplayer->cities, pcity) {
     struct ai_city *city_data = def_ai_city_data(pcity, ait);
     struct adv_choice *choice;
@@ -964,6 +965,7 @@ void dai_manage_cities(struct ai_type *ait, struct player *pplayer)
     TIMING_LOG(AIT_CITY_SETTLERS, TIMER_STOP);
     ADV_CHOICE_ASSERT(city_data->choice);
   } city_list_iterate_end;
+  dai_danger_round_end(ait, pplayer);
   /* Reset auto settler state for the next run. */
   dai_auto_settler_reset(ait, pplayer);
 
@@ -1151,6 +1153,7 @@ void dai_city_free(struct ai_type *ait, struct city *pcity)
 
   if (city_data != nullptr) {
     adv_deinit_choice(&(city_data->choice));
+    free(city_data->def_against.pct);
     city_set_ai_data(pcity, ait, nullptr);
     FC_FREE(city_data);
   }
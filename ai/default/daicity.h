@@ -51,6 +51,16 @@ struct ai_city {
   int wallvalue;                /* How much it helps for defenders to be
                                    ground units */
 
+  /* 100 + EFT_DEFEND_BONUS of the city against each unit type, and
+   * what it was calculated from; see dai_city_def_against(). */
+  struct {
+    int *pct;
+    int turn;
+    const struct government *gov;
+    int techs;
+    int buildings;
+  } def_against;
+
   int distance_to_wonder_city;  /* Wondercity will set this for us,
                                    avoiding paradox */
 
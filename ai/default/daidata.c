@@ -37,6 +37,7 @@
 #include "daidiplomacy.h"
 #include "daieffects.h"
 #include "daiferry.h"
+#include "daimilitary.h"
 #include "daiplayer.h"
 #include "daisettler.h"
 #include "daiunit.h"
@@ -96,6 +97,9 @@ void dai_data_init(struct ai_type *ait, struct player *pplayer)
 
   /* Initialise autoworker. */
   dai_auto_settler_init(ai);
+
+  ai->danger = NULL;
+  dai_danger_init(ai);
 }
 
 /************************************************************************//**
@@ -112,6 +116,8 @@ void dai_data_close(struct ai_type *ait, struct player *pplayer)
   /* Free autoworker. */
   dai_auto_settler_free(ai);
 
+  dai_danger_free(ai);
+
   if (ai->diplomacy.player_intel_slots != NULL) {
     players_iterate(aplayer) {
       /* destroy the ai diplomacy states of this player with others ... */
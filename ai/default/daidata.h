@@ -100,6 +100,9 @@ struct ai_plr
   /* Cache map for AI settlers; defined in daisettler.c. */
   struct ai_settler *settler;
 
+  /* Reachability cache for danger assessment; defined in daimilitary.c. */
+  struct ai_danger *danger;
+
   /* The units of tech_want seem to be shields */
   adv_want tech_want[A_LAST+1];
 };
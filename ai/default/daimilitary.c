@@ -83,6 +83,46 @@ static adv_want dai_unit_attack_desirability(struct ai_type *ait,
 static adv_want dai_unit_defense_desirability(struct ai_type *ait,
                                               const struct unit_type *punittype);
 
+/* Cities of the assessing player a potentially dangerous unit can reach
+ * within the assessment range, and in how many turns. Computed with one
+ * path finding map per unit and shared by all the cities assessed in
+ * the same round. */
+struct danger_reach {
+  const struct tile *tile;      /* Position of the unit when computed */
+  int move_rate;
+  int num_cities;
+  struct {
+    int id;
+    int turn;
+  } *cities;
+};
+
+static void danger_reach_destroy(struct danger_reach *reach);
+
+/* struct danger_reach_hash, keyed by unit id. */
+#define SPECHASH_TAG danger_reach
+#define SPECHASH_INT_KEY_TYPE
+#define SPECHASH_IDATA_TYPE struct danger_reach *
+#define SPECHASH_IDATA_FREE danger_reach_destroy
+#include "spechash.h"
+
+struct ai_danger {
+  struct danger_reach_hash *reach;
+
+  /* Between dai_danger_round_begin() and dai_danger_round_end(). */
+  bool active;
+
+  /* What the cached reachabilities are valid for. */
+  int max_turns;
+  bool omniscient;
+};
+
+/* Where assess_danger_unit() gets the travel times from. */
+struct danger_paths {
+  struct ai_danger *shared;             /* Shared per unit maps, or */
+  struct pf_reverse_map *city_map;      /* a map for this city only. */
+};
+
 /**********************************************************************//**
   Choose the best unit the city can build to defend against attacker v.
 **************************************************************************/
@@ -530,22 +570,304 @@ action_may_happen_unit_on_city(const action_id wanted_action,
   return FALSE;
 }
 
+/**********************************************************************//**
+  Free a danger_reach.
+**************************************************************************/
+static void danger_reach_destroy(struct danger_reach *reach)
+{
+  free(reach->cities);
+  free(reach);
+}
+
+/**********************************************************************//**
+  Initialize the danger reachability cache of the player.
+**************************************************************************/
+void dai_danger_init(struct ai_plr *ai)
+{
+  fc_assert_ret(ai != NULL);
+  fc_assert_ret(ai->danger == NULL);
+
+  ai->danger = fc_calloc(1, sizeof(*ai->danger));
+  ai->danger->reach = danger_reach_hash_new();
+  ai->danger->active = FALSE;
+}
+
+/**********************************************************************//**
+  Free the danger reachability cache of the player.
+**************************************************************************/
+void dai_danger_free(struct ai_plr *ai)
+{
+  fc_assert_ret(ai != NULL);
+
+  if (ai->danger != NULL) {
+    danger_reach_hash_destroy(ai->danger->reach);
+    FC_FREE(ai->danger);
+  }
+}
+
+/**********************************************************************//**
+  Start a round of danger assessments for the cities of pplayer. Until
+  dai_danger_round_end(), the map, the units and the cities are assumed
+  not to change, so the reachabilities found for one city are reused for
+  the others.
+**************************************************************************/
+void dai_danger_round_begin(struct ai_type *ait, struct player *pplayer)
+{
+  struct ai_danger *danger = def_ai_player_data(pplayer, ait)->danger;
+
+  danger_reach_hash_clear(danger->reach);
+  danger->active = TRUE;
+}
+
+/**********************************************************************//**
+  End a round of danger assessments for the cities of pplayer.
+**************************************************************************/
+void dai_danger_round_end(struct ai_type *ait, struct player *pplayer)
+{
+  struct ai_danger *danger = def_ai_player_data(pplayer, ait)->danger;
+
+  danger_reach_hash_clear(danger->reach);
+  danger->active = FALSE;
+}
+
+/**********************************************************************//**
+  Drop the cached reachabilities if they were computed for another
+  assessment range.
+**************************************************************************/
+static void dai_danger_prepare(struct ai_danger *danger,
+                               int max_turns, bool omniscient)
+{
+  if (danger->max_turns != max_turns
+      || danger->omniscient != omniscient) {
+    danger_reach_hash_clear(danger->reach);
+    danger->max_turns = max_turns;
+    danger->omniscient = omniscient;
+  }
+}
+
+/**********************************************************************//**
+  Return which cities of pplayer punit can reach, computing it if it's
+  not known yet.
+
+  pf_reverse_map_new_for_city() makes the city tile the only action tile
+  of the map, so a unit can attack it even when it could not enter it,
+  while the other cities stay passable. One map can't have every city
+  both ways, so here all the cities are passable, and each is reached
+  with an attack from the first processed adjacent position, costing
+  what the path finding code would charge for it. As the arrival cost
+  never decreases with the cost of the adjacent position, that gives
+  the same turn as a map of its own.
+**************************************************************************/
+static const struct danger_reach *
+dai_danger_reach(const struct civ_map *nmap, struct ai_danger *danger,
+                 struct player *pplayer, const struct unit *punit)
+{
+  struct danger_reach *reach;
+  struct pf_parameter parameter;
+  struct pf_map *pfm;
+  const struct city *pcity;
+  bool civilian;
+  int attack_cost;
+  int max_cost;
+  int size = 0;
+
+  if (danger_reach_hash_lookup(danger->reach, punit->id, &reach)
+      && reach->tile == unit_tile(punit)
+      && reach->move_rate == unit_move_rate(punit)) {
+    return reach;
+  }
+
+  reach = fc_malloc(sizeof(*reach));
+  reach->tile = unit_tile(punit);
+  reach->move_rate = unit_move_rate(punit);
+  reach->num_cities = 0;
+  reach->cities = NULL;
+
+  /* Without a target tile, the reverse parameter has no action tiles. */
+  pft_fill_reverse_parameter(nmap, &parameter, NULL);
+  parameter.owner = unit_owner(punit);
+  parameter.omniscience = danger->omniscient;
+  parameter.start_tile = unit_tile(punit);
+  parameter.move_rate = reach->move_rate;
+  parameter.moves_left_initially = reach->move_rate;
+  parameter.utype = unit_type_get(punit);
+
+  civilian = utype_has_flag(parameter.utype, UTYF_CIVILIAN);
+  if (utype_action_takes_all_mp(parameter.utype,
+                                action_by_number(ACTION_ATTACK))
+      || utype_can_do_action(parameter.utype, ACTION_SUICIDE_ATTACK)) {
+    attack_cost = parameter.move_rate;
+  } else {
+    attack_cost = SINGLE_MOVE;
+  }
+
+  max_cost = parameter.move_rate * (danger->max_turns + 1);
+  pcity = tile_city(parameter.start_tile);
+  if (pcity != NULL && city_owner(pcity) == pplayer) {
+    /* Already there, for example an allied unit. */
+    reach->cities = fc_malloc(sizeof(*reach->cities));
+    reach->cities[0].id = pcity->id;
+    reach->cities[0].turn = 0;
+    reach->num_cities = size = 1;
+  }
+
+  pfm = pf_map_new(&parameter);
+  pf_map_positions_iterate(pfm, pos, TRUE) {
+    int moves_left;
+
+    if (pos.total_MC >= max_cost) {
+      break;
+    }
+
+    /* pos.moves_left is 0 at the turn change, the path finding code
+     * counts a full turn of moves there. */
+    moves_left = parameter.move_rate - pos.total_MC % parameter.move_rate;
+
+    adjc_iterate(nmap, pos.tile, ptile) {
+      int cost, i;
+
+      pcity = tile_city(ptile);
+      if (pcity == NULL || city_owner(pcity) != pplayer) {
+        continue;
+      }
+      for (i = 0; i < reach->num_cities; i++) {
+        if (reach->cities[i].id == pcity->id) {
+          break;
+        }
+      }
+      if (i < reach->num_cities) {
+        /* Already reached at no later turn. */
+        continue;
+      }
+
+      if (parameter.omniscience
+          || TILE_UNKNOWN != tile_get_known(ptile, parameter.owner)) {
+        if (!civilian && !player_can_invade_tile(parameter.owner, ptile)) {
+          continue;
+        }
+        cost = attack_cost;
+      } else {
+        cost = parameter.utype->unknown_move_cost;
+      }
+      cost = pos.total_MC + MIN(cost, moves_left);
+      if (cost >= max_cost) {
+        continue;
+      }
+
+      if (reach->num_cities == size) {
+        size = MAX(4, 2 * size);
+        reach->cities = fc_realloc(reach->cities,
+                                   size * sizeof(*reach->cities));
+      }
+      reach->cities[reach->num_cities].id = pcity->id;
+      reach->cities[reach->num_cities].turn = cost / parameter.move_rate;
+      reach->num_cities++;
+    } adjc_iterate_end;
+  } pf_map_positions_iterate_end;
+  pf_map_destroy(pfm);
+
+  danger_reach_hash_replace(danger->reach, punit->id, reach);
+
+  return reach;
+}
+
+/**********************************************************************//**
+  In how many turns can punit reach the city? Returns FALSE if it can't
+  within the assessment range.
+**************************************************************************/
+static bool danger_unit_turns(const struct civ_map *nmap,
+                              struct danger_paths *paths,
+                              const struct city *pcity,
+                              const struct unit *punit, int *turns)
+{
+  const struct danger_reach *reach;
+  struct pf_position pos;
+  int i;
+
+  if (paths->shared == NULL) {
+    if (pf_reverse_map_unit_position(paths->city_map, punit, &pos)) {
+      *turns = pos.turn;
+      return TRUE;
+    }
+    return FALSE;
+  }
+
+  reach = dai_danger_reach(nmap, paths->shared, city_owner(pcity), punit);
+  for (i = 0; i < reach->num_cities; i++) {
+    if (reach->cities[i].id == pcity->id) {
+      *turns = reach->cities[i].turn;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**********************************************************************//**
+  Return 100 + EFT_DEFEND_BONUS of the city against each unit type,
+  at least 1. Kept in the city's ai data until the turn, the
+  government, the number of known techs or the buildings of the city
+  change.
+**************************************************************************/
+static const int *dai_city_def_against(struct ai_type *ait,
+                                       struct city *pcity)
+{
+  struct ai_city *city_data = def_ai_city_data(pcity, ait);
+  struct player *pplayer = city_owner(pcity);
+  const struct government *gov = government_of_player(pplayer);
+  int techs = research_get(pplayer)->techs_researched;
+  int buildings = 0;
+
+  city_built_iterate(pcity, pimprove) {
+    buildings++;
+  } city_built_iterate_end;
+
+  if (city_data->def_against.pct != NULL
+      && city_data->def_against.turn == game.info.turn
+      && city_data->def_against.gov == gov
+      && city_data->def_against.techs == techs
+      && city_data->def_against.buildings == buildings) {
+    return city_data->def_against.pct;
+  }
+
+  if (city_data->def_against.pct == NULL) {
+    city_data->def_against.pct
+      = fc_malloc(game.control.num_unit_types
+                  * sizeof(*city_data->def_against.pct));
+  }
+
+  unit_type_iterate(utype) {
+    int pct = 100 + get_unittype_bonus(pplayer, city_tile(pcity), utype,
+                                       NULL, EFT_DEFEND_BONUS);
+
+    city_data->def_against.pct[utype_index(utype)] = MAX(pct, 1);
+  } unit_type_iterate_end;
+
+  city_data->def_against.turn = game.info.turn;
+  city_data->def_against.gov = gov;
+  city_data->def_against.techs = techs;
+  city_data->def_against.buildings = buildings;
+
+  return city_data->def_against.pct;
+}
+
 /**********************************************************************//**
   How dangerous and far a unit is for a city?
 **************************************************************************/
 static unsigned int assess_danger_unit(const struct civ_map *nmap,
                                        const struct city *pcity,
-                                       struct pf_reverse_map *pcity_map,
+                                       struct danger_paths *paths,
+                                       const int *city_def_against,
                                        const struct unit *punit,
                                        int *move_time)
 {
-  struct pf_position pos;
   const struct unit_type *punittype = unit_type_get(punit);
   const struct tile *ptile = city_tile(pcity);
   const struct player *uowner = unit_owner(punit);
   const struct unit *ferry;
   unsigned int danger;
-  int amod = -99, dmod;
+  int amod = -99;
+  int turns;
   bool attack_danger = FALSE;
 
   *move_time = PF_IMPOSSIBLE_MC;
@@ -557,18 +879,18 @@ static unsigned int assess_danger_unit(const struct civ_map *nmap,
                   / punittype->paratroopers_range);
   }
 
-  if (pf_reverse_map_unit_position(pcity_map, punit, &pos)
+  if (danger_unit_turns(nmap, paths, pcity, punit, &turns)
       && (PF_IMPOSSIBLE_MC == *move_time
-          || *move_time > pos.turn)) {
-    *move_time = pos.turn;
+          || *move_time > turns)) {
+    *move_time = turns;
   }
 
   if (unit_transported(punit)
       && (ferry = unit_transport_get(punit))
-      && pf_reverse_map_unit_position(pcity_map, ferry, &pos)) {
+      && danger_unit_turns(nmap, paths, pcity, ferry, &turns)) {
     if ((PF_IMPOSSIBLE_MC == *move_time
-         || *move_time > pos.turn)) {
-      *move_time = pos.turn;
+         || *move_time > turns)) {
+      *move_time = turns;
       if (!can_attack_from_non_native(punittype)) {
         (*move_time)++;
       }
@@ -630,9 +952,7 @@ static unsigned int assess_danger_unit(const struct civ_map *nmap,
   }
 
   danger = adv_unit_att_rating(punit);
-  dmod = 100 + get_unittype_bonus(city_owner(pcity), ptile,
-                                  punittype, NULL, EFT_DEFEND_BONUS);
-  return danger * (amod + 100) / MAX(dmod, 1);
+  return danger * (amod + 100) / city_def_against[utype_index(punittype)];
 }
 
 /**********************************************************************//**
@@ -646,9 +966,11 @@ void dai_assess_danger_player(struct ai_type *ait,
 {
   /* Do nothing if game is not running */
   if (S_S_RUNNING == server_state()) {
+    dai_danger_round_begin(ait, pplayer);
     city_list_iterate(pplayer->cities, pcity) {
       (void) assess_danger(ait, nmap, pcity, NULL);
     } city_list_iterate_end;
+    dai_danger_round_end(ait, pplayer);
   }
 }
 
@@ -729,9 +1051,10 @@ static unsigned int assess_danger(struct ai_type *ait,
   bool defender_type_handled[U_LAST];
   int best_non_scramble[U_LAST];
   bool sth_does_not_scramble = FALSE;
-  int city_def_against[U_LAST];
+  const int *city_def_against;
   int assess_turns;
   bool omnimap;
+  struct danger_paths paths = { .shared = NULL, .city_map = NULL };
 
   TIMING_LOG(AIT_DANGER, TIMER_START);
 
@@ -746,17 +1069,13 @@ static unsigned int assess_danger(struct ai_type *ait,
   city_data->diplomat_threat = FALSE;
   city_data->has_diplomat = FALSE;
 
+  city_def_against = dai_city_def_against(ait, pcity);
   unit_type_iterate(utype) {
     int idx = utype_index(utype);
 
     defense_bonuses_pct[idx] = 0;
     defender_type_handled[idx] = FALSE;
     best_non_scramble[idx] = -1;
-    /* FIXME: cache it somewhere? */
-    city_def_against[idx]
-      = 100 + get_unittype_bonus(pplayer, ptile, utype, NULL,
-                                 EFT_DEFEND_BONUS);
-    city_def_against[idx] = MAX(city_def_against[idx], 1);
   } unit_type_iterate_end;
 
   /* What flag-specific bonuses do our units have. */
@@ -823,9 +1142,14 @@ static unsigned int assess_danger(struct ai_type *ait,
 
   omnimap = !has_handicap(pplayer, H_MAP);
 
+  if (ul_cb == NULL && def_ai_player_data(pplayer, ait)->danger->active) {
+    /* Real units, travel times can be shared with the other cities. */
+    paths.shared = def_ai_player_data(pplayer, ait)->danger;
+    dai_danger_prepare(paths.shared, assess_turns, omnimap);
+  }
+
   /* Check. */
   players_iterate(aplayer) {
-    struct pf_reverse_map *pcity_map;
     struct unit_list *units;
 
     if (!adv_is_player_dangerous(pplayer, aplayer)) {
@@ -834,9 +1158,10 @@ static unsigned int assess_danger(struct ai_type *ait,
     /* Note that we still consider the units of players we are not (yet)
      * at war with. */
 
-    pcity_map = pf_reverse_map_new_for_city(nmap, pcity, aplayer, assess_turns,
-                                            omnimap);
-
+    if (paths.shared == NULL) {
+      paths.city_map = pf_reverse_map_new_for_city(nmap, pcity, aplayer,
+                                                   assess_turns, omnimap);
+    }
     if (ul_cb != NULL) {
       units = ul_cb(aplayer);
     } else {
@@ -871,8 +1196,9 @@ static unsigned int assess_danger(struct ai_type *ait,
       }
 
       /* Defender unspecific vulnerability and potential move time */
-      vulnerability = assess_danger_unit(nmap, pcity, pcity_map,
-                                         punit, &move_time);
+      vulnerability = assess_danger_unit(nmap, pcity, &paths,
+                                         city_def_against, punit,
+                                         &move_time);
 
       if (PF_IMPOSSIBLE_MC == move_time) {
         continue;
@@ -939,8 +1265,10 @@ static unsigned int assess_danger(struct ai_type *ait,
       total_danger += vulnerability;
     } unit_list_iterate_end;
 
-    pf_reverse_map_destroy(pcity_map);
-
+    if (paths.city_map != NULL) {
+      pf_reverse_map_destroy(paths.city_map);
+      paths.city_map = NULL;
+    }
   } players_iterate_end;
 
   if (total_danger) {
@@ -20,6 +20,7 @@
 /* server/advisors */
 #include "advchoice.h"
 
+struct ai_plr;
 struct civ_map;
 
 #ifdef FREECIV_WEB
@@ -42,6 +43,10 @@ struct adv_choice *military_advisor_choose_build(struct ai_type *ait,
                                                  player_unit_list_getter ul_cb);
 void dai_assess_danger_player(struct ai_type *ait,
                               const struct civ_map *nmap, struct player *pplayer);
+void dai_danger_init(struct ai_plr *ai);
+void dai_danger_free(struct ai_plr *ai);
+void dai_danger_round_begin(struct ai_type *ait, struct player *pplayer);
+void dai_danger_round_end(struct ai_type *ait, struct player *pplayer);
 int assess_defense_quadratic(struct ai_type *ait, struct city *pcity);
 int assess_defense_unit(struct ai_type *ait, struct city *pcity,
                         struct unit *punit, bool igwall);
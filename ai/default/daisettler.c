@@ -125,6 +125,8 @@ struct tile_data_cache {
   int reserved; /* Reservation for this tile; used by print_citymap() */
 
   int turn;     /* The turn the values were calculated */
+
+  unsigned int fingerprint; /* Tile state the values were calculated for */
 };
 
 
@@ -141,7 +143,13 @@ static void tile_data_cache_destroy(struct tile_data_cache *ptdc);
 #include "spechash.h"
 
 struct ai_settler {
-  struct tile_data_cache_hash *tdc_hash;
+  /* Tile values by tile index. They are kept over turns, and a value is
+   * recalculated only once the tile, or the player state it depends on,
+   * has changed. Entries with turn < 0 have not been calculated. */
+  struct tile_data_cache *tdc_grid;
+  int tdc_grid_size;
+  unsigned int tdc_player_hash;
+  int tdc_player_turn;
 
 #ifdef FREECIV_DEBUG
   struct {
@@ -186,8 +194,9 @@ enum cb_error_level { CBE_OK, CBE_RECOVERABLE, CBE_FATAL };
 
 static const struct tile_data_cache *tdc_plr_get(struct ai_type *ait,
                                                  struct player *plr,
-                                                 int tindex);
-static void tdc_plr_set(struct ai_type *ait, struct player *plr, int tindex,
+                                                 const struct tile *ptile);
+static void tdc_plr_set(struct ai_type *ait, struct player *plr,
+                        const struct tile *ptile,
                         const struct tile_data_cache *tdcache);
 
 static struct cityresult *cityresult_new(struct tile *ptile);
@@ -307,7 +316,6 @@ static struct cityresult *cityresult_fill(struct ai_type *ait,
 
   city_tile_iterate_index(nmap, result->city_radius_sq, result->tile, ptile,
                           cindex) {
-    int tindex = tile_index(ptile);
     int reserved = citymap_read(ptile);
     bool city_center = (result->tile == ptile); /* is_city_center() */
     struct tile_data_cache *ptdc;
@@ -324,7 +332,7 @@ static struct cityresult *cityresult_fill(struct ai_type *ait,
       ptdc->reserved = reserved;
       /* ptdc->turn was set by tile_data_cache_new(). */
     } else {
-      const struct tile_data_cache *ptdc_hit = tdc_plr_get(ait, pplayer, tindex);
+      const struct tile_data_cache *ptdc_hit = tdc_plr_get(ait, pplayer, ptile);
 
       if (!ptdc_hit || city_center) {
         /* We cannot read city center from cache */
@@ -349,7 +357,7 @@ static struct cityresult *cityresult_fill(struct ai_type *ait,
         if (!city_center && virtual_city) {
           /* Real cities and any city center will give us possibly
            * skewed results */
-          tdc_plr_set(ait, pplayer, tindex, tile_data_cache_copy(ptdc));
+          tdc_plr_set(ait, pplayer, ptile, ptdc);
         }
       } else {
         ptdc = tile_data_cache_copy(ptdc_hit);
@@ -494,6 +502,7 @@ struct tile_data_cache *
   ptdc_copy->sum = ptdc->sum;
   ptdc_copy->reserved = ptdc->reserved;
   ptdc_copy->turn = ptdc->turn;
+  ptdc_copy->fingerprint = ptdc->fingerprint;
 
   return ptdc_copy;
 }
@@ -509,28 +518,108 @@ static void tile_data_cache_destroy(struct tile_data_cache *ptdc)
 }
 
 /*************************************************************************//**
-  Return player's tile data cache
+  Return player's tile data grid, making sure it matches the current map
+  and player state. Any change in the player state the tile values depend
+  on invalidates the whole grid.
 *****************************************************************************/
-static const struct tile_data_cache *tdc_plr_get(struct ai_type *ait,
-                                                 struct player *plr,
-                                                 int tindex)
+static struct tile_data_cache *tdc_plr_grid(struct ai_type *ait,
+                                            struct player *plr)
 {
   struct ai_plr *ai = dai_plr_data_get(ait, plr, NULL);
+  struct ai_settler *settler;
+  bool invalidate = FALSE;
 
   fc_assert_ret_val(ai != NULL, NULL);
   fc_assert_ret_val(ai->settler != NULL, NULL);
-  fc_assert_ret_val(ai->settler->tdc_hash != NULL, NULL);
 
+  settler = ai->settler;
+
+  if (settler->tdc_grid_size != MAP_INDEX_SIZE) {
+    free(settler->tdc_grid);
+    settler->tdc_grid_size = MAP_INDEX_SIZE;
+    settler->tdc_grid = fc_malloc(settler->tdc_grid_size
+                                  * sizeof(*settler->tdc_grid));
+    settler->tdc_player_turn = -1;
+    invalidate = TRUE;
+  }
+
+  if (settler->tdc_player_turn != game.info.turn) {
+    /* Values are calculated with the target government, and weighted
+     * with the current priorities. */
+    struct adv_data *adv = adv_data_get(plr, NULL);
+    unsigned int hash = adv_player_fingerprint(plr);
+
+    hash = adv_fingerprint_add(hash,
+                               government_number(adv->goal.govt.gov));
+    hash = adv_fingerprint_add(hash, adv->food_priority);
+    hash = adv_fingerprint_add(hash, adv->science_priority);
+    hash = adv_fingerprint_add(hash, adv->shield_priority);
+
+    if (hash != settler->tdc_player_hash) {
+      settler->tdc_player_hash = hash;
+      invalidate = TRUE;
+    }
+    settler->tdc_player_turn = game.info.turn;
+  }
+
+  if (invalidate) {
+    int i;
+
+    for (i = 0; i < settler->tdc_grid_size; i++) {
+      settler->tdc_grid[i].turn = -1;
+    }
+  }
+
+  return settler->tdc_grid;
+}
+
+/*************************************************************************//**
+  Fingerprint of the tile state the cached tile values depend on. Unlike
+  the infrastructure cache, only the tile itself counts, as the output
+  of a tile does not depend on its neighbors.
+*****************************************************************************/
+static unsigned int tdc_tile_fingerprint(const struct tile *ptile)
+{
+  const struct extra_type *presource = tile_resource(ptile);
+  const struct player *owner = tile_owner(ptile);
+  unsigned int hash = ADV_FINGERPRINT_INIT;
+  size_t i;
+
+  hash = adv_fingerprint_add(hash, terrain_number(tile_terrain(ptile)));
+  hash = adv_fingerprint_add(hash, presource != NULL
+                                   ? extra_number(presource) + 1 : 0);
+  hash = adv_fingerprint_add(hash, owner != NULL
+                                   ? player_number(owner) + 1 : 0);
+  for (i = 0; i < ARRAY_SIZE(ptile->extras.vec); i++) {
+    hash = adv_fingerprint_add(hash, ptile->extras.vec[i]);
+  }
+
+  return hash;
+}
+
+/*************************************************************************//**
+  Return player's tile data cache
+*****************************************************************************/
+static const struct tile_data_cache *tdc_plr_get(struct ai_type *ait,
+                                                 struct player *plr,
+                                                 const struct tile *ptile)
+{
+  struct tile_data_cache *grid = tdc_plr_grid(ait, plr);
   struct tile_data_cache *ptdc;
+#ifdef FREECIV_DEBUG
+  struct ai_plr *ai = dai_plr_data_get(ait, plr, NULL);
+#endif /* FREECIV_DEBUG */
 
-  tile_data_cache_hash_lookup(ai->settler->tdc_hash, tindex, &ptdc);
+  fc_assert_ret_val(grid != NULL, NULL);
 
-  if (!ptdc) {
+  ptdc = &grid[tile_index(ptile)];
+
+  if (ptdc->turn < 0) {
 #ifdef FREECIV_DEBUG
     ai->settler->cache.miss++;
 #endif /* FREECIV_DEBUG */
     return NULL;
-  } else if (ptdc->turn != game.info.turn) {
+  } else if (ptdc->fingerprint != tdc_tile_fingerprint(ptile)) {
 #ifdef FREECIV_DEBUG
     ai->settler->cache.old++;
 #endif /* FREECIV_DEBUG */
@@ -546,21 +635,26 @@ static const struct tile_data_cache *tdc_plr_get(struct ai_type *ait,
 /*************************************************************************//**
   Store player's tile data cache
 *****************************************************************************/
-static void tdc_plr_set(struct ai_type *ait, struct player *plr, int tindex,
+static void tdc_plr_set(struct ai_type *ait, struct player *plr,
+                        const struct tile *ptile,
                         const struct tile_data_cache *ptdc)
 {
+  struct tile_data_cache *grid = tdc_plr_grid(ait, plr);
+  struct tile_data_cache *pslot;
+#ifdef FREECIV_DEBUG
   struct ai_plr *ai = dai_plr_data_get(ait, plr, NULL);
+#endif /* FREECIV_DEBUG */
 
-  fc_assert_ret(ai != NULL);
-  fc_assert_ret(ai->settler != NULL);
-  fc_assert_ret(ai->settler->tdc_hash != NULL);
+  fc_assert_ret(grid != NULL);
   fc_assert_ret(ptdc != NULL);
 
 #ifdef FREECIV_DEBUG
-    ai->settler->cache.save++;
+  ai->settler->cache.save++;
 #endif /* FREECIV_DEBUG */
 
-  tile_data_cache_hash_replace(ai->settler->tdc_hash, tindex, ptdc);
+  pslot = &grid[tile_index(ptile)];
+  *pslot = *ptdc;
+  pslot->fingerprint = tdc_tile_fingerprint(ptile);
 }
 
 /*************************************************************************//**
@@ -1016,7 +1110,9 @@ void dai_auto_settler_init(struct ai_plr *ai)
   fc_assert_ret(ai->settler == NULL);
 
   ai->settler = fc_calloc(1, sizeof(*ai->settler));
-  ai->settler->tdc_hash = tile_data_cache_hash_new();
+  ai->settler->tdc_grid = NULL;
+  ai->settler->tdc_grid_size = 0;
+  ai->settler->tdc_player_turn = -1;
 
 #ifdef FREECIV_DEBUG
   ai->settler->cache.hit = 0;
@@ -1225,7 +1321,6 @@ void dai_auto_settler_reset(struct ai_type *ait, struct player *pplayer)
 
   fc_assert_ret(ai != NULL);
   fc_assert_ret(ai->settler != NULL);
-  fc_assert_ret(ai->settler->tdc_hash != NULL);
 
 #ifdef FREECIV_DEBUG
   log_debug("[aisettler cache for %s] save: %d, miss: %d, old: %d, hit: %d",
@@ -1239,7 +1334,7 @@ void dai_auto_settler_reset(struct ai_type *ait, struct player *pplayer)
   ai->settler->cache.save = 0;
 #endif /* FREECIV_DEBUG */
 
-  tile_data_cache_hash_clear(ai->settler->tdc_hash);
+  /* The tile data grid is kept for the next run. */
 
   if (caller_closes) {
     dai_data_phase_finished(ait, pplayer);
@@ -1254,9 +1349,7 @@ void dai_auto_settler_free(struct ai_plr *ai)
   fc_assert_ret(ai != NULL);
 
   if (ai->settler) {
-    if (ai->settler->tdc_hash) {
-      tile_data_cache_hash_destroy(ai->settler->tdc_hash);
-    }
+    free(ai->settler->tdc_grid);
     free(ai->settler);
   }
   ai->settler = NULL;
@@ -15,31 +15,157 @@
 #include <fc_config.h>
 #endif
 
+#include <string.h>
+
+/* utility */
+#include "mem.h"
+
 /* ai/tex */
 #include "texaiplayer.h"
 
 #include "texaimsg.h"
 
+struct texai_ring_chunk
+{
+  /* Set by the producer once it has moved on to the next chunk */
+  _Atomic(struct texai_ring_chunk *) next;
+  /* Number of slots the producer has filled */
+  atomic_int written;
+  char slots[];
+};
+
+/**********************************************************************//**
+  Allocate an empty ring chunk.
+**************************************************************************/
+static struct texai_ring_chunk *texai_ring_chunk_new(size_t slot_size)
+{
+  struct texai_ring_chunk *chunk
+    = fc_malloc(sizeof(*chunk) + slot_size * TEXAI_RING_SLOTS);
+
+  atomic_init(&chunk->next, NULL);
+  atomic_init(&chunk->written, 0);
+
+  return chunk;
+}
+
+/**********************************************************************//**
+  Initialize ring whose slots are slot_size bytes each.
+**************************************************************************/
+void texai_ring_init(struct texai_ring *ring, size_t slot_size)
+{
+  ring->slot_size = slot_size;
+  ring->head = texai_ring_chunk_new(slot_size);
+  ring->head_pos = 0;
+  ring->tail = ring->head;
+  ring->tail_pos = 0;
+  atomic_init(&ring->spare, NULL);
+}
+
+/**********************************************************************//**
+  Free the ring. Neither end may be in use any more.
+**************************************************************************/
+void texai_ring_free(struct texai_ring *ring)
+{
+  struct texai_ring_chunk *chunk = ring->head;
+
+  while (chunk != NULL) {
+    struct texai_ring_chunk *next = atomic_load(&chunk->next);
+
+    free(chunk);
+    chunk = next;
+  }
+  free(atomic_load(&ring->spare));
+
+  ring->head = NULL;
+  ring->tail = NULL;
+}
+
+/**********************************************************************//**
+  Append copy of the slot to the ring. Producer side only.
+**************************************************************************/
+void texai_ring_push(struct texai_ring *ring, const void *slot)
+{
+  struct texai_ring_chunk *chunk = ring->tail;
+
+  if (ring->tail_pos == TEXAI_RING_SLOTS) {
+    struct texai_ring_chunk *next = atomic_exchange(&ring->spare, NULL);
+
+    if (next == NULL) {
+      next = texai_ring_chunk_new(ring->slot_size);
+    } else {
+      atomic_store_explicit(&next->next, NULL, memory_order_relaxed);
+      atomic_store_explicit(&next->written, 0, memory_order_relaxed);
+    }
+
+    atomic_store_explicit(&chunk->next, next, memory_order_release);
+    ring->tail = chunk = next;
+    ring->tail_pos = 0;
+  }
+
+  memcpy(chunk->slots + ring->slot_size * ring->tail_pos, slot,
+         ring->slot_size);
+  atomic_store_explicit(&chunk->written, ++ring->tail_pos,
+                        memory_order_release);
+}
+
+/**********************************************************************//**
+  Take the oldest slot from the ring. Consumer side only.
+  Returns FALSE if the ring is empty.
+**************************************************************************/
+bool texai_ring_pop(struct texai_ring *ring, void *slot)
+{
+  struct texai_ring_chunk *chunk = ring->head;
+
+  if (ring->head_pos == TEXAI_RING_SLOTS) {
+    struct texai_ring_chunk *next
+      = atomic_load_explicit(&chunk->next, memory_order_acquire);
+
+    if (next == NULL) {
+      return FALSE;
+    }
+
+    ring->head = next;
+    ring->head_pos = 0;
+
+    /* Hand the emptied chunk back to the producer, unless it already
+     * has one waiting. */
+    chunk = atomic_exchange(&ring->spare, chunk);
+    free(chunk);
+    chunk = next;
+  }
+
+  if (ring->head_pos
+      >= atomic_load_explicit(&chunk->written, memory_order_acquire)) {
+    return FALSE;
+  }
+
+  memcpy(slot, chunk->slots + ring->slot_size * ring->head_pos,
+         ring->slot_size);
+  ring->head_pos++;
+
+  return TRUE;
+}
+
 /**********************************************************************//**
-  Construct and send message to player thread.
+  Construct and send message to player threads.
 **************************************************************************/
 void texai_send_msg(enum texaimsgtype type, struct player *pplayer,
-                    void *data)
+                    const union texai_msg_data *data)
 {
-  struct texai_msg *msg;
+  struct texai_msg msg;
 
   if (!texai_thread_running()) {
     /* No player thread to send messages to */
     return;
   }
 
-  msg = fc_malloc(sizeof(*msg));
-
-  msg->type = type;
-  msg->plr = pplayer;
-  msg->data = data;
+  msg.type = type;
+  msg.plr = pplayer;
+  if (data != NULL) {
+    msg.data = *data;
+  }
 
-  texai_msg_to_thr(msg);
+  texai_msg_to_thr(&msg);
 }
 
 /**********************************************************************//**
@@ -48,13 +174,13 @@ void texai_send_msg(enum texaimsgtype type, struct player *pplayer,
 void texai_send_req(enum texaireqtype type, struct player *pplayer,
                     void *data)
 {
-  struct texai_req *req = fc_malloc(sizeof(*req));
+  struct texai_req req;
 
-  req->type = type;
-  req->plr = pplayer;
-  req->data = data;
+  req.type = type;
+  req.plr = pplayer;
+  req.data = data;
 
-  texai_req_from_thr(req);
+  texai_req_from_thr(&req);
 }
 
 /**********************************************************************//**
@@ -13,6 +13,11 @@
 #ifndef FC__TEXAIMSG_H
 #define FC__TEXAIMSG_H
 
+#include <stdatomic.h>
+
+/* common */
+#include "fc_types.h"
+
 #define SPECENUM_NAME texaimsgtype
 #define SPECENUM_VALUE0 TEXAI_MSG_THR_EXIT
 #define SPECENUM_VALUE0NAME "Exit"
@@ -51,11 +56,56 @@
 #define SPECENUM_VALUE2NAME "BuildChoice"
 #include "specenum_gen.h"
 
+struct texai_tile_info_msg
+{
+  int index;
+  struct terrain *terrain;
+  bv_extras extras;
+};
+
+struct texai_city_info_msg
+{
+  int id;
+  int owner;
+  int tindex;
+};
+
+struct texai_id_msg
+{
+  int id;
+  int owner;
+};
+
+struct texai_unit_info_msg
+{
+  int id;
+  int owner;
+  int tindex;
+  int type;
+};
+
+struct texai_unit_move_msg
+{
+  int id;
+  int tindex;
+};
+
+/* Message payloads are carried in the message itself, so that sending
+ * one needs no allocation. */
+union texai_msg_data
+{
+  struct texai_tile_info_msg tile;
+  struct texai_city_info_msg city;
+  struct texai_id_msg id;
+  struct texai_unit_info_msg unit;
+  struct texai_unit_move_msg move;
+};
+
 struct texai_msg
 {
   enum texaimsgtype type;
   struct player *plr;
-  void *data;
+  union texai_msg_data data;
 };
 
 struct texai_req
@@ -65,16 +115,37 @@ struct texai_req
   void *data;
 };
 
-#define SPECLIST_TAG texaimsg
-#define SPECLIST_TYPE struct texai_msg
-#include "speclist.h"
+/* Single producer, single consumer queue of fixed size slots. Slots
+ * come in chunks of TEXAI_RING_SLOTS; a chunk the consumer has emptied
+ * is handed back to the producer for reuse, so in steady state pushing
+ * and popping neither allocate nor lock. */
+#define TEXAI_RING_SLOTS 1024
+
+struct texai_ring_chunk;
 
-#define SPECLIST_TAG texaireq
-#define SPECLIST_TYPE struct texai_req
-#include "speclist.h"
+struct texai_ring
+{
+  size_t slot_size;
+
+  /* Consumer side */
+  struct texai_ring_chunk *head;
+  int head_pos;
+
+  /* Producer side */
+  struct texai_ring_chunk *tail;
+  int tail_pos;
+
+  /* Emptied chunk waiting for the producer to reuse it */
+  _Atomic(struct texai_ring_chunk *) spare;
+};
+
+void texai_ring_init(struct texai_ring *ring, size_t slot_size);
+void texai_ring_free(struct texai_ring *ring);
+void texai_ring_push(struct texai_ring *ring, const void *slot);
+bool texai_ring_pop(struct texai_ring *ring, void *slot);
 
 void texai_send_msg(enum texaimsgtype type, struct player *pplayer,
-                    void *data);
+                    const union texai_msg_data *data);
 void texai_send_req(enum texaireqtype type, struct player *pplayer,
                     void *data);
 
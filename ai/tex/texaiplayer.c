@@ -50,16 +50,39 @@ enum texai_abort_msg_class
   TEXAI_ABORT_NONE
 };
 
-static enum texai_abort_msg_class texai_check_messages(struct ai_type *ait);
-
 struct texai_thr
 {
   int num_players;
-  struct texai_msgs msgs_to;
-  struct texai_reqs reqs_from;
+  struct ai_type *self;
+
+  /* Messages from the main thread, and requests back to it */
+  struct texai_ring msgs_to;
+  struct texai_ring reqs_from;
+
+  /* Wakeups are batched: the thread is signaled only for control
+   * messages, or once enough world updates have piled up. */
+  fc_thread_cond thr_cond;
+  fc_mutex mutex;
+  atomic_bool wakeup;
+  int unsignaled;
+
   bool thread_running;
   fc_thread ait;
-} exthrai;
+};
+
+/* World updates pushed before the thread gets woken up for them */
+#define TEXAI_WAKEUP_BATCH 256
+
+static struct texai_thr texai_thrs[TEXAI_MAX_THREADS];
+static int texai_running_thrs = 0;
+
+/* The tex thread the code is running in, NULL in the main thread */
+static _Thread_local struct texai_thr *texai_current_thr = NULL;
+
+/* When set, messages go to this thread only instead of being routed */
+static struct texai_thr *texai_sync_thr = NULL;
+
+static enum texai_abort_msg_class texai_check_messages(struct texai_thr *thr);
 
 struct texai_build_choice_req
 {
@@ -72,9 +95,13 @@ struct texai_build_choice_req
 **************************************************************************/
 void texai_init_threading(void)
 {
-  exthrai.thread_running = FALSE;
+  int i;
 
-  exthrai.num_players = 0;
+  for (i = 0; i < TEXAI_MAX_THREADS; i++) {
+    texai_thrs[i].thread_running = FALSE;
+    texai_thrs[i].num_players = 0;
+  }
+  texai_running_thrs = 0;
 }
 
 /**********************************************************************//**
@@ -83,25 +110,29 @@ void texai_init_threading(void)
 static void texai_thread_start(void *arg)
 {
   bool finished = FALSE;
-  struct ai_type *texai = arg;
+  struct texai_thr *thr = arg;
 
   log_debug("New AI thread launched");
 
+  texai_current_thr = thr;
+
   texai_world_init();
   if (!map_is_empty()) {
     texai_map_init();
   }
 
-  /* Just wait until we are signaled to shutdown */
-  fc_mutex_allocate(&exthrai.msgs_to.mutex);
   while (!finished) {
-    fc_thread_cond_wait(&exthrai.msgs_to.thr_cond, &exthrai.msgs_to.mutex);
+    /* Sleep until there is something worth waking up for */
+    fc_mutex_allocate(&thr->mutex);
+    while (!atomic_exchange(&thr->wakeup, FALSE)) {
+      fc_thread_cond_wait(&thr->thr_cond, &thr->mutex);
+    }
+    fc_mutex_release(&thr->mutex);
 
-    if (texai_check_messages(texai) <= TEXAI_ABORT_EXIT) {
+    if (texai_check_messages(thr) <= TEXAI_ABORT_EXIT) {
       finished = TRUE;
     }
   }
-  fc_mutex_release(&exthrai.msgs_to.mutex);
 
   texai_world_close();
 
@@ -155,27 +186,22 @@ static void texai_map_free_recv(void)
 **************************************************************************/
 struct unit_list *texai_player_units(struct player *pplayer)
 {
-  struct texai_plr *plr_data = player_ai_data(pplayer, texai_get_self());
-
-  return plr_data->units;
+  return texai_world_units(pplayer);
 }
 
 /**********************************************************************//**
   Handle messages from message queue.
 **************************************************************************/
-static enum texai_abort_msg_class texai_check_messages(struct ai_type *ait)
+static enum texai_abort_msg_class texai_check_messages(struct texai_thr *thr)
 {
   enum texai_abort_msg_class ret_abort = TEXAI_ABORT_NONE;
+  struct ai_type *ait = thr->self;
+  struct texai_msg msg_buf;
+  struct texai_msg *msg = &msg_buf;
 
-  texaimsg_list_allocate_mutex(exthrai.msgs_to.msglist);
-  while (texaimsg_list_size(exthrai.msgs_to.msglist) > 0) {
-    struct texai_msg *msg;
+  while (texai_ring_pop(&thr->msgs_to, msg)) {
     enum texai_abort_msg_class new_abort = TEXAI_ABORT_NONE;
 
-    msg = texaimsg_list_get(exthrai.msgs_to.msglist, 0);
-    texaimsg_list_remove(exthrai.msgs_to.msglist, msg);
-    texaimsg_list_release_mutex(exthrai.msgs_to.msglist);
-
     log_debug("Plr thr got %s", texaimsgtype_name(msg->type));
 
     switch (msg->type) {
@@ -210,7 +236,7 @@ static enum texai_abort_msg_class texai_check_messages(struct ai_type *ait)
         fc_mutex_release(&game.server.mutexes.city_list);
 
         /* Recursive message check in case phase is finished. */
-        new_abort = texai_check_messages(ait);
+        new_abort = texai_check_messages(thr);
         fc_mutex_allocate(&game.server.mutexes.city_list);
         if (new_abort < TEXAI_ABORT_NONE) {
           break;
@@ -222,24 +248,24 @@ static enum texai_abort_msg_class texai_check_messages(struct ai_type *ait)
 
       break;
     case TEXAI_MSG_TILE_INFO:
-      texai_tile_info_recv(msg->data);
+      texai_tile_info_recv(&msg->data.tile);
       break;
     case TEXAI_MSG_UNIT_MOVED:
-      texai_unit_moved_recv(msg->data);
+      texai_unit_moved_recv(&msg->data.move);
       break;
     case TEXAI_MSG_UNIT_CREATED:
     case TEXAI_MSG_UNIT_CHANGED:
-      texai_unit_info_recv(msg->data, msg->type);
+      texai_unit_info_recv(&msg->data.unit, msg->type);
       break;
     case TEXAI_MSG_UNIT_DESTROYED:
-      texai_unit_destruction_recv(msg->data);
+      texai_unit_destruction_recv(&msg->data.id);
       break;
     case TEXAI_MSG_CITY_CREATED:
     case TEXAI_MSG_CITY_CHANGED:
-      texai_city_info_recv(msg->data, msg->type);
+      texai_city_info_recv(&msg->data.city, msg->type);
       break;
     case TEXAI_MSG_CITY_DESTROYED:
-      texai_city_destruction_recv(msg->data);
+      texai_city_destruction_recv(&msg->data.id);
       break;
     case TEXAI_MSG_PHASE_FINISHED:
       new_abort = TEXAI_ABORT_PHASE_END;
@@ -262,12 +288,7 @@ static enum texai_abort_msg_class texai_check_messages(struct ai_type *ait)
     if (new_abort < ret_abort) {
       ret_abort = new_abort;
     }
-
-    FC_FREE(msg);
-
-    texaimsg_list_allocate_mutex(exthrai.msgs_to.msglist);
   }
-  texaimsg_list_release_mutex(exthrai.msgs_to.msglist);
 
   return ret_abort;
 }
@@ -284,8 +305,7 @@ void texai_player_alloc(struct ai_type *ait, struct player *pplayer)
   /* Default AI */
   dai_data_init(ait, pplayer);
 
-  player_data->units = unit_list_new();
-  player_data->cities = city_list_new();
+  player_data->thr = -1;
 }
 
 /**********************************************************************//**
@@ -300,32 +320,81 @@ void texai_player_free(struct ai_type *ait, struct player *pplayer)
 
   if (player_data != NULL) {
     player_set_ai_data(pplayer, ait, NULL);
-    unit_list_destroy(player_data->units);
-    city_list_destroy(player_data->cities);
     FC_FREE(player_data);
   }
 }
 
+/**********************************************************************//**
+  Push message to the thread, waking it up if needed.
+**************************************************************************/
+static void texai_thr_push(struct texai_thr *thr, const struct texai_msg *msg)
+{
+  texai_ring_push(&thr->msgs_to, msg);
+
+  switch (msg->type) {
+  case TEXAI_MSG_THR_EXIT:
+  case TEXAI_MSG_FIRST_ACTIVITIES:
+  case TEXAI_MSG_PHASE_FINISHED:
+    break;
+  default:
+    if (++thr->unsignaled < TEXAI_WAKEUP_BATCH) {
+      /* Let world updates pile up. Whatever is pending gets handled
+       * along with the next control message at the latest. */
+      return;
+    }
+    break;
+  }
+
+  thr->unsignaled = 0;
+  atomic_store(&thr->wakeup, TRUE);
+
+  fc_mutex_allocate(&thr->mutex);
+  fc_thread_cond_signal(&thr->thr_cond);
+  fc_mutex_release(&thr->mutex);
+}
+
 /**********************************************************************//**
   We actually control the player
 **************************************************************************/
 void texai_control_gained(struct ai_type *ait, struct player *pplayer)
 {
-  exthrai.num_players++;
+  struct texai_plr *plr_data = texai_player_data(ait, pplayer);
+  struct texai_thr *thr;
+  int i;
+
+  /* Give the player to the thread with the fewest players. Unused
+   * threads have none, so each player gets a thread of its own until
+   * they run out. */
+  plr_data->thr = 0;
+  for (i = 1; i < TEXAI_MAX_THREADS; i++) {
+    if (texai_thrs[i].num_players
+        < texai_thrs[plr_data->thr].num_players) {
+      plr_data->thr = i;
+    }
+  }
+  thr = &texai_thrs[plr_data->thr];
+
+  thr->num_players++;
 
-  log_debug("%s now under tex AI (%d)", pplayer->name,
-            exthrai.num_players);
+  log_debug("%s now under tex AI thread %d (%d)", pplayer->name,
+            plr_data->thr, thr->num_players);
 
-  if (!exthrai.thread_running) {
-    exthrai.msgs_to.msglist = texaimsg_list_new();
-    exthrai.reqs_from.reqlist = texaireq_list_new();
+  if (!thr->thread_running) {
+    thr->self = ait;
+    texai_ring_init(&thr->msgs_to, sizeof(struct texai_msg));
+    texai_ring_init(&thr->reqs_from, sizeof(struct texai_req));
+    atomic_init(&thr->wakeup, FALSE);
+    thr->unsignaled = 0;
 
-    exthrai.thread_running = TRUE;
+    thr->thread_running = TRUE;
+    texai_running_thrs++;
 
-    fc_thread_cond_init(&exthrai.msgs_to.thr_cond);
-    fc_mutex_init(&exthrai.msgs_to.mutex);
-    fc_thread_start(&exthrai.ait, texai_thread_start, ait);
+    fc_thread_cond_init(&thr->thr_cond);
+    fc_mutex_init(&thr->mutex);
+    fc_thread_start(&thr->ait, texai_thread_start, thr);
 
+    /* Only the new thread needs to learn about the current state */
+    texai_sync_thr = thr;
     players_iterate(oplayer) {
       city_list_iterate(oplayer->cities, pcity) {
         texai_city_created(pcity);
@@ -334,6 +403,7 @@ void texai_control_gained(struct ai_type *ait, struct player *pplayer)
         texai_unit_created(punit);
       } unit_list_iterate_end;
     } players_iterate_end;
+    texai_sync_thr = NULL;
   }
 }
 
@@ -342,97 +412,124 @@ void texai_control_gained(struct ai_type *ait, struct player *pplayer)
 **************************************************************************/
 void texai_control_lost(struct ai_type *ait, struct player *pplayer)
 {
-  exthrai.num_players--;
+  struct texai_plr *plr_data = texai_player_data(ait, pplayer);
+  struct texai_thr *thr;
 
-  log_debug("%s no longer under tex AI (%d)", pplayer->name,
-            exthrai.num_players);
+  fc_assert_ret(plr_data->thr >= 0);
 
-  if (exthrai.num_players <= 0) {
-    texai_send_msg(TEXAI_MSG_THR_EXIT, pplayer, NULL);
+  thr = &texai_thrs[plr_data->thr];
+  thr->num_players--;
 
-    fc_thread_wait(&exthrai.ait);
-    exthrai.thread_running = FALSE;
+  log_debug("%s no longer under tex AI thread %d (%d)", pplayer->name,
+            plr_data->thr, thr->num_players);
+
+  plr_data->thr = -1;
+
+  if (thr->num_players <= 0) {
+    struct texai_msg msg;
+    struct texai_req req;
+
+    msg.type = TEXAI_MSG_THR_EXIT;
+    msg.plr = pplayer;
+    texai_thr_push(thr, &msg);
+
+    fc_thread_wait(&thr->ait);
+    thr->thread_running = FALSE;
+    texai_running_thrs--;
+
+    /* Drop requests nobody is going to handle */
+    while (texai_ring_pop(&thr->reqs_from, &req)) {
+      free(req.data);
+    }
 
-    fc_thread_cond_destroy(&exthrai.msgs_to.thr_cond);
-    fc_mutex_destroy(&exthrai.msgs_to.mutex);
-    texaimsg_list_destroy(exthrai.msgs_to.msglist);
-    texaireq_list_destroy(exthrai.reqs_from.reqlist);
+    fc_thread_cond_destroy(&thr->thr_cond);
+    fc_mutex_destroy(&thr->mutex);
+    texai_ring_free(&thr->msgs_to);
+    texai_ring_free(&thr->reqs_from);
   }
 }
 
 /**********************************************************************//**
-  Check for messages sent by player thread
+  Check for messages sent by player threads
 **************************************************************************/
 void texai_refresh(struct ai_type *ait, struct player *pplayer)
 {
-  if (exthrai.thread_running) {
-    texaireq_list_allocate_mutex(exthrai.reqs_from.reqlist);
-    while (texaireq_list_size(exthrai.reqs_from.reqlist) > 0) {
-       struct texai_req *req;
-
-       req = texaireq_list_get(exthrai.reqs_from.reqlist, 0);
-       texaireq_list_remove(exthrai.reqs_from.reqlist, req);
-
-       texaireq_list_release_mutex(exthrai.reqs_from.reqlist);
-
-       log_debug("Plr thr sent %s", texaireqtype_name(req->type));
-
-       switch (req->type) {
-       case TEXAI_REQ_WORKER_TASK:
-         texai_req_worker_task_rcv(req);
-         break;
-       case TEXAI_BUILD_CHOICE:
-         {
-           struct texai_build_choice_req *choice_req
-             = (struct texai_build_choice_req *)(req->data);
-           struct city *pcity = game_city_by_number(choice_req->city_id);
-
-           if (pcity != NULL && city_owner(pcity) == req->plr) {
-             adv_choice_copy(&(def_ai_city_data(pcity, ait)->choice),
-                             &(choice_req->choice));
-             FC_FREE(choice_req);
-           }
-         }
-         break;
-       case TEXAI_REQ_TURN_DONE:
-         req->plr->ai_phase_done = TRUE;
-         break;
-       }
-
-       FC_FREE(req);
-
-       texaireq_list_allocate_mutex(exthrai.reqs_from.reqlist);
-     }
-    texaireq_list_release_mutex(exthrai.reqs_from.reqlist);
+  int i;
+
+  for (i = 0; i < TEXAI_MAX_THREADS; i++) {
+    struct texai_thr *thr = &texai_thrs[i];
+    struct texai_req req;
+
+    if (!thr->thread_running) {
+      continue;
+    }
+
+    while (texai_ring_pop(&thr->reqs_from, &req)) {
+      log_debug("Plr thr sent %s", texaireqtype_name(req.type));
+
+      switch (req.type) {
+      case TEXAI_REQ_WORKER_TASK:
+        texai_req_worker_task_rcv(&req);
+        break;
+      case TEXAI_BUILD_CHOICE:
+        {
+          struct texai_build_choice_req *choice_req
+            = (struct texai_build_choice_req *)(req.data);
+          struct city *pcity = game_city_by_number(choice_req->city_id);
+
+          if (pcity != NULL && city_owner(pcity) == req.plr) {
+            adv_choice_copy(&(def_ai_city_data(pcity, ait)->choice),
+                            &(choice_req->choice));
+            FC_FREE(choice_req);
+          }
+        }
+        break;
+      case TEXAI_REQ_TURN_DONE:
+        req.plr->ai_phase_done = TRUE;
+        break;
+      }
+    }
   }
 }
 
 /**********************************************************************//**
-  Send message to thread. Be sure that thread is running so that messages
-  are not just piling up to the list without anybody reading them.
+  Send message to threads. Messages about a player go to the thread
+  running that player, world updates to every thread.
+  Only the main thread may send messages.
 **************************************************************************/
-void texai_msg_to_thr(struct texai_msg *msg)
+void texai_msg_to_thr(const struct texai_msg *msg)
 {
-  fc_mutex_allocate(&exthrai.msgs_to.mutex);
-  texaimsg_list_append(exthrai.msgs_to.msglist, msg);
-  fc_thread_cond_signal(&exthrai.msgs_to.thr_cond);
-  fc_mutex_release(&exthrai.msgs_to.mutex);
+  int i;
+
+  if (texai_sync_thr != NULL) {
+    texai_thr_push(texai_sync_thr, msg);
+  } else if (msg->plr != NULL) {
+    int thr = texai_player_data(texai_get_self(), msg->plr)->thr;
+
+    if (thr >= 0) {
+      texai_thr_push(&texai_thrs[thr], msg);
+    }
+  } else {
+    for (i = 0; i < TEXAI_MAX_THREADS; i++) {
+      if (texai_thrs[i].thread_running) {
+        texai_thr_push(&texai_thrs[i], msg);
+      }
+    }
+  }
 }
 
 /**********************************************************************//**
   Thread sends message.
 **************************************************************************/
-void texai_req_from_thr(struct texai_req *req)
+void texai_req_from_thr(const struct texai_req *req)
 {
-  texaireq_list_allocate_mutex(exthrai.reqs_from.reqlist);
-  texaireq_list_append(exthrai.reqs_from.reqlist, req);
-  texaireq_list_release_mutex(exthrai.reqs_from.reqlist);
+  texai_ring_push(&texai_current_thr->reqs_from, req);
 }
 
 /**********************************************************************//**
-  Return whether player thread is running
+  Return whether any player thread is running
 **************************************************************************/
 bool texai_thread_running(void)
 {
-  return exthrai.thread_running;
+  return texai_running_thrs > 0;
 }
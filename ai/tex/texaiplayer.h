@@ -27,23 +27,14 @@
 
 struct player;
 
-struct texai_msgs
-{
-  fc_thread_cond thr_cond;
-  fc_mutex mutex;
-  struct texaimsg_list *msglist;
-};
-
-struct texai_reqs
-{
-  struct texaireq_list *reqlist;
-};
+/* Players are spread over up to this many threads, one each until
+ * there are more players than threads. */
+#define TEXAI_MAX_THREADS 4
 
 struct texai_plr
 {
   struct ai_plr defai; /* Keep this first so default AI finds it */
-  struct unit_list *units;
-  struct city_list *cities;
+  int thr;             /* Thread running the player, -1 if none */
 };
 
 struct ai_type *texai_get_self(void); /* Actually in texai.c */
@@ -61,9 +52,9 @@ void texai_control_gained(struct ai_type *ait, struct player *pplayer);
 void texai_control_lost(struct ai_type *ait, struct player *pplayer);
 void texai_refresh(struct ai_type *ait, struct player *pplayer);
 
-void texai_msg_to_thr(struct texai_msg *msg);
+void texai_msg_to_thr(const struct texai_msg *msg);
 
-void texai_req_from_thr(struct texai_req *req);
+void texai_req_from_thr(const struct texai_req *req);
 
 static inline struct texai_plr *texai_player_data(struct ai_type *ait,
                                                   const struct player *pplayer)
@@ -28,47 +28,26 @@
 
 #include "texaiworld.h"
 
-static struct world texai_world;
-
-struct texai_tile_info_msg
-{
-  int index;
-  struct terrain *terrain;
-  bv_extras extras;
-};
-
-struct texai_city_info_msg
+/* Mirror of the world, and of each player's units in it. Messages can
+ * arrive after their player is gone, so the owners are tracked by
+ * number only. */
+struct texai_world
 {
-  int id;
-  int owner;
-  int tindex;
+  struct world world;
+  struct unit_list *units[MAX_NUM_PLAYER_SLOTS];
 };
 
-struct texai_id_msg
-{
-  int id;
-};
-
-struct texai_unit_info_msg
-{
-  int id;
-  int owner;
-  int tindex;
-  int type;
-};
-
-struct texai_unit_move_msg
-{
-  int id;
-  int tindex;
-};
+/* Each tex thread keeps a mirror of its own, so that the threads never
+ * touch each other's copies. */
+static _Thread_local struct texai_world *texai_world = NULL;
 
 /**********************************************************************//**
   Initialize world object for texai
 **************************************************************************/
 void texai_world_init(void)
 {
-  idex_init(&texai_world);
+  texai_world = fc_calloc(1, sizeof(*texai_world));
+  idex_init(&texai_world->world);
 }
 
 /**********************************************************************//**
@@ -76,7 +55,17 @@ void texai_world_init(void)
 **************************************************************************/
 void texai_world_close(void)
 {
-  idex_free(&texai_world);
+  int i;
+
+  idex_free(&texai_world->world);
+
+  for (i = 0; i < MAX_NUM_PLAYER_SLOTS; i++) {
+    if (texai_world->units[i] != NULL) {
+      unit_list_destroy(texai_world->units[i]);
+    }
+  }
+
+  FC_FREE(texai_world);
 }
 
 /**********************************************************************//**
@@ -84,9 +73,9 @@ void texai_world_close(void)
 **************************************************************************/
 void texai_map_init(void)
 {
-  map_init(&(texai_world.map), TRUE);
-  map_init_topology(&(texai_world.map));
-  map_allocate(&(texai_world.map));
+  map_init(&(texai_world->world.map), TRUE);
+  map_init_topology(&(texai_world->world.map));
+  map_allocate(&(texai_world->world.map));
 }
 
 /**********************************************************************//**
@@ -94,7 +83,7 @@ void texai_map_init(void)
 **************************************************************************/
 struct civ_map *texai_map_get(void)
 {
-  return &(texai_world.map);
+  return &(texai_world->world.map);
 }
 
 /**********************************************************************//**
@@ -102,7 +91,27 @@ struct civ_map *texai_map_get(void)
 **************************************************************************/
 void texai_map_close(void)
 {
-  map_free(&(texai_world.map), TRUE);
+  map_free(&(texai_world->world.map), TRUE);
+}
+
+/**********************************************************************//**
+  Return units of the player number plrno on the tex map
+**************************************************************************/
+static struct unit_list *texai_world_units_by_number(int plrno)
+{
+  if (texai_world->units[plrno] == NULL) {
+    texai_world->units[plrno] = unit_list_new();
+  }
+
+  return texai_world->units[plrno];
+}
+
+/**********************************************************************//**
+  Return player's units on the tex map
+**************************************************************************/
+struct unit_list *texai_world_units(const struct player *pplayer)
+{
+  return texai_world_units_by_number(player_number(pplayer));
 }
 
 /**********************************************************************//**
@@ -111,32 +120,28 @@ void texai_map_close(void)
 void texai_tile_info(struct tile *ptile)
 {
   if (texai_thread_running()) {
-    struct texai_tile_info_msg *info = fc_malloc(sizeof(struct texai_tile_info_msg));
+    union texai_msg_data data;
 
-    info->index = tile_index(ptile);
-    info->terrain = ptile->terrain;
-    info->extras = ptile->extras;
+    data.tile.index = tile_index(ptile);
+    data.tile.terrain = ptile->terrain;
+    data.tile.extras = ptile->extras;
 
-    texai_send_msg(TEXAI_MSG_TILE_INFO, NULL, info);
+    texai_send_msg(TEXAI_MSG_TILE_INFO, NULL, &data);
   }
 }
 
 /**********************************************************************//**
   Receive tile update to the thread.
 **************************************************************************/
-void texai_tile_info_recv(void *data)
+void texai_tile_info_recv(const struct texai_tile_info_msg *info)
 {
-  struct texai_tile_info_msg *info = (struct texai_tile_info_msg *)data;
-
-  if (texai_world.map.tiles != NULL) {
+  if (texai_world->world.map.tiles != NULL) {
     struct tile *ptile;
 
-    ptile = index_to_tile(&(texai_world.map), info->index);
+    ptile = index_to_tile(&(texai_world->world.map), info->index);
     ptile->terrain = info->terrain;
     ptile->extras = info->extras;
   }
-
-  free(info);
 }
 
 /**********************************************************************//**
@@ -145,14 +150,13 @@ void texai_tile_info_recv(void *data)
 static void texai_city_update(struct city *pcity, enum texaimsgtype msgtype)
 {
   if (texai_thread_running()) {
-    struct texai_city_info_msg *info
-      = fc_malloc(sizeof(struct texai_city_info_msg));
+    union texai_msg_data data;
 
-    info->id = pcity->id;
-    info->owner = player_number(city_owner(pcity));
-    info->tindex = tile_index(city_tile(pcity));
+    data.city.id = pcity->id;
+    data.city.owner = player_number(city_owner(pcity));
+    data.city.tindex = tile_index(city_tile(pcity));
 
-    texai_send_msg(msgtype, NULL, info);
+    texai_send_msg(msgtype, NULL, &data);
   }
 }
 
@@ -175,32 +179,34 @@ void texai_city_changed(struct city *pcity)
 /**********************************************************************//**
   Receive city update to the thread.
 **************************************************************************/
-void texai_city_info_recv(void *data, enum texaimsgtype msgtype)
+void texai_city_info_recv(const struct texai_city_info_msg *info,
+                          enum texaimsgtype msgtype)
 {
-  struct texai_city_info_msg *info = (struct texai_city_info_msg *)data;
   struct city *pcity;
   struct player *pplayer = player_by_number(info->owner);
 
+  if (pplayer == NULL) {
+    /* Owner already removed from the game */
+    return;
+  }
+
   if (msgtype == TEXAI_MSG_CITY_CREATED) {
     struct tile *ptile;
-    struct texai_plr *plr_data;
 
-    if (idex_lookup_city(&texai_world, info->id) != NULL) {
+    if (idex_lookup_city(&texai_world->world, info->id) != NULL) {
       return;
     }
 
-    ptile = index_to_tile(&(texai_world.map), info->tindex);
+    ptile = index_to_tile(&(texai_world->world.map), info->tindex);
 
     pcity = create_city_virtual(pplayer, ptile, "");
     adv_city_alloc(pcity);
     pcity->id = info->id;
 
-    idex_register_city(&texai_world, pcity);
-    plr_data = player_ai_data(pplayer, texai_get_self());
-    city_list_prepend(plr_data->cities, pcity);
+    idex_register_city(&texai_world->world, pcity);
     tile_set_worked(ptile, pcity);
   } else {
-    pcity = idex_lookup_city(&texai_world, info->id);
+    pcity = idex_lookup_city(&texai_world->world, info->id);
 
     if (pcity != NULL) {
       pcity->owner = pplayer;
@@ -209,8 +215,6 @@ void texai_city_info_recv(void *data, enum texaimsgtype msgtype)
                 info->id);
     }
   }
-
-  free(info);
 }
 
 /**********************************************************************//**
@@ -218,7 +222,7 @@ void texai_city_info_recv(void *data, enum texaimsgtype msgtype)
 **************************************************************************/
 struct city *texai_map_city(int city_id)
 {
-  return idex_lookup_city(&texai_world, city_id);
+  return idex_lookup_city(&texai_world->world, city_id);
 }
 
 /**********************************************************************//**
@@ -227,37 +231,31 @@ struct city *texai_map_city(int city_id)
 void texai_city_destroyed(struct city *pcity)
 {
   if (texai_thread_running()) {
-    struct texai_id_msg *info = fc_malloc(sizeof(struct texai_id_msg));
+    union texai_msg_data data;
 
-    info->id = pcity->id;
+    data.id.id = pcity->id;
+    data.id.owner = player_number(city_owner(pcity));
 
-    texai_send_msg(TEXAI_MSG_CITY_DESTROYED, NULL, info);
+    texai_send_msg(TEXAI_MSG_CITY_DESTROYED, NULL, &data);
   }
 }
 
 /**********************************************************************//**
   Receive city destruction to the thread.
 **************************************************************************/
-void texai_city_destruction_recv(void *data)
+void texai_city_destruction_recv(const struct texai_id_msg *info)
 {
-  struct texai_id_msg *info = (struct texai_id_msg *)data;
-  struct city *pcity = idex_lookup_city(&texai_world, info->id);
+  struct city *pcity = idex_lookup_city(&texai_world->world, info->id);
 
   if (pcity != NULL) {
-    struct texai_plr *plr_data;
-
     adv_city_free(pcity);
     tile_set_worked(city_tile(pcity), NULL);
-    plr_data = player_ai_data(city_owner(pcity), texai_get_self());
-    city_list_remove(plr_data->cities, pcity);
-    idex_unregister_city(&texai_world, pcity);
+    idex_unregister_city(&texai_world->world, pcity);
     destroy_city_virtual(pcity);
   } else {
     log_error("Tex: requested removal of city id %d that's not known.",
               info->id);
   }
-
-  free(info);
 }
 
 /**********************************************************************//**
@@ -266,15 +264,14 @@ void texai_city_destruction_recv(void *data)
 static void texai_unit_update(struct unit *punit, enum texaimsgtype msgtype)
 {
   if (texai_thread_running()) {
-    struct texai_unit_info_msg *info
-      = fc_malloc(sizeof(struct texai_unit_info_msg));
+    union texai_msg_data data;
 
-    info->id = punit->id;
-    info->owner = player_number(unit_owner(punit));
-    info->tindex = tile_index(unit_tile(punit));
-    info->type = utype_number(unit_type_get(punit));
+    data.unit.id = punit->id;
+    data.unit.owner = player_number(unit_owner(punit));
+    data.unit.tindex = tile_index(unit_tile(punit));
+    data.unit.type = utype_number(unit_type_get(punit));
 
-    texai_send_msg(msgtype, NULL, info);
+    texai_send_msg(msgtype, NULL, &data);
   }
 }
 
@@ -297,40 +294,39 @@ void texai_unit_changed(struct unit *punit)
 /**********************************************************************//**
   Receive unit update to the thread.
 **************************************************************************/
-void texai_unit_info_recv(void *data, enum texaimsgtype msgtype)
+void texai_unit_info_recv(const struct texai_unit_info_msg *info,
+                          enum texaimsgtype msgtype)
 {
-  struct texai_unit_info_msg *info = (struct texai_unit_info_msg *)data;
   struct unit *punit;
   struct player *pplayer = player_by_number(info->owner);
   struct unit_type *type = utype_by_number(info->type);
-  struct tile *ptile = index_to_tile(&(texai_world.map), info->tindex);
+  struct tile *ptile = index_to_tile(&(texai_world->world.map), info->tindex);
 
-  if (msgtype == TEXAI_MSG_UNIT_CREATED) {
-    struct texai_plr *plr_data;
+  if (pplayer == NULL) {
+    /* Owner already removed from the game */
+    return;
+  }
 
-    if (idex_lookup_unit(&texai_world, info->id) != NULL) {
+  if (msgtype == TEXAI_MSG_UNIT_CREATED) {
+    if (idex_lookup_unit(&texai_world->world, info->id) != NULL) {
       return;
     }
 
-    plr_data = player_ai_data(pplayer, texai_get_self());
-
     punit = unit_virtual_create(pplayer, NULL, type, 0);
     punit->id = info->id;
 
-    idex_register_unit(&texai_world, punit);
+    idex_register_unit(&texai_world->world, punit);
     unit_list_prepend(ptile->units, punit);
-    unit_list_prepend(plr_data->units, punit);
+    unit_list_prepend(texai_world_units(pplayer), punit);
 
     unit_tile_set(punit, ptile);
   } else {
     fc_assert(msgtype == TEXAI_MSG_UNIT_CHANGED);
 
-    punit = idex_lookup_unit(&texai_world, info->id);
+    punit = idex_lookup_unit(&texai_world->world, info->id);
 
     punit->utype = type;
   }
-
-  free(info);
 }
 
 /**********************************************************************//**
@@ -339,36 +335,31 @@ void texai_unit_info_recv(void *data, enum texaimsgtype msgtype)
 void texai_unit_destroyed(struct unit *punit)
 {
   if (texai_thread_running()) {
-    struct texai_id_msg *info = fc_malloc(sizeof(struct texai_id_msg));
+    union texai_msg_data data;
 
-    info->id = punit->id;
+    data.id.id = punit->id;
+    data.id.owner = player_number(unit_owner(punit));
 
-    texai_send_msg(TEXAI_MSG_UNIT_DESTROYED, NULL, info);
+    texai_send_msg(TEXAI_MSG_UNIT_DESTROYED, NULL, &data);
   }
 }
 
 /**********************************************************************//**
   Receive unit destruction to the thread.
 **************************************************************************/
-void texai_unit_destruction_recv(void *data)
+void texai_unit_destruction_recv(const struct texai_id_msg *info)
 {
-  struct texai_id_msg *info = (struct texai_id_msg *)data;
-  struct unit *punit = idex_lookup_unit(&texai_world, info->id);
+  struct unit *punit = idex_lookup_unit(&texai_world->world, info->id);
 
   if (punit != NULL) {
-    struct texai_plr *plr_data = player_ai_data(punit->owner,
-                                                texai_get_self());
-
     unit_list_remove(punit->tile->units, punit);
-    unit_list_remove(plr_data->units, punit);
-    idex_unregister_unit(&texai_world, punit);
+    unit_list_remove(texai_world_units_by_number(info->owner), punit);
+    idex_unregister_unit(&texai_world->world, punit);
     unit_virtual_destroy(punit);
   } else {
     log_error("Tex: requested removal of unit id %d that's not known.",
               info->id);
   }
-
-  free(info);
 }
 
 /**********************************************************************//**
@@ -377,23 +368,22 @@ void texai_unit_destruction_recv(void *data)
 void texai_unit_move_seen(struct unit *punit)
 {
   if (texai_thread_running()) {
-    struct texai_unit_move_msg *info = fc_malloc(sizeof(struct texai_unit_move_msg));
+    union texai_msg_data data;
 
-    info->id = punit->id;
-    info->tindex = tile_index(unit_tile(punit));
+    data.move.id = punit->id;
+    data.move.tindex = tile_index(unit_tile(punit));
 
-    texai_send_msg(TEXAI_MSG_UNIT_MOVED, NULL, info);
+    texai_send_msg(TEXAI_MSG_UNIT_MOVED, NULL, &data);
   }
 }
 
 /**********************************************************************//**
   Receive unit move to the thread.
 **************************************************************************/
-void texai_unit_moved_recv(void *data)
+void texai_unit_moved_recv(const struct texai_unit_move_msg *info)
 {
-  struct texai_unit_move_msg *info = (struct texai_unit_move_msg *)data;
-  struct unit *punit = idex_lookup_unit(&texai_world, info->id);
-  struct tile *ptile = index_to_tile(&(texai_world.map), info->tindex);
+  struct unit *punit = idex_lookup_unit(&texai_world->world, info->id);
+  struct tile *ptile = index_to_tile(&(texai_world->world.map), info->tindex);
 
   if (punit != NULL) {
     unit_list_remove(punit->tile->units, punit);
@@ -404,6 +394,4 @@ void texai_unit_moved_recv(void *data)
     log_error("Tex: requested moving of unit id %d that's not known.",
               info->id);
   }
-
-  free(info);
 }
@@ -254,7 +254,19 @@ static void call_handle_methods(void)
 
     pcall = remove_and_return_a_call();
     if (!pcall) {
-      break;
+      int i;
+
+      /* Let the agents handle what they collected from the calls. They
+       * may cause new calls while doing so. */
+      for (i = 0; i < agents.entries_used; i++) {
+        if (agents.entries[i].agent.calls_done_notify != NULL) {
+          agents.entries[i].agent.calls_done_notify();
+        }
+      }
+      if (call_list_size(agents.calls) == 0) {
+        break;
+      }
+      continue;
     }
 
     execute_call(pcall);
@@ -357,6 +369,7 @@ void agents_free(void)
   /* cmafec_free(); */
 
   /* simple_historian_done(); */
+  cma_done();
 
   for (;;) {
     struct call *pcall = remove_and_return_a_call();
@@ -42,6 +42,8 @@ struct agent {
   int level;
 
   void (*turn_start_notify) (void);
+  /* Called once all outstanding calls have been executed. */
+  void (*calls_done_notify) (void);
   void (*city_callbacks[CB_LAST]) (int);
   void (*unit_callbacks[CB_LAST]) (int);
   void (*tile_callbacks[CB_LAST]) (struct tile *ptile);
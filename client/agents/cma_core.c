@@ -21,6 +21,7 @@
 #endif
 
 /* utility */
+#include "bitvector.h"
 #include "bugs.h"
 #include "fcintl.h"
 #include "log.h"
@@ -61,9 +62,11 @@
 /*
  * The CMA is an agent. The CMA will subscribe itself to all city
  * events. So if a city changes the callback function city_changed() is
- * called. handle_city() will be called from city_changed() to update the
- * given city. handle_city() will call cma_query_result() and
- * apply_result_on_server() to update the server city state.
+ * called, which marks the city dirty. Once the agents have handled all
+ * outstanding calls, handle_dirty_cities() queries the results of all
+ * dirty cities and sends the requests for all of them at once, so the
+ * whole batch costs a single round trip to the server. Cities whose
+ * result didn't apply cleanly are tried again in another round.
  */
 
 /****************************************************************************
@@ -73,6 +76,7 @@
 #define log_apply_result                log_debug
 #define log_handle_city                 log_debug
 #define log_handle_city2                log_debug
+#define log_batch                       log_debug
 #define log_results_are_equal           log_debug
 
 #define SHOW_TIME_STATS                                 FALSE
@@ -85,14 +89,38 @@
 #define CMA_ATTR_VERSION                                3
 #define CMA_ATTR_VERSION_MIN_SUPPORTED                  2
 
+/* How many times a city is tried before the CMA gives up on it. */
+#define CMA_MAX_TRIES                                   5
+
 /*
  * Misc statistic to analyze performance.
  */
 static struct {
   struct timer *wall_timer;
   int apply_result_ignored, apply_result_applied, refresh_forced;
+  /* Since the start of the turn. */
+  int cities_handled, batches, round_trips;
 } stats;
 
+/* 'struct dirty_index_hash' and related functions. */
+#define SPECHASH_TAG dirty_index
+#define SPECHASH_INT_KEY_TYPE
+#define SPECHASH_INT_DATA_TYPE
+#include "spechash.h"
+
+/*
+ * Cities changed since the last batch.
+ */
+static struct {
+  struct dirty_city {
+    int city_id;
+    int tries;
+  } *cities;
+  int count, size;
+  /* City id -> position in the cities array. */
+  struct dirty_index_hash *index;
+} dirty;
+
 /************************************************************************//**
   Returns TRUE iff the two results are equal. Both results have to be
   results for the given city.
@@ -163,23 +191,30 @@ static struct city *check_city(int city_id, struct cm_parameter *parameter)
 }
 
 /************************************************************************//**
-  Change the actual city setting to the given result. Returns TRUE iff
-  the actual data matches the calculated one.
+  Send the requests to change the actual city setting to the given
+  result, without waiting for the server to handle them. The range of
+  the request ids sent is stored in first_request_id and
+  last_request_id, both are 0 if the city already matches the result.
+  Returns FALSE if the result can't be applied.
 ****************************************************************************/
-static bool apply_result_on_server(struct city *pcity,
-                                   const struct cm_result *result)
+static bool send_result_requests(struct city *pcity,
+                                 const struct cm_result *result,
+                                 int *first_request_id,
+                                 int *last_request_id)
 {
-  int first_request_id = 0, last_request_id = 0;
   int city_radius_sq = city_map_radius_sq_get(pcity);
   struct cm_result *current_state = cm_result_new(pcity);
-  bool success;
   struct tile *pcenter = city_tile(pcity);
+  bool equal;
+
+  *first_request_id = *last_request_id = 0;
 
   fc_assert_ret_val(result->found_a_valid, FALSE);
   cm_result_from_main_map(current_state, pcity);
+  equal = fc_results_are_equal(current_state, result);
+  cm_result_destroy(current_state);
 
-  if (fc_results_are_equal(current_state, result)
-      && !ALWAYS_APPLY_AT_SERVER) {
+  if (equal && !ALWAYS_APPLY_AT_SERVER) {
     stats.apply_result_ignored++;
 
     return TRUE;
@@ -209,11 +244,11 @@ static bool apply_result_on_server(struct city *pcity,
         && !result->worker_positions[idx]) {
       log_apply_result("Removing worker at {%d,%d}.", x, y);
 
-      last_request_id =
+      *last_request_id =
         dsend_packet_city_make_specialist(&client.conn,
                                           pcity->id, ptile->index);
-      if (first_request_id == 0) {
-        first_request_id = last_request_id;
+      if (*first_request_id == 0) {
+        *first_request_id = *last_request_id;
       }
     }
   } city_tile_iterate_skip_free_worked_end;
@@ -229,10 +264,10 @@ static bool apply_result_on_server(struct city *pcity,
     for (i = 0; i < pcity->specialists[sp] - result->specialists[sp]; i++) {
       log_apply_result("Change specialist from %d to %d.",
                        sp, DEFAULT_SPECIALIST);
-      last_request_id = city_change_specialist(pcity,
-                                               sp, DEFAULT_SPECIALIST);
-      if (first_request_id == 0) {
-        first_request_id = last_request_id;
+      *last_request_id = city_change_specialist(pcity,
+                                                sp, DEFAULT_SPECIALIST);
+      if (*first_request_id == 0) {
+        *first_request_id = *last_request_id;
       }
     }
   } normal_specialist_type_iterate_end;
@@ -249,11 +284,11 @@ static bool apply_result_on_server(struct city *pcity,
       log_apply_result("Putting worker at {%d,%d}.", x, y);
       fc_assert_action(city_can_work_tile(pcity, ptile), break);
 
-      last_request_id =
+      *last_request_id =
         dsend_packet_city_make_worker(&client.conn,
                                       pcity->id, ptile->index);
-      if (first_request_id == 0) {
-        first_request_id = last_request_id;
+      if (*first_request_id == 0) {
+        *first_request_id = *last_request_id;
       }
     }
   } city_tile_iterate_skip_free_worked_end;
@@ -270,15 +305,15 @@ static bool apply_result_on_server(struct city *pcity,
     for (i = 0; i < result->specialists[sp] - pcity->specialists[sp]; i++) {
       log_apply_result("Changing specialist from %d to %d.",
                        DEFAULT_SPECIALIST, sp);
-      last_request_id = city_change_specialist(pcity,
-                                               DEFAULT_SPECIALIST, sp);
-      if (first_request_id == 0) {
-        first_request_id = last_request_id;
+      *last_request_id = city_change_specialist(pcity,
+                                                DEFAULT_SPECIALIST, sp);
+      if (*first_request_id == 0) {
+        *first_request_id = *last_request_id;
       }
     }
   } normal_specialist_type_iterate_end;
 
-  if (last_request_id == 0 || ALWAYS_APPLY_AT_SERVER) {
+  if (*last_request_id == 0 || ALWAYS_APPLY_AT_SERVER) {
       /*
        * If last_request is 0 no change request was send. But it also
        * means that the results are different or the fc_results_are_equal()
@@ -287,24 +322,27 @@ static bool apply_result_on_server(struct city *pcity,
        * allocation of citizen than the server. We just send a
        * PACKET_CITY_REFRESH to bring them in sync.
        */
-    first_request_id = last_request_id =
+    *first_request_id = *last_request_id =
       dsend_packet_city_refresh(&client.conn, pcity->id);
     stats.refresh_forced++;
   }
 
   connection_do_unbuffer(&client.conn);
 
-  if (last_request_id != 0) {
-    int city_id = pcity->id;
+  return TRUE;
+}
 
-    wait_for_requests("CMA", first_request_id, last_request_id);
-    if (pcity != check_city(city_id, NULL)) {
-      log_verbose("apply_result_on_server(city %d) !check_city()!", city_id);
-      return FALSE;
-    }
-  }
+/************************************************************************//**
+  Returns TRUE iff the actual city setting matches the given result,
+  once the server has handled the requests sent by
+  send_result_requests().
+****************************************************************************/
+static bool result_is_applied(struct city *pcity,
+                              const struct cm_result *result)
+{
+  struct cm_result *current_state = cm_result_new(pcity);
+  bool success;
 
-  /* Return. */
   cm_result_from_main_map(current_state, pcity);
 
   success = fc_results_are_equal(current_state, result);
@@ -333,6 +371,34 @@ static bool apply_result_on_server(struct city *pcity,
   return success;
 }
 
+/************************************************************************//**
+  Change the actual city setting to the given result. Returns TRUE iff
+  the actual data matches the calculated one.
+****************************************************************************/
+static bool apply_result_on_server(struct city *pcity,
+                                   const struct cm_result *result)
+{
+  int first_request_id, last_request_id;
+  int city_id = pcity->id;
+
+  if (!send_result_requests(pcity, result,
+                            &first_request_id, &last_request_id)) {
+    return FALSE;
+  }
+  if (last_request_id == 0) {
+    return TRUE;
+  }
+
+  wait_for_requests("CMA", first_request_id, last_request_id);
+  stats.round_trips++;
+  if (pcity != check_city(city_id, NULL)) {
+    log_verbose("apply_result_on_server(city %d) !check_city()!", city_id);
+    return FALSE;
+  }
+
+  return result_is_applied(pcity, result);
+}
+
 /************************************************************************//**
   Prints the data of the stats struct via log_test(...).
 ****************************************************************************/
@@ -365,81 +431,206 @@ static void release_city(int city_id)
 ****************************************************************************/
 
 /************************************************************************//**
-  The given city has changed. handle_city() ensures that either the city
-  follows the set CMA goal or that the CMA detaches itself from the
-  city.
+  Mark the city to be handled by the next round of handle_dirty_cities().
 ****************************************************************************/
-static void handle_city(struct city *pcity)
+static void dirty_city_add(int city_id, int tries)
 {
-  struct cm_result *result = cm_result_new(pcity);
-  bool handled;
-  int i, city_id = pcity->id;
+  int i;
 
-  log_handle_city("handle_city(city %d=\"%s\") pos=(%d,%d) owner=%s",
-                  pcity->id, city_name_get(pcity), TILE_XY(pcity->tile),
-                  nation_rule_name(nation_of_city(pcity)));
+  if (dirty_index_hash_lookup(dirty.index, city_id, &i)) {
+    dirty.cities[i].tries = MAX(dirty.cities[i].tries, tries);
+    return;
+  }
 
-  log_handle_city2("START handle city %d=\"%s\"",
-                   pcity->id, city_name_get(pcity));
+  if (dirty.count == dirty.size) {
+    dirty.size = MAX(16, 2 * dirty.size);
+    dirty.cities = fc_realloc(dirty.cities,
+                              dirty.size * sizeof(*dirty.cities));
+  }
+  dirty.cities[dirty.count].city_id = city_id;
+  dirty.cities[dirty.count].tries = tries;
+  dirty_index_hash_insert(dirty.index, city_id, dirty.count);
+  dirty.count++;
+}
 
-  handled = FALSE;
-  for (i = 0; i < 5; i++) {
-    struct cm_parameter parameter;
+/************************************************************************//**
+  Claim the tiles the result puts new workers on. Returns FALSE, without
+  claiming anything, if another city already claimed one of them.
+****************************************************************************/
+static bool claim_result_tiles(struct city *pcity,
+                               const struct cm_result *result,
+                               struct dbv *claimed)
+{
+  int city_radius_sq = city_map_radius_sq_get(pcity);
+  struct tile *pcenter = city_tile(pcity);
 
-    log_handle_city2("  try %d", i);
+  city_tile_iterate_skip_free_worked(&(wld.map), city_radius_sq, pcenter,
+                                     ptile, idx, x, y) {
+    if (NULL == tile_worked(ptile)
+        && result->worker_positions[idx]
+        && dbv_isset(claimed, tile_index(ptile))) {
+      return FALSE;
+    }
+  } city_tile_iterate_skip_free_worked_end;
 
-    if (pcity != check_city(city_id, &parameter)) {
-      handled = TRUE;
-      break;
+  city_tile_iterate_skip_free_worked(&(wld.map), city_radius_sq, pcenter,
+                                     ptile, idx, x, y) {
+    if (NULL == tile_worked(ptile)
+        && result->worker_positions[idx]) {
+      dbv_set(claimed, tile_index(ptile));
     }
+  } city_tile_iterate_skip_free_worked_end;
+
+  return TRUE;
+}
+
+/************************************************************************//**
+  The result for the city didn't apply cleanly. Either mark the city to
+  be tried again, or give up on it.
+****************************************************************************/
+static void handle_city_failed(struct city *pcity, int tries)
+{
+  log_handle_city2("  doesn't cleanly apply");
+
+  if (tries == 1) {
+    create_event(city_tile(pcity), E_CITY_CMA_RELEASE, ftc_client,
+                 _("The citizen governor has gotten confused dealing "
+                   "with %s. You may want to have a look."),
+                 city_link(pcity));
+  }
+
+  if (tries < CMA_MAX_TRIES) {
+    dirty_city_add(pcity->id, tries);
+    return;
+  }
+
+  log_handle_city2("  not handled");
+
+  create_event(city_tile(pcity), E_CITY_CMA_RELEASE, ftc_client,
+               _("The citizen governor has gotten confused dealing "
+                 "with %s. You may want to have a look."),
+               city_link(pcity));
+
+  cma_release_city(pcity);
+
+  bugreport_request("handle_city() CMA: %s has changed multiple times.",
+                    city_name_get(pcity));
+}
+
+/************************************************************************//**
+  Handle all dirty cities. For each of them, either the city follows the
+  set CMA goal or the CMA detaches itself from the city.
+
+  The results of all dirty cities are sent to the server together, and
+  then waited for with a single round trip. A city which would put
+  workers on the same free tiles as another city of the round is held
+  back for the next round, once the outcome of the other one is known.
+****************************************************************************/
+static void handle_dirty_cities(void)
+{
+  struct dbv claimed;
+  int handled = stats.cities_handled;
+
+  if (dirty.count == 0) {
+    return;
+  }
 
-    cm_query_result(pcity, &parameter, result, FALSE);
-    if (!result->found_a_valid) {
-      log_handle_city2("  no valid found result");
-
-      cma_release_city(pcity);
-
-      create_event(city_tile(pcity), E_CITY_CMA_RELEASE, ftc_client,
-                   _("The citizen governor can't fulfill the requirements "
-                     "for %s. Passing back control."), city_link(pcity));
-      handled = TRUE;
-      break;
-    } else {
-      if (!apply_result_on_server(pcity, result)) {
-        log_handle_city2("  doesn't cleanly apply");
-        if (pcity == check_city(city_id, NULL) && i == 0) {
-          create_event(city_tile(pcity), E_CITY_CMA_RELEASE, ftc_client,
-                       _("The citizen governor has gotten confused dealing "
-                         "with %s. You may want to have a look."),
-                       city_link(pcity));
+  dbv_init(&claimed, MAP_INDEX_SIZE);
+
+  while (dirty.count > 0) {
+    int num = dirty.count, i;
+    struct dirty_city *batch = fc_malloc(num * sizeof(*batch));
+    struct cm_result **results = fc_calloc(num, sizeof(*results));
+    int first_request_id = 0, last_request_id = 0;
+
+    memcpy(batch, dirty.cities, num * sizeof(*batch));
+    dirty.count = 0;
+    dirty_index_hash_clear(dirty.index);
+    dbv_clr_all(&claimed);
+
+    log_batch("CMA: handling %d dirty cities", num);
+
+    connection_do_buffer(&client.conn);
+    for (i = 0; i < num; i++) {
+      struct cm_parameter parameter;
+      struct city *pcity = check_city(batch[i].city_id, &parameter);
+      int first, last;
+
+      if (pcity == NULL) {
+        continue;
+      }
+
+      log_handle_city("handle_city(city %d=\"%s\") pos=(%d,%d) owner=%s",
+                      pcity->id, city_name_get(pcity), TILE_XY(pcity->tile),
+                      nation_rule_name(nation_of_city(pcity)));
+      log_handle_city2("  try %d", batch[i].tries);
+
+      results[i] = cm_result_new(pcity);
+      cm_query_result(pcity, &parameter, results[i], FALSE);
+      stats.cities_handled++;
+
+      if (!results[i]->found_a_valid) {
+        log_handle_city2("  no valid found result");
+
+        cma_release_city(pcity);
+
+        create_event(city_tile(pcity), E_CITY_CMA_RELEASE, ftc_client,
+                     _("The citizen governor can't fulfill the requirements "
+                       "for %s. Passing back control."), city_link(pcity));
+      } else if (!claim_result_tiles(pcity, results[i], &claimed)) {
+        log_handle_city2("  held back for the next round");
+        dirty_city_add(pcity->id, batch[i].tries);
+      } else if (!send_result_requests(pcity, results[i], &first, &last)) {
+        handle_city_failed(pcity, ++batch[i].tries);
+      } else if (last != 0) {
+        if (first_request_id == 0) {
+          first_request_id = first;
         }
+        last_request_id = last;
+        /* Check the outcome below. */
+        continue;
       } else {
         log_handle_city2("  ok");
-        /* Everything ok */
-        handled = TRUE;
-        break;
       }
+
+      cm_result_destroy(results[i]);
+      results[i] = NULL;
     }
-  }
+    connection_do_unbuffer(&client.conn);
 
-  cm_result_destroy(result);
+    if (last_request_id != 0) {
+      wait_for_requests("CMA", first_request_id, last_request_id);
+      stats.round_trips++;
+    }
 
-  if (!handled) {
-    fc_assert_ret(pcity == check_city(city_id, NULL));
-    log_handle_city2("  not handled");
+    for (i = 0; i < num; i++) {
+      struct city *pcity;
 
-    create_event(city_tile(pcity), E_CITY_CMA_RELEASE, ftc_client,
-                 _("The citizen governor has gotten confused dealing "
-                   "with %s. You may want to have a look."),
-                 city_link(pcity));
+      if (results[i] == NULL) {
+        continue;
+      }
 
-    cma_release_city(pcity);
+      pcity = check_city(batch[i].city_id, NULL);
+      if (pcity == NULL) {
+        log_verbose("handle_dirty_cities(city %d) !check_city()!",
+                    batch[i].city_id);
+      } else if (!result_is_applied(pcity, results[i])) {
+        handle_city_failed(pcity, ++batch[i].tries);
+      } else {
+        log_handle_city2("  ok");
+      }
+      cm_result_destroy(results[i]);
+    }
 
-    bugreport_request("handle_city() CMA: %s has changed multiple times.",
-                      city_name_get(pcity));
+    free(results);
+    free(batch);
   }
 
-  log_handle_city2("END handle city=(%d)", city_id);
+  dbv_free(&claimed);
+
+  if (stats.cities_handled > handled) {
+    stats.batches++;
+  }
 }
 
 /************************************************************************//**
@@ -451,7 +642,7 @@ static void city_changed(int city_id)
 
   if (pcity) {
     cm_clear_cache(pcity);
-    handle_city(pcity);
+    dirty_city_add(city_id, 0);
   }
 }
 
@@ -469,6 +660,13 @@ static void city_remove(int city_id)
 static void new_turn(void)
 {
   report_stats();
+
+  log_verbose("CMA: %d cities handled in %d batches with %d round trips "
+              "since the last turn start.", stats.cities_handled,
+              stats.batches, stats.round_trips);
+  stats.cities_handled = 0;
+  stats.batches = 0;
+  stats.round_trips = 0;
 }
 
 /*************************** public interface ******************************/
@@ -494,6 +692,8 @@ void cma_init(void)
   stats.wall_timer = timer_renew(timer, TIMER_USER, TIMER_ACTIVE,
                                  timer != NULL ? NULL : "agent: stats");
 
+  dirty.index = dirty_index_hash_new();
+
   memset(&self, 0, sizeof(self));
   strcpy(self.name, "CMA");
   self.level = 1;
@@ -501,9 +701,23 @@ void cma_init(void)
   self.city_callbacks[CB_NEW] = city_changed;
   self.city_callbacks[CB_REMOVE] = city_remove;
   self.turn_start_notify = new_turn;
+  self.calls_done_notify = handle_dirty_cities;
   register_agent(&self);
 }
 
+/************************************************************************//**
+  Free the resources of the city governor code
+****************************************************************************/
+void cma_done(void)
+{
+  free(dirty.cities);
+  dirty.cities = NULL;
+  dirty.count = 0;
+  dirty.size = 0;
+  dirty_index_hash_destroy(dirty.index);
+  dirty.index = NULL;
+}
+
 /************************************************************************//**
   Apply result on server if it's valid
 ****************************************************************************/
@@ -41,6 +41,9 @@ extern "C" {
  */
 void cma_init(void);
 
+/* Frees what cma_init() and the handled cities allocated. */
+void cma_done(void);
+
 /* Change the actual city setting. */
 bool cma_apply_result(struct city *pcity, const struct cm_result *result);
 
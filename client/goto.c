@@ -20,6 +20,7 @@
 /* utility */
 #include "log.h"
 #include "mem.h"
+#include "timing.h"
 
 /* common */
 #include "game.h"
@@ -44,6 +45,27 @@
 #define log_goto_path           log_debug
 #define log_goto_packet         log_debug
 
+/*
+ * A path-finding map shared by all parts which start with equivalent
+ * parameters, e.g. a stack of units of the same type moved together.
+ * The map is only iterated as far as the tiles asked for so far, and
+ * kept as long as any part refers to it.
+ */
+struct goto_pf_map {
+  struct pf_parameter parameter;
+  struct pf_map *map;
+  int refcount;
+};
+
+/* Get 'struct goto_pf_map_list' and related functions: */
+#define SPECLIST_TAG goto_pf_map
+#define SPECLIST_TYPE struct goto_pf_map
+#include "speclist.h"
+#define goto_pf_map_list_iterate(maplist, pmap)                         \
+  TYPED_LIST_ITERATE(struct goto_pf_map, maplist, pmap)
+#define goto_pf_map_list_iterate_end                                    \
+  LIST_ITERATE_END
+
 /*
  * The whole path is separated by waypoints into parts. Each part has its
  * own starting position and requires its own map. When the unit is unable
@@ -53,7 +75,7 @@ struct part {
   struct tile *start_tile, *end_tile;
   int end_moves_left, end_fuel_left;
   struct pf_path *path;
-  struct pf_map *map;
+  struct goto_pf_map *map;
 };
 
 struct goto_map {
@@ -89,8 +111,14 @@ struct goto_map {
   } goto_map_list_iterate_end;
 
 static struct goto_map_list *goto_maps = nullptr;
+static struct goto_pf_map_list *goto_pf_maps = nullptr;
 static bool goto_warned = FALSE;
 
+/* Time spent updating the goto lines after the mouse moved. */
+static struct timer *goto_timer = nullptr;
+static int goto_updates = 0;
+static double goto_update_max = 0.0;
+
 static void reset_last_part(struct goto_map *goto_map);
 static void remove_last_part(struct goto_map *goto_map);
 static void fill_parameter_part(struct pf_parameter *param,
@@ -102,6 +130,78 @@ static void fill_parameter_part(struct pf_parameter *param,
 ****************************************************************************/
 static struct tile *goto_destination = nullptr;
 
+/************************************************************************//**
+  Return whether both parameters lead to the same path-finding map.
+****************************************************************************/
+static bool goto_parameter_equal(const struct pf_parameter *a,
+                                 const struct pf_parameter *b)
+{
+  return (a->map == b->map
+          && a->start_tile == b->start_tile
+          && a->moves_left_initially == b->moves_left_initially
+          && a->fuel_left_initially == b->fuel_left_initially
+          && a->transported_by_initially == b->transported_by_initially
+          && a->cargo_depth == b->cargo_depth
+          && BV_ARE_EQUAL(a->cargo_types, b->cargo_types)
+          && a->move_rate == b->move_rate
+          && a->fuel == b->fuel
+          && a->utype == b->utype
+          && a->owner == b->owner
+          && a->omniscience == b->omniscience
+          && a->get_MC == b->get_MC
+          && a->get_move_scope == b->get_move_scope
+          && a->ignore_none_scopes == b->ignore_none_scopes
+          && a->get_TB == b->get_TB
+          && a->get_EC == b->get_EC
+          && a->get_action == b->get_action
+          && a->actions == b->actions
+          && a->is_action_possible == b->is_action_possible
+          && a->get_zoc == b->get_zoc
+          && a->is_pos_dangerous == b->is_pos_dangerous
+          && a->get_moves_left_req == b->get_moves_left_req
+          && a->get_costs == b->get_costs
+          /* 'data' is only set for the connect cost callbacks. */
+          && (a->get_costs == nullptr || a->data == b->data));
+}
+
+/************************************************************************//**
+  Return a path-finding map for the parameter, sharing an existing one
+  when another part already uses equivalent parameters.
+****************************************************************************/
+static struct goto_pf_map *goto_pf_map_get(const struct pf_parameter *param)
+{
+  struct goto_pf_map *pmap;
+
+  goto_pf_map_list_iterate(goto_pf_maps, pshared) {
+    if (goto_parameter_equal(&pshared->parameter, param)) {
+      pshared->refcount++;
+      return pshared;
+    }
+  } goto_pf_map_list_iterate_end;
+
+  pmap = fc_malloc(sizeof(*pmap));
+  pmap->parameter = *param;
+  pmap->map = pf_map_new(param);
+  pmap->refcount = 1;
+  goto_pf_map_list_append(goto_pf_maps, pmap);
+
+  return pmap;
+}
+
+/************************************************************************//**
+  Drop a reference to a path-finding map, freeing it with the last one.
+****************************************************************************/
+static void goto_pf_map_release(struct goto_pf_map *pmap)
+{
+  fc_assert_ret(pmap->refcount > 0);
+
+  if (--pmap->refcount == 0) {
+    goto_pf_map_list_remove(goto_pf_maps, pmap);
+    pf_map_destroy(pmap->map);
+    free(pmap);
+  }
+}
+
 /************************************************************************//**
   Create a new goto map.
 ****************************************************************************/
@@ -155,6 +255,7 @@ void init_client_goto(void)
   free_client_goto();
 
   goto_maps = goto_map_list_new();
+  goto_pf_maps = goto_pf_map_list_new();
 }
 
 /************************************************************************//**
@@ -169,6 +270,15 @@ void free_client_goto(void)
     goto_map_list_destroy(goto_maps);
     goto_maps = nullptr;
   }
+  if (goto_pf_maps != nullptr) {
+    fc_assert(goto_pf_map_list_size(goto_pf_maps) == 0);
+    goto_pf_map_list_destroy(goto_pf_maps);
+    goto_pf_maps = nullptr;
+  }
+  if (goto_timer != nullptr) {
+    timer_destroy(goto_timer);
+    goto_timer = nullptr;
+  }
 
   goto_destination = nullptr;
   goto_warned = FALSE;
@@ -270,7 +380,7 @@ static bool update_last_part(struct goto_map *goto_map,
 
   log_debug("update_last_part(%d,%d) old (%d,%d)-(%d,%d)",
             TILE_XY(ptile), TILE_XY(p->start_tile), TILE_XY(p->end_tile));
-  new_path = pf_map_path(p->map, ptile);
+  new_path = pf_map_path(p->map->map, ptile);
 
   if (!new_path) {
     log_goto_path("  no path found");
@@ -462,7 +572,7 @@ static void add_part(struct goto_map *goto_map)
   p->path = nullptr;
   p->end_tile = p->start_tile;
   parameter.start_tile = p->start_tile;
-  p->map = pf_map_new(&parameter);
+  p->map = goto_pf_map_get(&parameter);
 }
 
 /************************************************************************//**
@@ -479,7 +589,7 @@ static void remove_last_part(struct goto_map *goto_map)
     /* We do not always have a path */
     pf_path_destroy(p->path);
   }
-  pf_map_destroy(p->map);
+  goto_pf_map_release(p->map);
   goto_map->num_parts--;
 }
 
@@ -1041,6 +1151,13 @@ void exit_goto_state(void)
   } goto_map_list_iterate_end;
   goto_map_list_clear(goto_maps);
 
+  if (goto_updates > 0) {
+    log_verbose("Goto lines updated %d times, slowest took %.3f ms.",
+                goto_updates, goto_update_max * 1000.0);
+    goto_updates = 0;
+    goto_update_max = 0.0;
+  }
+
   goto_destination = nullptr;
   goto_warned = FALSE;
 }
@@ -1355,6 +1472,10 @@ bool is_valid_goto_draw_line(struct tile *dest_tile)
     return FALSE;
   }
 
+  goto_timer = timer_renew(goto_timer, TIMER_USER, TIMER_ACTIVE,
+                           goto_timer != nullptr ? nullptr : "goto");
+  timer_start(goto_timer);
+
   /* Assume valid destination */
   goto_destination = dest_tile;
 
@@ -1364,6 +1485,14 @@ bool is_valid_goto_draw_line(struct tile *dest_tile)
     }
   } goto_map_list_iterate_end;
 
+  timer_stop(goto_timer);
+  goto_updates++;
+  goto_update_max = MAX(goto_update_max, timer_read_seconds(goto_timer));
+  log_debug("Goto lines to (%d, %d) for %d units on %d maps: %.3f ms",
+            TILE_XY(dest_tile), goto_map_list_size(goto_maps),
+            goto_pf_map_list_size(goto_pf_maps),
+            timer_read_seconds(goto_timer) * 1000.0);
+
   /* Update goto data in info label. */
   update_unit_info_label(get_units_in_focus());
 
@@ -52,14 +52,10 @@ void handle_authentication_req(enum authentication_type type,
 {
   switch (type) {
   case AUTH_NEWUSER_FIRST:
-     /* PORTME: switch configs if need be */
-    return;
-  case AUTH_NEWUSER_RETRY:
-     /* PORTME: switch configs if need be */
-    return;
   case AUTH_LOGIN_FIRST:
     /* if we magically have a password already present in 'fc_password'
-     * then, use that and skip the password entry dialog */
+     * then, use that and skip the password entry dialog. A new user
+     * gets registered with it. */
     if (fc_password[0] != '\0') {
       struct packet_authentication_reply reply;
 
@@ -70,6 +66,7 @@ void handle_authentication_req(enum authentication_type type,
      /* PORTME: switch configs if need be */
     }
     return;
+  case AUTH_NEWUSER_RETRY:
   case AUTH_LOGIN_RETRY:
      /* PORTME: switch configs if need be */
     return;
@@ -0,0 +1,774 @@
+/***********************************************************************
+ Freeciv - Copyright (C) 1996-2026 - Freeciv Development Team
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+***********************************************************************/
+
+/**********************************************************************
+  fcbench is a headless load generator built on top of the stub gui.
+
+  It runs the normal client core without any user interface. One or more
+  connections (one forked process each) join a server as players or
+  observers, replay a script of orders every turn, end their turn, and
+  report per turn packet volume and request latency. Request latency is
+  the time from sending a request to receiving the matching
+  PACKET_PROCESSING_FINISHED. The totals also include the login time,
+  from connecting to the connection getting established, which covers
+  authentication when the server has it enabled (see --password).
+
+  Script lines are of the form "[@turn] command". Lines without a turn
+  are run every turn. Empty lines and lines starting with '#' are
+  ignored. Commands:
+    /<server command>          - sent as a chat line
+    chat <text>                - sent as a chat line
+    activity <fortify|sentry|explore>
+                               - set activity for all idle own units
+    build <kind> <rule name>   - change production of all own cities,
+                                 e.g. "build UnitType Warriors"
+    cma                        - put all own cities under the citizen
+                                 governor with default parameters
+    goto <radius>              - select all idle own units and sweep the
+                                 goto line over every tile within radius
+                                 of the first one, reporting the time
+                                 each cursor move takes
+**********************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <fc_config.h>
+#endif
+
+#include "fc_prehdrs.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+/* utility */
+#include "fc_cmdline.h"
+#include "fciconv.h"
+#include "fcintl.h"
+#include "log.h"
+#include "mem.h"
+#include "netintf.h"
+#include "shared.h"
+#include "support.h"
+#include "timing.h"
+
+/* common */
+#include "city.h"
+#include "game.h"
+#include "map.h"
+#include "packets.h"
+#include "player.h"
+#include "requirements.h"
+#include "unit.h"
+#include "unitlist.h"
+
+/* client */
+#include "chatline_common.h"
+#include "citydlg_common.h"
+#include "client_main.h"
+#include "clinet.h"
+#include "cma_core.h"
+#include "control.h"
+#include "goto.h"
+#include "options.h"
+#include "packhand.h"
+#include "update_queue.h"
+
+#include "fcbench.h"
+
+#if defined(HAVE_WORKING_FORK) && !defined(FREECIV_MSWINDOWS)
+#define HAVE_USABLE_FORK
+#endif
+
+/* Longest time to sleep in the main loop, in seconds. */
+#define FCBENCH_MAX_SLEEP 0.05
+
+/* Number of requests that can await their reply at the same time. */
+#define FCBENCH_MAX_PENDING 4096
+
+struct fcbench_action {
+  int turn;                     /* -1 for every turn */
+  char *command;
+};
+
+struct fcbench_stats {
+  int packets_in;
+  int bytes_in;
+  int packets_out;
+  int bytes_out;
+  int requests;
+  int replies;
+  double latency_sum;
+  double latency_max;
+};
+
+struct fcbench_idle {
+  void (*callback)(void *);
+  void *data;
+};
+
+static int bench_connections = 1;
+static int bench_index = 0;
+static int bench_turns = 0;
+static bool bench_observe = FALSE;
+static char *bench_script_name = nullptr;
+static char *bench_report_name = nullptr;
+
+static struct fcbench_action *bench_actions = nullptr;
+static int bench_num_actions = 0;
+
+static FILE *bench_report = nullptr;
+static struct timer *bench_clock = nullptr;
+static int bench_sock = -1;
+static bool bench_was_connected = FALSE;
+static double bench_connect_time = 0.0;
+static double bench_login_time = -1.0;
+
+static int bench_first_turn = -1;
+static int bench_stats_turn = -1;
+static int bench_acted_turn = -1;
+static bool bench_pregame_done = FALSE;
+
+static struct fcbench_stats turn_stats;
+static struct fcbench_stats total_stats;
+
+static struct {
+  int request_id;
+  double sent;
+} bench_pending[FCBENCH_MAX_PENDING];
+
+static struct fcbench_idle *idle_queue = nullptr;
+static int idle_queue_len = 0;
+static int idle_queue_size = 0;
+
+/**********************************************************************//**
+  Print usage information for the fcbench options.
+**************************************************************************/
+void fcbench_print_usage(void)
+{
+  fc_fprintf(stderr,
+             _("  --connections N\tOpen N connections, one process each\n"
+               "  --observe\t\tJoin as observers instead of players\n"
+               "  --password PW\t\tLog in, or register, with password PW\n"
+               "  --report FILE\t\tAppend per turn statistics to FILE\n"
+               "  --script FILE\t\tReplay orders from FILE every turn\n"
+               "  --turns N\t\tQuit after N turns\n\n"));
+}
+
+/**********************************************************************//**
+  Parse one fcbench command line option at argv[*i]. Returns FALSE if
+  the option is not an fcbench option.
+**************************************************************************/
+bool fcbench_parse_option(int argc, char **argv, int *i)
+{
+  char *option;
+
+  if ((option = get_option_malloc("--connections", argv, i, argc, FALSE))) {
+    if (!str_to_int(option, &bench_connections)
+        || bench_connections < 1) {
+      fc_fprintf(stderr, _("Invalid connection count \"%s\".\n"), option);
+      exit(EXIT_FAILURE);
+    }
+    free(option);
+  } else if (is_option("--observe", argv[*i])) {
+    bench_observe = TRUE;
+  } else if ((option = get_option_malloc("--password", argv, i, argc,
+                                         FALSE))) {
+    sz_strlcpy(fc_password, option);
+    free(option);
+  } else if ((option = get_option_malloc("--report", argv, i, argc,
+                                         TRUE))) {
+    free(bench_report_name);
+    bench_report_name = option;
+  } else if ((option = get_option_malloc("--script", argv, i, argc,
+                                         TRUE))) {
+    free(bench_script_name);
+    bench_script_name = option;
+  } else if ((option = get_option_malloc("--turns", argv, i, argc, FALSE))) {
+    if (!str_to_int(option, &bench_turns) || bench_turns < 0) {
+      fc_fprintf(stderr, _("Invalid turn count \"%s\".\n"), option);
+      exit(EXIT_FAILURE);
+    }
+    free(option);
+  } else {
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**********************************************************************//**
+  Load the order script.
+**************************************************************************/
+static bool fcbench_load_script(const char *filename)
+{
+  char line[1024];
+  FILE *fp = fc_fopen(filename, "r");
+
+  if (fp == nullptr) {
+    log_error(_("Cannot open script file \"%s\"."), filename);
+    return FALSE;
+  }
+
+  while (fgets(line, sizeof(line), fp) != nullptr) {
+    char *command = line;
+    int turn = -1;
+
+    remove_leading_trailing_spaces(command);
+    if (command[0] == '\0' || command[0] == '#') {
+      continue;
+    }
+
+    if (command[0] == '@') {
+      char *end;
+
+      turn = strtol(command + 1, &end, 10);
+      if (end == command + 1 || turn < 0) {
+        log_error(_("Invalid turn in script line \"%s\"."), line);
+        continue;
+      }
+      command = end;
+      remove_leading_trailing_spaces(command);
+    }
+
+    bench_actions = fc_realloc(bench_actions,
+                               (bench_num_actions + 1)
+                               * sizeof(*bench_actions));
+    bench_actions[bench_num_actions].turn = turn;
+    bench_actions[bench_num_actions].command = fc_strdup(command);
+    bench_num_actions++;
+  }
+
+  fclose(fp);
+  log_verbose("fcbench: loaded %d script lines from \"%s\".",
+              bench_num_actions, filename);
+
+  return TRUE;
+}
+
+/**********************************************************************//**
+  Write statistics line for the given turn, or the totals if turn is -1.
+**************************************************************************/
+static void fcbench_report(int turn, const struct fcbench_stats *stats)
+{
+  double avg = stats->replies > 0
+    ? 1000.0 * stats->latency_sum / stats->replies : 0.0;
+
+  if (turn < 0) {
+    fprintf(bench_report, "fcbench conn=%d user=%s total", bench_index,
+            user_name);
+  } else {
+    fprintf(bench_report, "fcbench conn=%d user=%s turn=%d", bench_index,
+            user_name, turn);
+  }
+  fprintf(bench_report,
+          " packets_in=%d bytes_in=%d packets_out=%d bytes_out=%d"
+          " requests=%d replies=%d latency_avg_ms=%.3f latency_max_ms=%.3f",
+          stats->packets_in, stats->bytes_in,
+          stats->packets_out, stats->bytes_out,
+          stats->requests, stats->replies,
+          avg, 1000.0 * stats->latency_max);
+  if (turn < 0) {
+    fprintf(bench_report, " login_ms=%.3f", 1000.0 * bench_login_time);
+  }
+  fprintf(bench_report, "\n");
+  fflush(bench_report);
+}
+
+/**********************************************************************//**
+  Add per turn statistics to the totals, report and reset them.
+**************************************************************************/
+static void fcbench_finish_turn_stats(void)
+{
+  if (bench_stats_turn < 0) {
+    return;
+  }
+
+  total_stats.packets_in += turn_stats.packets_in;
+  total_stats.bytes_in += turn_stats.bytes_in;
+  total_stats.packets_out += turn_stats.packets_out;
+  total_stats.bytes_out += turn_stats.bytes_out;
+  total_stats.requests += turn_stats.requests;
+  total_stats.replies += turn_stats.replies;
+  total_stats.latency_sum += turn_stats.latency_sum;
+  total_stats.latency_max = MAX(total_stats.latency_max,
+                                turn_stats.latency_max);
+
+  fcbench_report(bench_stats_turn, &turn_stats);
+  memset(&turn_stats, 0, sizeof(turn_stats));
+}
+
+/**********************************************************************//**
+  The server finished processing one of our requests.
+**************************************************************************/
+static void fcbench_request_processed(void *data)
+{
+  int request_id = FC_PTR_TO_INT(data);
+  int slot = request_id % FCBENCH_MAX_PENDING;
+  double latency;
+
+  if (bench_pending[slot].request_id != request_id) {
+    /* Overwritten by a later request. */
+    return;
+  }
+
+  latency = timer_read_seconds(bench_clock) - bench_pending[slot].sent;
+  bench_pending[slot].request_id = 0;
+
+  turn_stats.replies++;
+  turn_stats.latency_sum += latency;
+  turn_stats.latency_max = MAX(turn_stats.latency_max, latency);
+}
+
+/**********************************************************************//**
+  Count incoming packets.
+**************************************************************************/
+static void fcbench_incoming_packet(struct connection *pc,
+                                    int packet_type, int size)
+{
+  turn_stats.packets_in++;
+  turn_stats.bytes_in += size;
+
+  notify_about_incoming_packet(pc, packet_type, size);
+}
+
+/**********************************************************************//**
+  Count outgoing packets and start timing the request.
+**************************************************************************/
+static void fcbench_outgoing_packet(struct connection *pc,
+                                    int packet_type, int size,
+                                    int request_id)
+{
+  turn_stats.packets_out++;
+  turn_stats.bytes_out += size;
+
+  if (pc->established && request_id > 0) {
+    int slot = request_id % FCBENCH_MAX_PENDING;
+
+    bench_pending[slot].request_id = request_id;
+    bench_pending[slot].sent = timer_read_seconds(bench_clock);
+    turn_stats.requests++;
+    update_queue_connect_processing_finished(request_id,
+                                             fcbench_request_processed,
+                                             FC_INT_TO_PTR(request_id));
+  }
+
+  notify_about_outgoing_packet(pc, packet_type, size, request_id);
+}
+
+/**********************************************************************//**
+  Set the given activity for all idle units of the player.
+**************************************************************************/
+static void fcbench_units_activity(const char *name)
+{
+  enum unit_activity act;
+
+  if (!fc_strcasecmp(name, "fortify")) {
+    act = ACTIVITY_FORTIFYING;
+  } else if (!fc_strcasecmp(name, "sentry")) {
+    act = ACTIVITY_SENTRY;
+  } else if (!fc_strcasecmp(name, "explore")) {
+    act = ACTIVITY_EXPLORE;
+  } else {
+    log_error(_("fcbench: unknown activity \"%s\"."), name);
+    return;
+  }
+
+  unit_list_iterate(client_player()->units, punit) {
+    if (punit->activity == ACTIVITY_IDLE
+        && can_unit_do_activity_client(punit, act)) {
+      request_new_unit_activity(punit, act);
+    }
+  } unit_list_iterate_end;
+}
+
+/**********************************************************************//**
+  Change production of all cities of the player.
+**************************************************************************/
+static void fcbench_cities_build(const char *args)
+{
+  char kind[64];
+  const char *name;
+  struct universal target;
+
+  name = strchr(args, ' ');
+  if (name == nullptr) {
+    log_error(_("fcbench: build needs kind and name, got \"%s\"."), args);
+    return;
+  }
+  fc_strlcpy(kind, args, MIN(sizeof(kind), (size_t)(name - args + 1)));
+  name++;
+
+  target = universal_by_rule_name(kind, name);
+  if (target.kind != VUT_IMPROVEMENT && target.kind != VUT_UTYPE) {
+    log_error(_("fcbench: cannot build \"%s\"."), args);
+    return;
+  }
+
+  city_list_iterate(client_player()->cities, pcity) {
+    if (!are_universals_equal(&pcity->production, &target)
+        && can_city_build_now(&(wld.map), pcity, &target, RPT_CERTAIN)) {
+      city_change_production(pcity, &target);
+    }
+  } city_list_iterate_end;
+}
+
+/**********************************************************************//**
+  Put all cities of the player under the citizen governor.
+**************************************************************************/
+static void fcbench_cities_cma(void)
+{
+  struct cm_parameter parameter;
+
+  cm_init_parameter(&parameter);
+
+  city_list_iterate(client_player()->cities, pcity) {
+    if (!cma_is_city_under_agent(pcity, nullptr)) {
+      cma_put_city_under_agent(pcity, &parameter);
+    }
+  } city_list_iterate_end;
+}
+
+/**********************************************************************//**
+  Select all idle units of the player and move the goto line over the
+  tiles around the first one, like dragging the mouse in goto mode.
+**************************************************************************/
+static void fcbench_goto_sweep(const char *args)
+{
+  struct unit_list *punits;
+  struct unit *pfirst = nullptr;
+  struct timer *sweep_timer;
+  double sweep_sum = 0.0, sweep_max = 0.0;
+  int radius, tiles = 0;
+
+  if (!str_to_int(args, &radius) || radius < 0) {
+    log_error(_("fcbench: goto needs a radius, got \"%s\"."), args);
+    return;
+  }
+
+  unit_list_iterate(client_player()->units, punit) {
+    if (punit->activity != ACTIVITY_IDLE || punit->moves_left <= 0) {
+      continue;
+    }
+    if (pfirst == nullptr) {
+      pfirst = punit;
+      unit_focus_set(punit);
+    } else {
+      unit_focus_add(punit);
+    }
+  } unit_list_iterate_end;
+
+  if (pfirst == nullptr) {
+    return;
+  }
+
+  punits = get_units_in_focus();
+  set_hover_state(punits, HOVER_GOTO, ACTIVITY_LAST, nullptr,
+                  NO_TARGET, NO_TARGET, ACTION_NONE, ORDER_LAST);
+  enter_goto_state(punits);
+
+  sweep_timer = timer_new(TIMER_USER, TIMER_ACTIVE, "goto sweep");
+  square_iterate(&(wld.map), unit_tile(pfirst), radius, ptile) {
+    timer_clear(sweep_timer);
+    timer_start(sweep_timer);
+    (void) is_valid_goto_draw_line(ptile);
+    timer_stop(sweep_timer);
+    sweep_sum += timer_read_seconds(sweep_timer);
+    sweep_max = MAX(sweep_max, timer_read_seconds(sweep_timer));
+    tiles++;
+  } square_iterate_end;
+
+  fprintf(bench_report,
+          "fcbench conn=%d user=%s turn=%d goto units=%d tiles=%d"
+          " cursor_avg_ms=%.3f cursor_max_ms=%.3f\n",
+          bench_index, user_name, game.info.turn,
+          unit_list_size(punits), tiles,
+          1000.0 * sweep_sum / tiles,
+          1000.0 * sweep_max);
+  fflush(bench_report);
+
+  timer_destroy(sweep_timer);
+  clear_hover_state();
+  unit_focus_set(nullptr);
+}
+
+/**********************************************************************//**
+  Run one script command.
+**************************************************************************/
+static void fcbench_run_command(const char *command)
+{
+  if (command[0] == '/') {
+    send_chat(command);
+  } else if (!strncmp(command, "chat ", 5)) {
+    send_chat(command + 5);
+  } else if (!client_has_player() || client_is_observer()) {
+    /* Orders need a player. */
+    return;
+  } else if (!strncmp(command, "activity ", 9)) {
+    fcbench_units_activity(command + 9);
+  } else if (!strncmp(command, "build ", 6)) {
+    fcbench_cities_build(command + 6);
+  } else if (!strcmp(command, "cma")) {
+    fcbench_cities_cma();
+  } else if (!strncmp(command, "goto ", 5)) {
+    fcbench_goto_sweep(command + 5);
+  } else {
+    log_error(_("fcbench: unknown script command \"%s\"."), command);
+  }
+}
+
+/**********************************************************************//**
+  Do whatever the connection should do in its current state.
+**************************************************************************/
+static void fcbench_act(void)
+{
+  int i;
+
+  if (!client.conn.established) {
+    return;
+  }
+
+  if (bench_login_time < 0.0) {
+    bench_login_time = timer_read_seconds(bench_clock) - bench_connect_time;
+  }
+
+  if (client_state() == C_S_PREPARING) {
+    if (!bench_pregame_done) {
+      if (bench_observe) {
+        send_chat("/observe");
+      } else if (client_has_player()) {
+        dsend_packet_player_ready(&client.conn,
+                                  player_number(client_player()), TRUE);
+      } else {
+        return;
+      }
+      bench_pregame_done = TRUE;
+    }
+    return;
+  }
+
+  if (client_state() == C_S_OVER) {
+    start_quitting();
+    return;
+  }
+
+  if (client_state() != C_S_RUNNING) {
+    return;
+  }
+
+  if (bench_first_turn < 0) {
+    bench_first_turn = game.info.turn;
+  }
+
+  if (game.info.turn != bench_stats_turn) {
+    fcbench_finish_turn_stats();
+    bench_stats_turn = game.info.turn;
+
+    if (bench_turns > 0 && game.info.turn >= bench_first_turn + bench_turns) {
+      /* Nothing to report about the turn we are not going to play. */
+      bench_stats_turn = -1;
+      start_quitting();
+      return;
+    }
+  }
+
+  if (bench_acted_turn == game.info.turn
+      || (!bench_observe && !can_client_issue_orders())) {
+    return;
+  }
+  bench_acted_turn = game.info.turn;
+
+  for (i = 0; i < bench_num_actions; i++) {
+    if (bench_actions[i].turn < 0
+        || bench_actions[i].turn == game.info.turn) {
+      fcbench_run_command(bench_actions[i].command);
+    }
+  }
+
+  if (!bench_observe) {
+    send_turn_done();
+  }
+}
+
+/**********************************************************************//**
+  Run the queued idle callbacks.
+**************************************************************************/
+static void fcbench_run_idle_callbacks(void)
+{
+  while (idle_queue_len > 0) {
+    struct fcbench_idle first = idle_queue[0];
+
+    idle_queue_len--;
+    memmove(idle_queue, idle_queue + 1, idle_queue_len * sizeof(*idle_queue));
+    first.callback(first.data);
+  }
+}
+
+/**********************************************************************//**
+  Queue a callback to be run in the main loop.
+**************************************************************************/
+void fcbench_add_idle_callback(void (callback)(void *), void *data)
+{
+  if (idle_queue_len == idle_queue_size) {
+    idle_queue_size = MAX(16, 2 * idle_queue_size);
+    idle_queue = fc_realloc(idle_queue,
+                            idle_queue_size * sizeof(*idle_queue));
+  }
+  idle_queue[idle_queue_len].callback = callback;
+  idle_queue[idle_queue_len].data = data;
+  idle_queue_len++;
+}
+
+/**********************************************************************//**
+  Start listening to the server connection.
+**************************************************************************/
+void fcbench_add_net_input(int sock)
+{
+  bench_sock = sock;
+  bench_was_connected = TRUE;
+  bench_connect_time = timer_read_seconds(bench_clock);
+
+  client.conn.incoming_packet_notify = fcbench_incoming_packet;
+  client.conn.outgoing_packet_notify = fcbench_outgoing_packet;
+}
+
+/**********************************************************************//**
+  Stop listening to the server connection.
+**************************************************************************/
+void fcbench_remove_net_input(void)
+{
+  bench_sock = -1;
+}
+
+/**********************************************************************//**
+  Fork the extra connections. Returns the index of this connection.
+**************************************************************************/
+static int fcbench_fork_connections(void)
+{
+#ifdef HAVE_USABLE_FORK
+  int i;
+
+  for (i = 1; i < bench_connections; i++) {
+    pid_t pid = fork();
+
+    if (pid == 0) {
+      return i;
+    } else if (pid < 0) {
+      log_error(_("fcbench: fork failed, running %d connections."), i);
+      bench_connections = i;
+      break;
+    }
+  }
+#else  /* HAVE_USABLE_FORK */
+  if (bench_connections > 1) {
+    log_error(_("fcbench: no fork() support, running one connection."));
+    bench_connections = 1;
+  }
+#endif /* HAVE_USABLE_FORK */
+
+  return 0;
+}
+
+/**********************************************************************//**
+  The main loop of the load generator.
+**************************************************************************/
+int fcbench_main_loop(void)
+{
+  char base_name[sizeof(user_name)];
+
+  if (bench_script_name != nullptr
+      && !fcbench_load_script(bench_script_name)) {
+    return EXIT_FAILURE;
+  }
+
+  bench_index = fcbench_fork_connections();
+  if (bench_connections > 1) {
+    sz_strlcpy(base_name, user_name);
+    fc_snprintf(user_name, sizeof(user_name), "%s%d",
+                base_name, bench_index);
+  }
+
+  if (bench_report_name != nullptr) {
+    bench_report = fc_fopen(bench_report_name, "a");
+    if (bench_report == nullptr) {
+      log_error(_("Cannot open report file \"%s\"."), bench_report_name);
+      return EXIT_FAILURE;
+    }
+  } else {
+    bench_report = stdout;
+  }
+
+  bench_clock = timer_new(TIMER_USER, TIMER_ACTIVE, "fcbench");
+  timer_start(bench_clock);
+
+  /* The stub gui has no sprites for the city bars, so own cities
+   * would crash the map drawing. */
+  gui_options.draw_city_names = FALSE;
+  gui_options.draw_city_productions = FALSE;
+  gui_options.draw_city_growth = FALSE;
+
+  auto_connect = TRUE;
+  set_client_state(C_S_DISCONNECTED);
+
+  while (!is_client_quitting()) {
+    double seconds = MIN(real_timer_callback(), FCBENCH_MAX_SLEEP);
+
+    fcbench_run_idle_callbacks();
+
+    if (bench_sock >= 0) {
+      fd_set readfs;
+      fc_timeval tv;
+
+      FD_ZERO(&readfs);
+      FD_SET(bench_sock, &readfs);
+      tv.tv_sec = 0;
+      tv.tv_usec = seconds * 1000000;
+
+      if (fc_select(bench_sock + 1, &readfs, nullptr, nullptr, &tv) > 0) {
+        input_from_server(bench_sock);
+      }
+    } else if (bench_was_connected) {
+      /* Server went away. */
+      start_quitting();
+    } else {
+      fc_usleep(seconds * 1000000);
+    }
+
+    fcbench_run_idle_callbacks();
+    fcbench_act();
+  }
+
+  fcbench_finish_turn_stats();
+  fcbench_report(-1, &total_stats);
+
+  if (bench_report != stdout) {
+    fclose(bench_report);
+  }
+  timer_destroy(bench_clock);
+
+#ifdef HAVE_USABLE_FORK
+  if (bench_index == 0) {
+    while (wait(nullptr) > 0) {
+      /* Wait for all the other connections to finish. */
+    }
+  }
+#endif /* HAVE_USABLE_FORK */
+
+  return EXIT_SUCCESS;
+}
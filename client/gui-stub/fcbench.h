@@ -0,0 +1,28 @@
+/***********************************************************************
+ Freeciv - Copyright (C) 1996-2026 - Freeciv Development Team
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+***********************************************************************/
+#ifndef FC__FCBENCH_H
+#define FC__FCBENCH_H
+
+/* utility */
+#include "support.h"            /* bool type */
+
+void fcbench_print_usage(void);
+bool fcbench_parse_option(int argc, char **argv, int *i);
+
+int fcbench_main_loop(void);
+
+void fcbench_add_net_input(int sock);
+void fcbench_remove_net_input(void);
+void fcbench_add_idle_callback(void (callback)(void *), void *data);
+
+#endif /* FC__FCBENCH_H */
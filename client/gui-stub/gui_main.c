@@ -29,11 +29,20 @@
 #include "gui_cbsetter.h"
 #include "client_main.h"
 #include "editgui_g.h"
+#include "gui_properties.h"
 #include "options.h"
 
+#ifdef FREECIV_FCBENCH
+#include "fcbench.h"
+#endif
+
 #include "gui_main.h"
 
+#ifdef FREECIV_FCBENCH
+const char *client_string = "fcbench";
+#else
 const char *client_string = "gui-stub";
+#endif
 
 const char * const gui_character_encoding = "UTF-8";
 const bool gui_use_transliteration = FALSE;
@@ -63,8 +72,12 @@ static void print_usage(const char *argv0)
 {
   /* PORTME */
   /* add client-specific usage information here */
+#ifdef FREECIV_FCBENCH
+  fcbench_print_usage();
+#else
   fc_fprintf(stderr,
              _("This client has no special command line options\n\n"));
+#endif
 
   /* TRANS: No full stop after the URL, could cause confusion. */
   fc_fprintf(stderr, _("Report bugs at %s\n"), BUG_URL);
@@ -82,6 +95,10 @@ static bool parse_options(int argc, char **argv)
       print_usage(argv[0]);
 
       return FALSE;
+#ifdef FREECIV_FCBENCH
+    } else if (fcbench_parse_option(argc, argv, &i)) {
+      /* Handled */
+#endif
     } else {
       fc_fprintf(stderr, _("Unrecognized option: \"%s\"\n"), argv[i]);
       exit(EXIT_FAILURE);
@@ -100,12 +117,16 @@ static bool parse_options(int argc, char **argv)
 int gui_ui_main(int argc, char *argv[])
 {
   if (parse_options(argc, argv)) {
+#ifdef FREECIV_FCBENCH
+    return fcbench_main_loop();
+#else
     /* PORTME */
     fc_fprintf(stderr, "Freeciv rules!\n");
 
     /* Main loop here */
 
     start_quitting();
+#endif
   }
 
   return EXIT_SUCCESS;
@@ -162,6 +183,9 @@ void gui_sound_bell(void)
 void gui_add_net_input(int sock)
 {
   /* PORTME */
+#ifdef FREECIV_FCBENCH
+  fcbench_add_net_input(sock);
+#endif
 }
 
 /**********************************************************************//**
@@ -172,6 +196,9 @@ void gui_add_net_input(int sock)
 void gui_remove_net_input(void)
 {
   /* PORTME */
+#ifdef FREECIV_FCBENCH
+  fcbench_remove_net_input();
+#endif
 }
 
 /**********************************************************************//**
@@ -220,10 +247,13 @@ void gui_real_focus_units_changed(void)
 void gui_add_idle_callback(void (callback)(void *), void *data)
 {
   /* PORTME */
-
+#ifdef FREECIV_FCBENCH
+  fcbench_add_idle_callback(callback, data);
+#else
   /* This is a reasonable fallback if it's not ported. */
   log_error("Unimplemented add_idle_callback.");
   (callback)(data);
+#endif
 }
 
 /**********************************************************************//**
@@ -285,4 +315,8 @@ void gui_insert_client_build_info(char *outbuf, size_t outlen)
 void gui_setup_gui_properties(void)
 {
   /* PORTME */
+
+  /* Tilesets are loaded even though nothing is drawn. */
+  gui_properties.views.isometric = TRUE;
+  gui_properties.views.overhead = TRUE;
 }
@@ -15,7 +15,13 @@
 #include <fc_config.h>
 #endif
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+/* utility */
+#include "mem.h"
+#include "support.h"
 
 /* gui main header */
 #include "gui_stub.h"
@@ -48,7 +54,34 @@ const char **gfx_fileextensions(void)
 struct sprite *gui_load_gfxfile(const char *filename, bool svgflag)
 {
   /* PORTME */
-  return nullptr;
+  unsigned char header[24];
+  struct sprite *s;
+  FILE *fp;
+
+  if (svgflag) {
+    return nullptr;
+  }
+
+  /* The image is not decoded, but the dimensions are read from the
+   * png IHDR chunk so that cropping works as with a real gui. */
+  fp = fc_fopen(filename, "rb");
+  if (fp == nullptr) {
+    return nullptr;
+  }
+  if (fread(header, 1, sizeof(header), fp) != sizeof(header)
+      || memcmp(header + 12, "IHDR", 4) != 0) {
+    fclose(fp);
+    return nullptr;
+  }
+  fclose(fp);
+
+  s = fc_malloc(sizeof(*s));
+  s->width = (header[16] << 24) | (header[17] << 16)
+    | (header[18] << 8) | header[19];
+  s->height = (header[20] << 24) | (header[21] << 16)
+    | (header[22] << 8) | header[23];
+
+  return s;
 }
 
 /************************************************************************//**
@@ -79,7 +112,17 @@ struct sprite *gui_crop_sprite(struct sprite *source,
                                float scale, bool smooth)
 {
   /* PORTME */
-  return nullptr;
+  struct sprite *s;
+
+  if (source == nullptr) {
+    return nullptr;
+  }
+
+  s = fc_malloc(sizeof(*s));
+  s->width = width * scale;
+  s->height = height * scale;
+
+  return s;
 }
 
 /************************************************************************//**
@@ -88,7 +131,12 @@ struct sprite *gui_crop_sprite(struct sprite *source,
 struct sprite *gui_create_sprite(int width, int height, struct color *pcolor)
 {
   /* PORTME */
-  return nullptr;
+  struct sprite *s = fc_malloc(sizeof(*s));
+
+  s->width = width;
+  s->height = height;
+
+  return s;
 }
 
 /************************************************************************//**
@@ -97,10 +145,8 @@ struct sprite *gui_create_sprite(int width, int height, struct color *pcolor)
 void gui_get_sprite_dimensions(struct sprite *sprite, int *width, int *height)
 {
   /* PORTME */
-#if 0
   *width = sprite->width;
   *height = sprite->height;
-#endif
 }
 
 /************************************************************************//**
@@ -109,6 +155,7 @@ void gui_get_sprite_dimensions(struct sprite *sprite, int *width, int *height)
 void gui_free_sprite(struct sprite *s)
 {
   /* PORTME */
+  free(s);
 }
 
 /************************************************************************//**
@@ -117,5 +164,5 @@ void gui_free_sprite(struct sprite *s)
 struct sprite *gui_load_gfxnumber(int num)
 {
   /* PORTME */
-  return nullptr;
+  return gui_create_sprite(8, 8, nullptr);
 }
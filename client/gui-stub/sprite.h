@@ -16,5 +16,11 @@
 
 #include "sprite_g.h"
 
+/* Sprites are never drawn, only their dimensions are tracked. */
+struct sprite {
+  int width;
+  int height;
+};
+
 
 #endif				/* FC__SPRITE_H */
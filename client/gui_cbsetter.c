@@ -26,10 +26,12 @@
 #include "citydlg_g.h"
 #include "connectdlg_g.h"
 #include "dialogs_g.h"
+#include "diplodlg_g.h"
 #include "editgui_g.h"
 #include "graphics_g.h"
 #include "gui_main_g.h"
 #include "mapview_g.h"
+#include "repodlgs_g.h"
 #include "sprite_g.h"
 #include "themes_g.h"
 
@@ -52,7 +54,9 @@ void setup_gui_funcs(void)
   funcs->version_message = gui_version_message;
   funcs->real_output_window_append = gui_real_output_window_append;
 
+  funcs->tileset_type_set = gui_tileset_type_set;
   funcs->load_gfxfile = gui_load_gfxfile;
+  funcs->load_gfxnumber = gui_load_gfxnumber;
   funcs->create_sprite = gui_create_sprite;
   funcs->get_sprite_dimensions = gui_get_sprite_dimensions;
   funcs->crop_sprite = gui_crop_sprite;
@@ -69,6 +73,7 @@ void setup_gui_funcs(void)
   funcs->canvas_copy = gui_canvas_copy;
   funcs->canvas_put_sprite = gui_canvas_put_sprite;
   funcs->canvas_put_sprite_full = gui_canvas_put_sprite_full;
+  funcs->canvas_put_sprite_full_scaled = gui_canvas_put_sprite_full_scaled;
   funcs->canvas_put_sprite_fogged = gui_canvas_put_sprite_fogged;
   funcs->canvas_put_rectangle = gui_canvas_put_rectangle;
   funcs->canvas_fill_sprite_area = gui_canvas_fill_sprite_area;
@@ -105,6 +110,7 @@ void setup_gui_funcs(void)
   funcs->editgui_popdown_all = gui_editgui_popdown_all;
 
   funcs->popup_combat_info = gui_popup_combat_info;
+  funcs->request_action_confirmation = gui_request_action_confirmation;
   funcs->update_timeout_label = gui_update_timeout_label;
   funcs->start_turn = gui_start_turn;
   funcs->real_city_dialog_popup = gui_real_city_dialog_popup;
@@ -119,6 +125,24 @@ void setup_gui_funcs(void)
 
   funcs->update_infra_dialog = gui_update_infra_dialog;
 
+  funcs->science_report_dialog_popup = gui_science_report_dialog_popup;
+  funcs->science_report_dialog_redraw = gui_science_report_dialog_redraw;
+  funcs->real_science_report_dialog_update
+    = gui_real_science_report_dialog_update;
+  funcs->real_economy_report_dialog_update
+    = gui_real_economy_report_dialog_update;
+  funcs->real_units_report_dialog_update
+    = gui_real_units_report_dialog_update;
+  funcs->endgame_report_dialog_start = gui_endgame_report_dialog_start;
+  funcs->endgame_report_dialog_player = gui_endgame_report_dialog_player;
+
+  funcs->gui_init_meeting = gui_gui_init_meeting;
+  funcs->gui_recv_cancel_meeting = gui_gui_recv_cancel_meeting;
+  funcs->gui_prepare_clause_updt = gui_gui_prepare_clause_updt;
+  funcs->gui_recv_create_clause = gui_gui_recv_create_clause;
+  funcs->gui_recv_remove_clause = gui_gui_recv_remove_clause;
+  funcs->gui_recv_accept_treaty = gui_gui_recv_accept_treaty;
+
   funcs->gui_load_theme = gui_gui_load_theme;
   funcs->gui_clear_theme = gui_gui_clear_theme;
   funcs->get_gui_specific_themes_directories = gui_get_gui_specific_themes_directories;
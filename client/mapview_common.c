@@ -3139,9 +3139,8 @@ void unqueue_mapview_updates(bool write_to_screen)
               max_y = MAX(max_y, yb);
             }
 
-            /* FIXME: These overview updates should be batched as well.
-             * Right now they account for as much as 90% of the runtime of
-             * the unqueue. */
+            /* This only marks the tile for the overview; the actual
+             * repainting is batched to flush_dirty_overview(). */
             overview_update_tile(ptile);
           } tile_list_iterate_end;
         }
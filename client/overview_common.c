@@ -19,6 +19,8 @@
 
 /* utility */
 #include "log.h"
+#include "mem.h"
+#include "timing.h"
 
 /* client */
 #include "client_main.h" /* can_client_change_view() */
@@ -48,6 +50,30 @@ struct overview overview = {
  */
 static bool overview_dirty = FALSE;
 
+/*
+ * The color of each tile in the backing store is cached as a compact key,
+ * one per tile in native index order. A key is either a standard color,
+ * a player color or a terrain color, optionally with the fog flag set.
+ * Tile updates only compare keys; the backing store is repainted later for
+ * the changed tiles only, one rectangle per run of equal keys in a row.
+ */
+#define OVERVIEW_KEY_FOG        (1 << 15)
+#define OVERVIEW_KEY_PLAYER     (1 << 14)
+#define OVERVIEW_KEY_TERRAIN    (1 << 13)
+#define OVERVIEW_KEY_INDEX_MASK (OVERVIEW_KEY_TERRAIN - 1)
+#define OVERVIEW_KEY_INVALID    0xFFFF
+
+static unsigned short *overview_keys = NULL;
+
+/* Per native row span of tiles whose key changed since the last repaint.
+ * The span is empty when min > max. */
+static int *overview_dirty_min = NULL;
+static int *overview_dirty_max = NULL;
+static int overview_keys_width = 0;
+static int overview_keys_height = 0;
+
+static void overview_paint_dirty_tiles(void);
+
 /************************************************************************//**
   Translate from gui to natural coordinate systems.  This provides natural
   coordinates as a floating-point value so there is no loss of information
@@ -113,9 +139,9 @@ static void gui_to_overview_pos(const struct tileset *t,
 }
 
 /************************************************************************//**
-  Return color for overview map tile.
+  Return color key for overview map tile, without the fog flag.
 ****************************************************************************/
-static struct color *overview_tile_color(struct tile *ptile)
+static unsigned short overview_tile_color_key(struct tile *ptile)
 {
   if (gui_options.overview.layers[OLAYER_CITIES]) {
     struct city *pcity = tile_city(ptile);
@@ -123,12 +149,12 @@ static struct color *overview_tile_color(struct tile *ptile)
     if (pcity) {
       if (NULL == client.conn.playing
           || city_owner(pcity) == client.conn.playing) {
-	return get_color(tileset, COLOR_OVERVIEW_MY_CITY);
+        return COLOR_OVERVIEW_MY_CITY;
       } else if (pplayers_allied(city_owner(pcity), client.conn.playing)) {
-	/* Includes teams. */
-	return get_color(tileset, COLOR_OVERVIEW_ALLIED_CITY);
+        /* Includes teams. */
+        return COLOR_OVERVIEW_ALLIED_CITY;
       } else {
-	return get_color(tileset, COLOR_OVERVIEW_ENEMY_CITY);
+        return COLOR_OVERVIEW_ENEMY_CITY;
       }
     }
   }
@@ -138,12 +164,12 @@ static struct color *overview_tile_color(struct tile *ptile)
     if (punit) {
       if (NULL == client.conn.playing
           || unit_owner(punit) == client.conn.playing) {
-	return get_color(tileset, COLOR_OVERVIEW_MY_UNIT);
+        return COLOR_OVERVIEW_MY_UNIT;
       } else if (pplayers_allied(unit_owner(punit), client.conn.playing)) {
-	/* Includes teams. */
-	return get_color(tileset, COLOR_OVERVIEW_ALLIED_UNIT);
+        /* Includes teams. */
+        return COLOR_OVERVIEW_ALLIED_UNIT;
       } else {
-	return get_color(tileset, COLOR_OVERVIEW_ENEMY_UNIT);
+        return COLOR_OVERVIEW_ENEMY_UNIT;
       }
     }
   }
@@ -151,31 +177,62 @@ static struct color *overview_tile_color(struct tile *ptile)
     struct player *owner = tile_owner(ptile);
 
     if (owner) {
-      if (gui_options.overview.layers[OLAYER_BORDERS_ON_OCEAN]) {
-        return get_player_color(tileset, owner);
-      } else if (!is_ocean_tile(ptile)) {
-        return get_player_color(tileset, owner);
+      if (gui_options.overview.layers[OLAYER_BORDERS_ON_OCEAN]
+          || !is_ocean_tile(ptile)) {
+        return OVERVIEW_KEY_PLAYER | player_number(owner);
       }
     }
   }
   if (gui_options.overview.layers[OLAYER_RELIEF]
       && tile_terrain(ptile) != T_UNKNOWN) {
-    return get_terrain_color(tileset, tile_terrain(ptile));
+    return OVERVIEW_KEY_TERRAIN | terrain_number(tile_terrain(ptile));
   }
   if (gui_options.overview.layers[OLAYER_BACKGROUND]
       && tile_terrain(ptile) != T_UNKNOWN) {
     if (terrain_has_flag(tile_terrain(ptile), TER_FROZEN)) {
-      return get_color(tileset, COLOR_OVERVIEW_FROZEN);
+      return COLOR_OVERVIEW_FROZEN;
     } else {
       if (is_ocean_tile(ptile)) {
-        return get_color(tileset, COLOR_OVERVIEW_OCEAN);
+        return COLOR_OVERVIEW_OCEAN;
       } else {
-        return get_color(tileset, COLOR_OVERVIEW_LAND);
+        return COLOR_OVERVIEW_LAND;
       }
     }
   }
 
-  return get_color(tileset, COLOR_OVERVIEW_UNKNOWN);
+  return COLOR_OVERVIEW_UNKNOWN;
+}
+
+/************************************************************************//**
+  Return full color key for overview map tile, including the fog flag.
+****************************************************************************/
+static unsigned short overview_tile_key(struct tile *ptile)
+{
+  unsigned short key = overview_tile_color_key(ptile);
+
+  if (gui_options.overview.fog
+      && TILE_KNOWN_UNSEEN == client_tile_get_known(ptile)) {
+    key |= OVERVIEW_KEY_FOG;
+  }
+
+  return key;
+}
+
+/************************************************************************//**
+  Return the color a color key stands for.
+****************************************************************************/
+static struct color *overview_key_color(unsigned short key)
+{
+  int idx = key & OVERVIEW_KEY_INDEX_MASK;
+
+  if (key & OVERVIEW_KEY_PLAYER) {
+    return get_player_color(tileset, player_by_number(idx));
+  }
+  if (key & OVERVIEW_KEY_TERRAIN) {
+    return get_terrain_color(tileset, terrain_by_number(idx));
+  }
+
+  return get_color(tileset, idx);
 }
 
 /************************************************************************//**
@@ -206,6 +263,8 @@ static void redraw_overview(void)
     return;
   }
 
+  overview_paint_dirty_tiles();
+
   {
     struct canvas *src = gui_options.overview.map;
     struct canvas *dst = gui_options.overview.window;
@@ -372,7 +431,8 @@ void overview_to_map_pos(int *map_x, int *map_y,
 }
 
 /************************************************************************//**
-  Redraw the entire backing store for the overview minimap.
+  Recalculate the color of every tile of the overview minimap. Only the
+  tiles whose color changed get repainted to the backing store.
 ****************************************************************************/
 void refresh_overview_canvas(void)
 {
@@ -386,62 +446,227 @@ void refresh_overview_canvas(void)
 }
 
 /************************************************************************//**
-  Draws the color for this tile onto the given rectangle of the canvas.
-
-  This is just a simple helper function for overview_update_tile, since
-  sometimes a tile may cover more than one rectangle.
+  Forget the cached tile colors and repaint every tile. To be called when
+  the colors themselves change, for example when a player color or the
+  tileset changes.
 ****************************************************************************/
-static void put_overview_tile_area(struct canvas *pcanvas,
-                                   struct tile *ptile,
-                                   int x, int y, int w, int h)
+void overview_colors_changed(void)
 {
-  canvas_put_rectangle(pcanvas,
-                       overview_tile_color(ptile),
-                       x, y, w, h);
-  if (gui_options.overview.fog
-      && TILE_KNOWN_UNSEEN == client_tile_get_known(ptile)) {
-    canvas_put_sprite(pcanvas, x, y, get_basic_fog_sprite(tileset),
-                      0, 0, w, h);
+  int i;
+
+  if (overview_keys == NULL) {
+    return;
+  }
+
+  for (i = 0; i < overview_keys_width * overview_keys_height; i++) {
+    overview_keys[i] = OVERVIEW_KEY_INVALID;
   }
+  for (i = 0; i < overview_keys_height; i++) {
+    overview_dirty_min[i] = 0;
+    overview_dirty_max[i] = overview_keys_width - 1;
+  }
+  dirty_overview();
+
+  refresh_overview_canvas();
 }
 
 /************************************************************************//**
-  Redraw the given map position in the overview canvas.
+  Draws a run of tiles with the same color key onto the backing store.
+  The run starts from the given native position and continues along
+  the native row.
 ****************************************************************************/
-void overview_update_tile(struct tile *ptile)
+static void put_overview_run(int nat_x, int nat_y, int count,
+                             unsigned short key)
 {
-  int tile_x, tile_y;
+  struct canvas *pcanvas = gui_options.overview.map;
+  struct color *pcolor = overview_key_color(key);
+  int map_x, map_y, ntl_x, ntl_y;
+  int overview_x, overview_y, wrap_x;
+  bool wrapped = FALSE;
 
   /* Base overview positions are just like natural positions, but scaled to
-   * the overview tile dimensions. */
-  index_to_map_pos(&tile_x, &tile_y, tile_index(ptile));
-  do_in_natural_pos(ntl_x, ntl_y, tile_x, tile_y) {
-    int overview_y = ntl_y * OVERVIEW_TILE_SIZE;
-    int overview_x = ntl_x * OVERVIEW_TILE_SIZE;
+   * the overview tile dimensions. Consecutive native positions in a row
+   * are always one overview tile width apart. */
+  NATIVE_TO_MAP_POS(&map_x, &map_y, nat_x, nat_y);
+  MAP_TO_NATURAL_POS(&ntl_x, &ntl_y, map_x, map_y);
+  overview_x = ntl_x * OVERVIEW_TILE_SIZE;
+  overview_y = ntl_y * OVERVIEW_TILE_SIZE;
+  wrap_x = overview_x + (count - 1) * OVERVIEW_TILE_WIDTH;
+
+  if (MAP_IS_ISOMETRIC) {
+    if (current_wrap_has_flag(WRAP_X)) {
+      if (wrap_x > gui_options.overview.width - OVERVIEW_TILE_WIDTH) {
+        /* The last tile is shown half on the left and half on the right
+         * side of the overview.  So we have to draw it in two parts. */
+        wrap_x -= gui_options.overview.width;
+        wrapped = TRUE;
+        canvas_put_rectangle(pcanvas, pcolor, wrap_x, overview_y,
+                             OVERVIEW_TILE_WIDTH, OVERVIEW_TILE_HEIGHT);
+      }
+    } else {
+      /* Clip half tile left and right.
+       * See comment in map_to_overview_pos(). */
+      overview_x -= OVERVIEW_TILE_SIZE;
+    }
+  }
 
-    if (MAP_IS_ISOMETRIC) {
-      if (current_wrap_has_flag(WRAP_X)) {
-        if (overview_x > gui_options.overview.width - OVERVIEW_TILE_WIDTH) {
-          /* This tile is shown half on the left and half on the right
-           * side of the overview.  So we have to draw it in two parts. */
-          put_overview_tile_area(gui_options.overview.map, ptile,
-                                 overview_x - gui_options.overview.width,
-                                 overview_y,
-                                 OVERVIEW_TILE_WIDTH, OVERVIEW_TILE_HEIGHT);
-        }
-      } else {
-        /* Clip half tile left and right.
-         * See comment in map_to_overview_pos(). */
-        overview_x -= OVERVIEW_TILE_SIZE;
+  canvas_put_rectangle(pcanvas, pcolor, overview_x, overview_y,
+                       count * OVERVIEW_TILE_WIDTH, OVERVIEW_TILE_HEIGHT);
+
+  if (key & OVERVIEW_KEY_FOG) {
+    struct sprite *fog = get_basic_fog_sprite(tileset);
+    int i;
+
+    for (i = 0; i < count; i++) {
+      canvas_put_sprite(pcanvas, overview_x + i * OVERVIEW_TILE_WIDTH,
+                        overview_y, fog, 0, 0,
+                        OVERVIEW_TILE_WIDTH, OVERVIEW_TILE_HEIGHT);
+    }
+    if (wrapped) {
+      canvas_put_sprite(pcanvas, wrap_x, overview_y, fog, 0, 0,
+                        OVERVIEW_TILE_WIDTH, OVERVIEW_TILE_HEIGHT);
+    }
+  }
+}
+
+/************************************************************************//**
+  Repaint the tiles whose color changed since the last repaint onto the
+  backing store. Each dirty row span is painted as a few rectangles, one
+  per run of tiles sharing the same color.
+****************************************************************************/
+static void overview_paint_dirty_tiles(void)
+{
+  int nat_y;
+  int tiles = 0, runs = 0;
+
+#ifdef DEBUG_TIMERS
+  struct timer *ptimer;
+#endif
+
+  if (overview_keys == NULL || gui_options.overview.map == NULL) {
+    return;
+  }
+
+#ifdef DEBUG_TIMERS
+  ptimer = timer_new(TIMER_USER, TIMER_DEBUG, "overview");
+  timer_start(ptimer);
+#endif
+
+  for (nat_y = 0; nat_y < overview_keys_height; nat_y++) {
+    int nat_x = overview_dirty_min[nat_y];
+    int last = overview_dirty_max[nat_y];
+    unsigned short *row = overview_keys + nat_y * overview_keys_width;
+    int i;
+
+    /* Tiles whose color was forgotten and not recalculated since. */
+    for (i = nat_x; i <= last; i++) {
+      if (row[i] == OVERVIEW_KEY_INVALID) {
+        row[i] = overview_tile_key(native_pos_to_tile(&(wld.map),
+                                                      i, nat_y));
       }
     }
 
-    put_overview_tile_area(gui_options.overview.map, ptile,
-                           overview_x, overview_y,
-                           OVERVIEW_TILE_WIDTH, OVERVIEW_TILE_HEIGHT);
+    while (nat_x <= last) {
+      unsigned short key = row[nat_x];
+      int count = 1;
 
-    dirty_overview();
-  } do_in_natural_pos_end;
+      while (nat_x + count <= last && row[nat_x + count] == key) {
+        count++;
+      }
+
+      put_overview_run(nat_x, nat_y, count, key);
+      tiles += count;
+      runs++;
+      nat_x += count;
+    }
+
+    overview_dirty_min[nat_y] = overview_keys_width;
+    overview_dirty_max[nat_y] = -1;
+  }
+
+#ifdef DEBUG_TIMERS
+  timer_stop(ptimer);
+  if (tiles > 0) {
+    log_debug("Overview: repainted %d tiles in %d runs in %.3f ms.",
+              tiles, runs, 1000.0 * timer_read_seconds(ptimer));
+  }
+  timer_destroy(ptimer);
+#else  /* DEBUG_TIMERS */
+  (void) tiles;
+  (void) runs;
+#endif /* DEBUG_TIMERS */
+}
+
+/************************************************************************//**
+  Update the given map position in the overview canvas. The tile is only
+  marked for repainting if its color changed.
+****************************************************************************/
+void overview_update_tile(struct tile *ptile)
+{
+  int nat_x, nat_y;
+  int tindex = tile_index(ptile);
+  unsigned short key;
+
+  if (overview_keys == NULL) {
+    return;
+  }
+
+  key = overview_tile_key(ptile);
+  if (overview_keys[tindex] == key) {
+    return;
+  }
+  overview_keys[tindex] = key;
+
+  index_to_native_pos(&nat_x, &nat_y, tindex);
+  overview_dirty_min[nat_y] = MIN(overview_dirty_min[nat_y], nat_x);
+  overview_dirty_max[nat_y] = MAX(overview_dirty_max[nat_y], nat_x);
+
+  dirty_overview();
+}
+
+/************************************************************************//**
+  (Re)allocate the tile color cache for the current map size. The cache
+  is set to match a backing store filled with the unknown color.
+****************************************************************************/
+static void overview_keys_alloc(void)
+{
+  int i;
+
+  free(overview_keys);
+  free(overview_dirty_min);
+  free(overview_dirty_max);
+
+  overview_keys_width = MAP_NATIVE_WIDTH;
+  overview_keys_height = MAP_NATIVE_HEIGHT;
+  overview_keys = fc_malloc(overview_keys_width * overview_keys_height
+                            * sizeof(*overview_keys));
+  overview_dirty_min = fc_malloc(overview_keys_height
+                                 * sizeof(*overview_dirty_min));
+  overview_dirty_max = fc_malloc(overview_keys_height
+                                 * sizeof(*overview_dirty_max));
+
+  for (i = 0; i < overview_keys_width * overview_keys_height; i++) {
+    overview_keys[i] = COLOR_OVERVIEW_UNKNOWN;
+  }
+  for (i = 0; i < overview_keys_height; i++) {
+    overview_dirty_min[i] = overview_keys_width;
+    overview_dirty_max[i] = -1;
+  }
+}
+
+/************************************************************************//**
+  Free the tile color cache.
+****************************************************************************/
+static void overview_keys_free(void)
+{
+  free(overview_keys);
+  free(overview_dirty_min);
+  free(overview_dirty_max);
+  overview_keys = NULL;
+  overview_dirty_min = NULL;
+  overview_dirty_max = NULL;
+  overview_keys_width = 0;
+  overview_keys_height = 0;
 }
 
 /************************************************************************//**
@@ -493,6 +718,7 @@ void calculate_overview_dimensions(void)
                        get_color(tileset, COLOR_OVERVIEW_UNKNOWN),
                        0, 0,
                        gui_options.overview.width, gui_options.overview.height);
+  overview_keys_alloc();
   update_map_canvas_scrollbars_size();
 
   /* Call gui specific function. */
@@ -516,6 +742,7 @@ void overview_free(void)
     gui_options.overview.map = NULL;
     gui_options.overview.window = NULL;
   }
+  overview_keys_free();
 }
 
 /************************************************************************//**
@@ -2503,6 +2503,7 @@ void handle_player_info(const struct packet_player_info *pinfo)
     rgbcolor_destroy(prgbcolor);
 
     /* Queue a map update -- may need to redraw borders, etc. */
+    overview_colors_changed();
     update_map_canvas_visible();
   }
   pplayer->client.color_changeable = pinfo->color_changeable;
@@ -3691,6 +3692,9 @@ void handle_rulesets_ready(void)
   /* Setup improvement feature caches */
   improvement_feature_cache_init();
 
+  /* Setup tech requirement closures */
+  techs_precalc_reqs();
+
   /* Setup road integrators caches */
   road_integrators_cache_init();
 
@@ -74,6 +74,7 @@
 #include "gui_properties.h"
 #include "helpdata.h"
 #include "options.h"            /* For fill_xxx */
+#include "overview_common.h"    /* For overview_colors_changed() */
 #include "svgflag.h"
 #include "themes_common.h"
 
@@ -1538,6 +1539,7 @@ bool tilespec_reread(const char *new_tileset_name,
    */
   generate_citydlg_dimensions();
   tileset_changed();
+  overview_colors_changed();
   can_slide = FALSE;
   center_tile_mapcanvas(center_tile);
   /* update_map_canvas_visible forces a full redraw. Otherwise with fast
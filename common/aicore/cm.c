@@ -2125,6 +2125,7 @@ void cm_query_result(struct city *pcity,
                      const struct cm_parameter *param,
                      struct cm_result *result, bool negative_ok)
 {
+  PROF_ZONE_BEGIN(prof_start);
   struct cm_state *state = cm_state_init(pcity, negative_ok);
   const struct civ_map *nmap = &(wld.map);
 
@@ -2135,6 +2136,8 @@ void cm_query_result(struct city *pcity,
 
   cm_find_best_solution(state, param, result, negative_ok);
   cm_state_free(state);
+
+  PROF_ZONE_END(prof_start, "cm_query");
 }
 
 /************************************************************************//**
@@ -20,6 +20,7 @@
 #include "log.h"
 #include "mem.h"
 #include "support.h"
+#include "timing.h"
 
 /* common */
 #include "game.h"
@@ -3183,6 +3184,9 @@ static struct pf_map *pf_fuel_map_new(const struct pf_parameter *parameter)
 ****************************************************************************/
 struct pf_map *pf_map_new(const struct pf_parameter *parameter)
 {
+  struct pf_map *pfm;
+  PROF_ZONE_BEGIN(prof_start);
+
   if (parameter->is_pos_dangerous) {
     if (parameter->get_moves_left_req) {
       log_error("path finding code cannot deal with dangers "
@@ -3191,15 +3195,19 @@ struct pf_map *pf_map_new(const struct pf_parameter *parameter)
     if (parameter->get_costs) {
       log_error("jumbo callbacks for danger maps are not yet implemented.");
     }
-    return pf_danger_map_new(parameter);
+    pfm = pf_danger_map_new(parameter);
   } else if (parameter->get_moves_left_req) {
     if (parameter->get_costs) {
       log_error("jumbo callbacks for fuel maps are not yet implemented.");
     }
-    return pf_fuel_map_new(parameter);
+    pfm = pf_fuel_map_new(parameter);
+  } else {
+    pfm = pf_normal_map_new(parameter);
   }
 
-  return pf_normal_map_new(parameter);
+  PROF_ZONE_END(prof_start, "pf_map_new");
+
+  return pfm;
 }
 
 /************************************************************************//**
@@ -3220,11 +3228,18 @@ void pf_map_destroy(struct pf_map *pfm)
 ****************************************************************************/
 int pf_map_move_cost(struct pf_map *pfm, struct tile *ptile)
 {
+  int cost;
+  PROF_ZONE_BEGIN(prof_start);
+
 #ifdef PF_DEBUG
   fc_assert_ret_val(pfm != nullptr, PF_IMPOSSIBLE_MC);
   fc_assert_ret_val(ptile != nullptr, PF_IMPOSSIBLE_MC);
 #endif
-  return pfm->get_move_cost(pfm, ptile);
+  cost = pfm->get_move_cost(pfm, ptile);
+
+  PROF_ZONE_END(prof_start, "pf_map_search");
+
+  return cost;
 }
 
 /************************************************************************//**
@@ -3236,13 +3251,17 @@ int pf_map_move_cost(struct pf_map *pfm, struct tile *ptile)
 ****************************************************************************/
 struct pf_path *pf_map_path(struct pf_map *pfm, struct tile *ptile)
 {
-#ifdef PF_DEBUG
   struct pf_path *path;
+  PROF_ZONE_BEGIN(prof_start);
 
+#ifdef PF_DEBUG
   fc_assert_ret_val(pfm != nullptr, nullptr);
   fc_assert_ret_val(ptile != nullptr, nullptr);
+#endif
   path = pfm->get_path(pfm, ptile);
 
+#ifdef PF_DEBUG
+
   if (path != nullptr) {
 #ifndef FREECIV_NDEBUG
     const struct pf_parameter *param = pf_map_parameter(pfm);
@@ -3254,11 +3273,11 @@ struct pf_path *pf_map_path(struct pf_map *pfm, struct tile *ptile)
     fc_assert(pos->fuel_left == param->fuel_left_initially);
 #endif /* FREECIV_NDEBUG */
   }
+#endif /* PF_DEBUG */
+
+  PROF_ZONE_END(prof_start, "pf_map_search");
 
   return path;
-#else
-  return pfm->get_path(pfm, ptile);
-#endif
 }
 
 /************************************************************************//**
@@ -3269,11 +3288,18 @@ struct pf_path *pf_map_path(struct pf_map *pfm, struct tile *ptile)
 bool pf_map_position(struct pf_map *pfm, struct tile *ptile,
                      struct pf_position *pos)
 {
+  bool found;
+  PROF_ZONE_BEGIN(prof_start);
+
 #ifdef PF_DEBUG
   fc_assert_ret_val(pfm != nullptr, FALSE);
   fc_assert_ret_val(ptile != nullptr, FALSE);
 #endif
-  return pfm->get_position(pfm, ptile, pos);
+  found = pfm->get_position(pfm, ptile, pos);
+
+  PROF_ZONE_END(prof_start, "pf_map_search");
+
+  return found;
 }
 
 /************************************************************************//**
@@ -3299,7 +3325,12 @@ bool pf_map_iterate(struct pf_map *pfm)
     return FALSE;
   }
 
-  if (!pfm->iterate(pfm)) {
+  PROF_ZONE_BEGIN(prof_start);
+  bool more = pfm->iterate(pfm);
+
+  PROF_ZONE_END(prof_start, "pf_map_iterate");
+
+  if (!more) {
     /* End of iteration. */
     pfm->tile = nullptr;
     return FALSE;
@@ -548,6 +548,7 @@ void generate_city_map_indices(void)
         city_map_index_tmp[city_count_tiles].dx = dx;
         city_map_index_tmp[city_count_tiles].dy = dy;
         city_map_index_tmp[city_count_tiles].dist = dist;
+        city_map_index_tmp[city_count_tiles].sq_dist = dist;
 
         for (i = CITY_MAP_MAX_RADIUS_SQ; i >= 0; i--) {
           if (dist <= i) {
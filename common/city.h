@@ -106,6 +106,7 @@ struct packet_city_rally_point;
 /* Iterate a city map, from the center (the city) outwards */
 struct iter_index {
   int dx, dy, dist;
+  int sq_dist;          /* See map_vector_to_sq_distance() */
 };
 
 /* City map coordinates are positive integers shifted by the maximum
@@ -447,6 +448,15 @@ struct city {
       /* the city map is synced with the client. */
       bool synced;
 
+      /* City info has been sent to the clients at least once. */
+      bool info_sent;
+
+      /* City info is waiting to be sent once city info sending is thawed,
+       * to everyone if info_broadcast is set, to the owner if not.
+       * Set inside send_city_info(). */
+      bool info_pending;
+      bool info_broadcast;
+
       bool debug;                   /* not saved */
 
       struct adv_city *adv;
@@ -33,6 +33,7 @@ static struct extra_type extras[MAX_EXTRA_TYPES];
 static struct user_flag user_extra_flags[MAX_NUM_USER_EXTRA_FLAGS];
 
 static struct extra_type_list *caused_by[EC_LAST];
+static bv_extras caused_by_mask[EC_LAST];
 static struct extra_type_list *removed_by[ERM_COUNT];
 static struct extra_type_list *cleanable;
 static struct extra_type_list *unit_hidden;
@@ -48,6 +49,7 @@ void extras_init(void)
 
   for (i = 0; i < EC_LAST; i++) {
     caused_by[i] = extra_type_list_new();
+    BV_CLR_ALL(caused_by_mask[i]);
   }
   for (i = 0; i < ERM_COUNT; i++) {
     removed_by[i] = extra_type_list_new();
@@ -107,6 +109,7 @@ void extras_free(void)
   for (i = 0; i < EC_LAST; i++) {
     extra_type_list_destroy(caused_by[i]);
     caused_by[i] = nullptr;
+    BV_CLR_ALL(caused_by_mask[i]);
   }
 
   for (i = 0; i < ERM_COUNT; i++) {
@@ -253,6 +256,18 @@ struct extra_type_list *extra_type_list_by_cause(enum extra_cause cause)
   return caused_by[cause];
 }
 
+/************************************************************************//**
+  Returns bitvector of the extra types for given cause. Same information
+  as in extra_type_list_by_cause(), but can be tested against tile
+  extras a word at a time.
+****************************************************************************/
+const bv_extras *extra_type_mask_by_cause(enum extra_cause cause)
+{
+  fc_assert(cause < EC_LAST);
+
+  return &caused_by_mask[cause];
+}
+
 /************************************************************************//**
   Returns extra types that hide units.
 ****************************************************************************/
@@ -314,6 +329,7 @@ void extra_to_caused_by_list(struct extra_type *pextra, enum extra_cause cause)
   fc_assert(cause < EC_LAST);
 
   extra_type_list_append(caused_by[cause], pextra);
+  BV_SET(caused_by_mask[cause], extra_index(pextra));
 }
 
 /************************************************************************//**
@@ -688,12 +704,11 @@ bool is_native_tile_to_extra(const struct extra_type *pextra,
 bool extra_conflicting_on_tile(const struct extra_type *pextra,
                                const struct tile *ptile)
 {
-  extra_type_iterate(old_extra) {
-    if (tile_has_extra(ptile, old_extra)
-        && !can_extras_coexist(old_extra, pextra)) {
+  bv_iterate_set(ptile->extras, old_idx) {
+    if (!can_extras_coexist(extra_by_number(old_idx), pextra)) {
       return TRUE;
     }
-  } extra_type_iterate_end;
+  } bv_iterate_set_end;
 
   return FALSE;
 }
@@ -193,6 +193,7 @@ struct extra_type *extra_type_by_translated_name(const char *name);
 
 void extra_to_caused_by_list(struct extra_type *pextra, enum extra_cause cause);
 struct extra_type_list *extra_type_list_by_cause(enum extra_cause cause);
+const bv_extras *extra_type_mask_by_cause(enum extra_cause cause);
 struct extra_type *rand_extra_for_tile(struct tile *ptile, enum extra_cause cause,
                                        bool generated);
 
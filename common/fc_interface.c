@@ -18,6 +18,7 @@
 /* utility */
 #include "astring.h"
 #include "fciconv.h"
+#include "genlist.h"
 #include "netfile.h"
 #include "shared.h"
 
@@ -76,6 +77,7 @@ void libfreeciv_init(bool check_fc_interface)
 {
   fc_astr_init();
   fc_support_init();
+  genlist_pool_init();
   init_nls();
   requirements_init();
 
@@ -112,6 +114,7 @@ void libfreeciv_free(void)
   requirements_free();
   free_nls();
   fc_iconv_close();
+  genlist_pool_free();
   fc_support_free();
   fc_astr_free();
 }
@@ -429,6 +429,7 @@ static void game_defaults(bool keep_ruleset_value)
     game.server.timeoutintinc     = GAME_DEFAULT_TIMEOUTINTINC;
     game.server.turnblock         = GAME_DEFAULT_TURNBLOCK;
     game.server.unitwaittime      = GAME_DEFAULT_UNITWAITTIME;
+    game.server.worker_planner    = GAME_DEFAULT_WORKER_PLANNER;
     game.server.plr_colors        = nullptr;
     game.server.random_move_time  = nullptr;
     game.server.world_peace_start = 0;
@@ -69,6 +69,11 @@ enum scorelog_level {
   SL_HUMANS
 };
 
+enum worker_planner {
+  WP_GREEDY = 0,
+  WP_BATCHED
+};
+
 struct user_flag
 {
   char *name;
@@ -205,6 +210,7 @@ struct civ_game {
       int unitwaittime;   /* Minimal time between two movements of a unit */
       int upgrade_veteran_loss;
       bool vision_reveal_tiles;
+      enum worker_planner worker_planner;
 
       bool debug[DEBUG_LAST];
       int timeoutint;     /* Increase timeout every N turns... */
@@ -516,6 +522,8 @@ static inline bool is_ruleset_compat_mode(void)
 
 #define GAME_DEFAULT_TRAIT_DIST_MODE TDM_FIXED
 
+#define GAME_DEFAULT_WORKER_PLANNER  WP_GREEDY
+
 #define GAME_DEFAULT_SAVEPALACE      TRUE
 
 #define GAME_DEFAULT_HOMECAUGHTUNITS TRUE
@@ -2977,6 +2977,7 @@ struct genhash **hash = pc->phs.sent + {self.type};
 if (nullptr == *hash) {{
   *hash = genhash_new_full(hash_{self.name}, cmp_{self.name},
                            nullptr, nullptr, nullptr, destroy_{self.packet_name});
+  genhash_set_open_addressing(*hash, TRUE);
 }}
 BV_CLR_ALL(fields);
 
@@ -3140,6 +3141,7 @@ struct genhash **hash = pc->phs.received + {self.type};
 if (nullptr == *hash) {{
   *hash = genhash_new_full(hash_{self.name}, cmp_{self.name},
                            nullptr, nullptr, nullptr, destroy_{self.packet_name});
+  genhash_set_open_addressing(*hash, TRUE);
 }}
 
 if (genhash_lookup(*hash, real_packet, (void **) &old)) {{
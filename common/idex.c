@@ -46,6 +46,10 @@ void idex_init(struct world *iworld)
 {
   iworld->cities = city_hash_new();
   iworld->units = unit_hash_new();
+
+  /* Looked up for every unit and city id in the packets. */
+  city_hash_set_open_addressing(iworld->cities, TRUE);
+  unit_hash_set_open_addressing(iworld->units, TRUE);
 }
 
 /**********************************************************************//**
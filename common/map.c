@@ -284,6 +284,8 @@ static void generate_map_indices(void)
       wld.map.iterate_outwards_indices[i].dy = dy;
       wld.map.iterate_outwards_indices[i].dist =
           map_vector_to_real_distance(dx, dy);
+      wld.map.iterate_outwards_indices[i].sq_dist =
+          map_vector_to_sq_distance(dx, dy);
       i++;
     }
   }
@@ -411,7 +411,8 @@ extern struct terrain_misc terrain_control;
   circle_dxyr_iterate_end
 
 /* dx, dy, dr are distance from center to tile in x, y and square distance;
- * do not rely on x, y distance, since they do not work for hex topologies. */
+ * do not rely on x, y distance, since they do not work for hex topologies.
+ * The square distance comes precomputed with the outwards indices. */
 #define circle_dxyr_iterate(nmap, center_tile, sq_radius,                   \
                             _tile, dx, dy, dr)                              \
 {                                                                           \
@@ -419,7 +420,7 @@ extern struct terrain_misc terrain_control;
   const int _tile##_cr_radius = (int)sqrt((double)MAX(_tile##_sq_radius, 0)); \
                                                                             \
   square_dxy_iterate(nmap, center_tile, _tile##_cr_radius, _tile, dx, dy) { \
-    const int dr = map_vector_to_sq_distance(dx, dy);                       \
+    const int dr = MAP_ITERATE_OUTWARDS_INDICES[_tile##_index].sq_dist;     \
                                                                             \
     if (dr <= _tile##_sq_radius) {
 
@@ -217,6 +217,10 @@ struct connection {
       enum auth_status status;
       char password[MAX_LEN_PASSWORD];
 
+      /* An fcdb call for this connection is queued to the authentication
+       * worker; the connection stays in its status until it is done. */
+      bool auth_pending;
+
       /* For reverse lookup and blacklisting in db */
       char ipaddr[MAX_LEN_ADDR];
 
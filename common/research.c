@@ -373,125 +373,105 @@ research_allowed(const struct research *presearch,
   Returns TRUE iff researching the given tech may become allowed according
   to its research_reqs.
 
-  Helper for research_get_reachable_rreqs().
+  Helper for research_get_blocked().
 ****************************************************************************/
 #define research_may_become_allowed(presearch, tech)                      \
   research_allowed(presearch, tech, reqs_may_activate)
 
 /************************************************************************//**
-  Returns TRUE iff the given tech is ever reachable by the players sharing
-  the research as far as research_reqs are concerned.
+  Sets 'blocked' to the techs that are never reachable by the players
+  sharing the research as far as research_reqs are concerned: the unknown
+  techs which can never be allowed or have an invalid requirement, and the
+  unknown techs requiring such a tech via other unknown techs.
 
-  Helper for research_get_reachable().
+  Helper for research_update().
 ****************************************************************************/
-static bool research_get_reachable_rreqs(const struct research *presearch,
-                                         Tech_type_id tech)
+static void research_get_blocked(const struct research *presearch,
+                                 const bv_techs *known, bv_techs *blocked)
 {
-  bv_techs done;
-  Tech_type_id techs[game.control.num_tech_types];
-  enum tech_req req;
-  int techs_num;
-  int i;
+  Tech_type_id ac = advance_count();
+  bool changed;
 
-  techs[0] = tech;
-  BV_CLR_ALL(done);
-  BV_SET(done, A_NONE);
-  BV_SET(done, tech);
-  techs_num = 1;
+  BV_CLR_ALL(*blocked);
 
-  /* Check that all recursive requirements have their research_reqs
-   * in order. */
-  for (i = 0; i < techs_num; i++) {
-    if (presearch->inventions[techs[i]].state == TECH_KNOWN) {
+  advance_index_iterate_max(A_FIRST, i, ac) {
+    enum tech_req req;
+
+    if (BV_ISSET(*known, i) || valid_advance_by_number(i) == nullptr) {
       /* This tech is already reached. What is required to research it and
        * the techs it depends on is therefore irrelevant. */
       continue;
     }
 
-    if (!research_may_become_allowed(presearch, techs[i])) {
+    if (!research_may_become_allowed(presearch, i)) {
       /* It will always be illegal to start researching this tech because
        * of unchanging requirements. Since it isn't already known and can't
        * be researched it must be unreachable. */
-      return FALSE;
+      BV_SET(*blocked, i);
+      continue;
     }
 
-    /* Check if required techs are research_reqs reachable. */
     for (req = 0; req < AR_SIZE; req++) {
-      Tech_type_id req_tech = advance_required(techs[i], req);
-
-      if (valid_advance_by_number(req_tech) == nullptr) {
-        return FALSE;
-      } else if (!BV_ISSET(done, req_tech)) {
-        fc_assert(techs_num < ARRAY_SIZE(techs));
-        techs[techs_num] = req_tech;
-        techs_num++;
-
-        BV_SET(done, req_tech);
+      if (valid_advance_by_number(advance_required(i, req)) == nullptr) {
+        BV_SET(*blocked, i);
+        break;
       }
     }
-  }
+  } advance_index_iterate_max_end;
 
-  return TRUE;
-}
+  /* Propagate to the unknown techs requiring blocked ones. */
+  do {
+    changed = FALSE;
 
-/************************************************************************//**
-  Returns TRUE iff the given tech is ever reachable by the players sharing
-  the research by checking tech tree limitations.
+    advance_index_iterate_max(A_FIRST, i, ac) {
+      enum tech_req req;
 
-  Helper for research_update().
-****************************************************************************/
-static bool research_get_reachable(const struct research *presearch,
-                                   Tech_type_id tech)
-{
-  if (valid_advance_by_number(tech) == nullptr) {
-    return FALSE;
-  } else {
-    advance_root_req_iterate(advance_by_number(tech), proot) {
-      if (advance_requires(proot, AR_ROOT) == proot) {
-        /* This tech requires itself; it can only be reached by special
-         * means (init_techs, lua script, ...).
-         * If you already know it, you can "reach" it; if not, not. (This
-         * case is needed for descendants of this tech.) */
-        if (presearch->inventions[advance_number(proot)].state != TECH_KNOWN) {
-          return FALSE;
-        }
-      } else {
-        enum tech_req req;
+      if (BV_ISSET(*blocked, i) || BV_ISSET(*known, i)
+          || valid_advance_by_number(i) == nullptr) {
+        continue;
+      }
 
-        for (req = 0; req < AR_SIZE; req++) {
-          if (valid_advance(advance_requires(proot, req)) == nullptr) {
-            return FALSE;
-          }
+      for (req = 0; req < AR_SIZE; req++) {
+        if (BV_ISSET(*blocked, advance_required(i, req))) {
+          BV_SET(*blocked, i);
+          changed = TRUE;
+          break;
         }
       }
-    } advance_root_req_iterate_end;
-  }
-
-  /* Check research reqs reachability. */
-  if (!research_get_reachable_rreqs(presearch, tech)) {
-    return FALSE;
-  }
-
-  return TRUE;
+    } advance_index_iterate_max_end;
+  } while (changed);
 }
 
 /************************************************************************//**
-  Returns TRUE iff the players sharing 'presearch' already have got the
-  knowledge of all root requirement technologies for 'tech' (without which
-  it's impossible to gain 'tech').
+  Returns TRUE iff the root requirements of the given tech don't make it
+  unreachable by the players sharing the research.
+
+  'self_roots' are the techs requiring themselves as root requirement,
+  and 'bad_roots' the other techs with an invalid requirement.
 
   Helper for research_update().
 ****************************************************************************/
-static bool research_get_root_reqs_known(const struct research *presearch,
-                                         Tech_type_id tech)
+static bool research_roots_reachable(Tech_type_id tech,
+                                     const bv_techs *known,
+                                     const bv_techs *self_roots,
+                                     const bv_techs *bad_roots)
 {
-  advance_root_req_iterate(advance_by_number(tech), proot) {
-    if (presearch->inventions[advance_number(proot)].state != TECH_KNOWN) {
-      return FALSE;
-    }
-  } advance_root_req_iterate_end;
+  const struct advance *padvance = valid_advance_by_number(tech);
+  bv_techs unknown_roots;
 
-  return TRUE;
+  if (padvance == nullptr
+      || BV_CHECK_MASK(padvance->root_reqs, *bad_roots)) {
+    return FALSE;
+  }
+
+  /* A tech requiring itself can only be reached by special means
+   * (init_techs, lua script, ...). If you already know it, you can
+   * "reach" it; if not, not. (This case is needed for descendants of
+   * this tech.) */
+  unknown_roots = padvance->root_reqs;
+  BV_CLR_ALL_FROM(unknown_roots, *known);
+
+  return !BV_CHECK_MASK(unknown_roots, *self_roots);
 }
 
 /************************************************************************//**
@@ -506,17 +486,69 @@ void research_update(struct research *presearch)
   enum tech_flag_id flag;
   int techs_researched;
   Tech_type_id ac = advance_count();
+  bv_techs known, self_roots, bad_roots, blocked;
+  int bulbs[A_ARRAY_SIZE];
+  bool changed;
+
+  BV_CLR_ALL(known);
+  BV_CLR_ALL(self_roots);
+  BV_CLR_ALL(bad_roots);
+  advance_index_iterate_max(A_NONE, i, ac) {
+    struct advance *padvance = advance_by_number(i);
+
+    if (presearch->inventions[i].state == TECH_KNOWN) {
+      BV_SET(known, i);
+    }
+
+    if (advance_requires(padvance, AR_ROOT) == padvance) {
+      BV_SET(self_roots, i);
+    } else {
+      enum tech_req req;
+
+      for (req = 0; req < AR_SIZE; req++) {
+        if (valid_advance(advance_requires(padvance, req)) == nullptr) {
+          BV_SET(bad_roots, i);
+          break;
+        }
+      }
+    }
+    bulbs[i] = -1;
+  } advance_index_iterate_max_end;
+
+  /* Known techs can be unreachable too, e.g. when a script gave a tech
+   * without its self-requiring root requirement. They are lost, which
+   * may in turn make more techs unreachable. */
+  do {
+    changed = FALSE;
+
+    advance_index_iterate_max(A_FIRST, i, ac) {
+      if (BV_ISSET(known, i)
+          && !research_roots_reachable(i, &known, &self_roots,
+                                       &bad_roots)) {
+        presearch->inventions[i].state = TECH_UNKNOWN;
+        BV_CLR(known, i);
+        changed = TRUE;
+      }
+    } advance_index_iterate_max_end;
+  } while (changed);
+
+  research_get_blocked(presearch, &known, &blocked);
 
   advance_index_iterate_max(A_FIRST, i, ac) {
     enum tech_state state = presearch->inventions[i].state;
-    bool root_reqs_known = TRUE;
-    bool reachable = research_get_reachable(presearch, i);
+    bv_techs unknown_roots;
+    bool root_reqs_known;
+    bool reachable = (!BV_ISSET(blocked, i)
+                      && research_roots_reachable(i, &known, &self_roots,
+                                                  &bad_roots));
 
     /* Finding if the root reqs of an unreachable tech isn't redundant.
      * A tech can be unreachable via research but have known root reqs
      * because of unfilfilled research_reqs. Unfulfilled research_reqs
      * doesn't prevent the player from acquiring the tech by other means. */
-    root_reqs_known = research_get_root_reqs_known(presearch, i);
+    unknown_roots = advance_by_number(i)->root_reqs;
+    BV_CLR_ALL_FROM(unknown_roots, known);
+    root_reqs_known = !BV_ISSET_ANY(unknown_roots);
 
     if (reachable) {
       if (state != TECH_KNOWN) {
@@ -532,7 +564,7 @@ void research_update(struct research *presearch)
     } else {
       /* We used to assert here that state already is TECH_UNKNOWN. However, there is
        * a special case where it can be e.g. TECH_PREREQS_KNOWN and still
-       * unreachable (like in above research_get_reachable() call) because
+       * unreachable (like in above research_get_blocked() call) because
        * player is dead. Dead player's don't research anything. More accurately
        * research_players_iterate() for a dead player's research iterates over
        * zero players in research_allowed(), so it falls through to default of FALSE.
@@ -553,11 +585,31 @@ void research_update(struct research *presearch)
       continue;
     }
 
+    if (game.info.tech_cost_style != TECH_COST_CIV1CIV2) {
+      /* The cost of a tech doesn't depend on the order the required
+       * techs get researched in, so it's the same for every goal. */
+      presearch->inventions[i].required_techs = advance_by_number(i)->all_reqs;
+      BV_CLR_ALL_FROM(presearch->inventions[i].required_techs, known);
+
+      advance_index_iterate_max(A_FIRST, j, ac) {
+        if (!BV_ISSET(presearch->inventions[i].required_techs, j)) {
+          continue;
+        }
+
+        if (bulbs[j] < 0) {
+          bulbs[j] = research_total_bulbs_required(presearch, j, FALSE);
+        }
+        presearch->inventions[i].num_required_techs++;
+        presearch->inventions[i].bulbs_required += bulbs[j];
+      } advance_index_iterate_max_end;
+      continue;
+    }
+
     techs_researched = presearch->techs_researched;
     advance_req_iterate(valid_advance_by_number(i), preq) {
       Tech_type_id j = advance_number(preq);
 
-      if (TECH_KNOWN == research_invention_state(presearch, j)) {
+      if (BV_ISSET(known, j)) {
         continue;
       }
 
@@ -581,6 +581,7 @@ int luascript_call(struct fc_lua *fcl, int narg, int nret,
   int status;
   int base;          /* Index of function to call */
   int traceback = 0; /* Index of traceback function  */
+  clock_t start = 0;
 
   fc_assert_ret_val(fcl, -1);
   fc_assert_ret_val(fcl->state, -1);
@@ -596,9 +597,15 @@ int luascript_call(struct fc_lua *fcl, int narg, int nret,
     lua_pop(fcl->state, 1);   /* pop non-function traceback */
   }
 
+  if (fcl->profiling) {
+    start = clock();
+  }
   luascript_hook_start(fcl->state);
   status = lua_pcall(fcl->state, narg, nret, traceback);
   luascript_hook_end(fcl->state);
+  if (fcl->profiling) {
+    fcl->call_clocks = clock() - start;
+  }
 
   if (status) {
     luascript_report(fcl, status, code);
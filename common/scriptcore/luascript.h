@@ -17,6 +17,8 @@
 extern "C" {
 #endif /* __cplusplus */
 
+#include <time.h>
+
 /* dependencies/tolua */
 #include "tolua.h"
 
@@ -35,6 +37,7 @@ struct luascript_signal_hash;
 struct luascript_signal_name_list;
 struct connection;
 struct fc_lua;
+struct signal;
 
 typedef void (*luascript_log_func_t) (struct fc_lua *fcl,
                                       enum log_level level,
@@ -52,6 +55,12 @@ struct fc_lua {
 
   struct luascript_signal_hash *signals;
   struct luascript_signal_name_list *signal_names;
+  struct signal **signal_handles;
+  int num_signals;
+
+  /* Callback profiling */
+  bool profiling;
+  clock_t call_clocks;      /* Time used by the latest luascript_call() */
 };
 
 /* Error functions for lua scripts. */
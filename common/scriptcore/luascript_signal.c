@@ -42,10 +42,13 @@
 #endif
 
 #include <stdarg.h>
+#include <stdlib.h>
+#include <time.h>
 
 /* utility */
 #include "deprecations.h"
 #include "log.h"
+#include "mem.h"
 
 /* common/scriptcore */
 #include "luascript.h"
@@ -73,6 +76,8 @@ static void signal_destroy(struct signal *psignal);
 
 /* Signal datastructure. */
 struct signal {
+  const char *name;                       /* Owned by fcl->signal_names */
+  int handle;                             /* Index in fcl->signal_handles */
   int nargs;                              /* Number of arguments to pass */
   enum api_types *arg_types;              /* Argument types */
   struct signal_callback_list *callbacks; /* Connected callbacks */
@@ -82,6 +87,8 @@ struct signal {
 /* Signal callback datastructure. */
 struct signal_callback {
   char *name;                             /* callback function name */
+  int calls;                              /* Profiling: number of calls */
+  clock_t clocks;                         /* Profiling: time used */
 };
 
 /*****************************************************************************
@@ -116,6 +123,9 @@ static struct signal_callback *signal_callback_new(const char *name)
   struct signal_callback *pcallback = fc_malloc(sizeof(*pcallback));
 
   pcallback->name = fc_strdup(name);
+  pcallback->calls = 0;
+  pcallback->clocks = 0;
+
   return pcallback;
 }
 
@@ -135,6 +145,8 @@ static struct signal *signal_new(int nargs, enum api_types *parg_types)
 {
   struct signal *psignal = fc_malloc(sizeof(*psignal));
 
+  psignal->name = nullptr;
+  psignal->handle = -1;
   psignal->nargs = nargs;
   psignal->arg_types = parg_types;
   psignal->callbacks
@@ -163,6 +175,33 @@ static void signal_destroy(struct signal *psignal)
   free(psignal);
 }
 
+/**********************************************************************//**
+  Invoke all the callback functions attached to a given signal.
+**************************************************************************/
+static void signal_emit(struct fc_lua *fcl, struct signal *psignal,
+                        va_list args)
+{
+  signal_callback_list_iterate(psignal->callbacks, pcallback) {
+    va_list args_cb;
+    bool stop;
+
+    va_copy(args_cb, args);
+    fcl->call_clocks = 0;
+    stop = luascript_callback_invoke(fcl, pcallback->name, psignal->nargs,
+                                     psignal->arg_types, args_cb);
+    va_end(args_cb);
+
+    if (fcl->profiling) {
+      pcallback->calls++;
+      pcallback->clocks += fcl->call_clocks;
+    }
+
+    if (stop) {
+      break;
+    }
+  } signal_callback_list_iterate_end;
+}
+
 /**********************************************************************//**
   Invoke all the callback functions attached to a given signal.
 **************************************************************************/
@@ -176,23 +215,70 @@ void luascript_signal_emit_valist(struct fc_lua *fcl,
   fc_assert_ret(fcl->signals);
 
   if (luascript_signal_hash_lookup(fcl->signals, signal_name, &psignal)) {
-    signal_callback_list_iterate(psignal->callbacks, pcallback) {
-      va_list args_cb;
-
-      va_copy(args_cb, args);
-      if (luascript_callback_invoke(fcl, pcallback->name, psignal->nargs,
-                                    psignal->arg_types, args_cb)) {
-        va_end(args_cb);
-        break;
-      }
-      va_end(args_cb);
-    } signal_callback_list_iterate_end;
+    if (signal_callback_list_size(psignal->callbacks) > 0) {
+      signal_emit(fcl, psignal, args);
+    }
   } else {
     luascript_log(fcl, LOG_ERROR, "Signal \"%s\" does not exist, so cannot "
                                   "be invoked.", signal_name);
   }
 }
 
+/**********************************************************************//**
+  Invoke all the callback functions attached to a given signal, looking
+  the signal up only when 'ref' doesn't already have it resolved.
+
+  Handles are given in the order the signals are created, so a resolved
+  'ref' stays valid for every instance that creates the same signals in
+  the same order. 'signal_name' is compared by address only, so it must
+  not be a reused buffer.
+**************************************************************************/
+void luascript_signal_emit_ref_valist(struct fc_lua *fcl,
+                                      struct signal_ref *ref,
+                                      const char *signal_name,
+                                      va_list args)
+{
+  struct signal *psignal;
+
+  fc_assert_ret(fcl);
+
+  if (ref->name != signal_name || ref->handle < 0) {
+    ref->handle = luascript_signal_handle(fcl, signal_name);
+    ref->name = signal_name;
+  }
+
+  if (ref->handle < 0) {
+    luascript_log(fcl, LOG_ERROR, "Signal \"%s\" does not exist, so cannot "
+                                  "be invoked.", signal_name);
+    return;
+  }
+
+  fc_assert_ret(ref->handle < fcl->num_signals);
+  psignal = fcl->signal_handles[ref->handle];
+  fc_assert(!strcmp(psignal->name, signal_name));
+
+  if (signal_callback_list_size(psignal->callbacks) > 0) {
+    signal_emit(fcl, psignal, args);
+  }
+}
+
+/**********************************************************************//**
+  Return the handle of the signal, or -1 if there's no such signal.
+**************************************************************************/
+int luascript_signal_handle(struct fc_lua *fcl, const char *signal_name)
+{
+  struct signal *psignal;
+
+  fc_assert_ret_val(fcl != nullptr, -1);
+  fc_assert_ret_val(fcl->signals != nullptr, -1);
+
+  if (luascript_signal_hash_lookup(fcl->signals, signal_name, &psignal)) {
+    return psignal->handle;
+  }
+
+  return -1;
+}
+
 /**********************************************************************//**
   Invoke all the callback functions attached to a given signal.
 **************************************************************************/
@@ -245,6 +331,13 @@ static struct signal *luascript_signal_create_valist(struct fc_lua *fcl,
     strcpy(sn, signal_name);
     luascript_signal_name_list_append(fcl->signal_names, sn);
 
+    created->name = sn;
+    created->handle = fcl->num_signals++;
+    fcl->signal_handles
+      = fc_realloc(fcl->signal_handles,
+                   fcl->num_signals * sizeof(*fcl->signal_handles));
+    fcl->signal_handles[created->handle] = created;
+
     return created;
   }
 }
@@ -421,6 +514,9 @@ void luascript_signal_free(struct fc_lua *fcl)
 
     luascript_signal_name_list_destroy(fcl->signal_names);
 
+    FC_FREE(fcl->signal_handles);
+    fcl->num_signals = 0;
+
     fcl->signals = nullptr;
   }
 }
@@ -459,3 +555,85 @@ const char *luascript_signal_callback_by_index(struct fc_lua *fcl,
 
   return nullptr;
 }
+
+/**********************************************************************//**
+  Turn callback profiling on or off. Turning it on clears the counts
+  collected so far.
+**************************************************************************/
+void luascript_signal_profile_set(struct fc_lua *fcl, bool enable)
+{
+  int i;
+
+  fc_assert_ret(fcl != nullptr);
+
+  if (enable) {
+    for (i = 0; i < fcl->num_signals; i++) {
+      signal_callback_list_iterate(fcl->signal_handles[i]->callbacks,
+                                   pcallback) {
+        pcallback->calls = 0;
+        pcallback->clocks = 0;
+      } signal_callback_list_iterate_end;
+    }
+  }
+
+  fcl->profiling = enable;
+}
+
+/**********************************************************************//**
+  Compare two profile entries, the slowest first.
+**************************************************************************/
+static int signal_profile_cmp(const void *a, const void *b)
+{
+  const struct signal_profile *pa = a;
+  const struct signal_profile *pb = b;
+
+  if (pa->seconds != pb->seconds) {
+    return (pa->seconds < pb->seconds ? 1 : -1);
+  }
+
+  return pb->calls - pa->calls;
+}
+
+/**********************************************************************//**
+  Return the profile of every callback called while profiling was on,
+  the slowest first. The number of entries is stored in 'count'.
+  The caller must free the returned array.
+**************************************************************************/
+struct signal_profile *luascript_signal_profile_get(struct fc_lua *fcl,
+                                                    int *count)
+{
+  struct signal_profile *profile;
+  int num = 0;
+  int i;
+
+  *count = 0;
+  fc_assert_ret_val(fcl != nullptr, nullptr);
+
+  for (i = 0; i < fcl->num_signals; i++) {
+    num += signal_callback_list_size(fcl->signal_handles[i]->callbacks);
+  }
+  if (num == 0) {
+    return nullptr;
+  }
+
+  profile = fc_malloc(num * sizeof(*profile));
+  num = 0;
+  for (i = 0; i < fcl->num_signals; i++) {
+    struct signal *psignal = fcl->signal_handles[i];
+
+    signal_callback_list_iterate(psignal->callbacks, pcallback) {
+      if (pcallback->calls > 0) {
+        profile[num].signal_name = psignal->name;
+        profile[num].callback_name = pcallback->name;
+        profile[num].calls = pcallback->calls;
+        profile[num].seconds = (double) pcallback->clocks / CLOCKS_PER_SEC;
+        num++;
+      }
+    } signal_callback_list_iterate_end;
+  }
+
+  qsort(profile, num, sizeof(*profile), signal_profile_cmp);
+  *count = num;
+
+  return profile;
+}
@@ -27,12 +27,33 @@ struct signal_deprecator {
   char *retired;                        /* Signal no longer available in current freeciv */
 };
 
+/* Caches the handle of a signal for an emission site. */
+struct signal_ref {
+  const char *name;
+  int handle;
+};
+
+#define SIGNAL_REF_INIT { nullptr, -1 }
+
+/* Time used by one signal callback. */
+struct signal_profile {
+  const char *signal_name;
+  const char *callback_name;
+  int calls;
+  double seconds;
+};
+
 void luascript_signal_init(struct fc_lua *fcl);
 void luascript_signal_free(struct fc_lua *fcl);
 
 void luascript_signal_emit_valist(struct fc_lua *fcl,
                                   const char *signal_name, va_list args);
 void luascript_signal_emit(struct fc_lua *fcl, const char *signal_name, ...);
+void luascript_signal_emit_ref_valist(struct fc_lua *fcl,
+                                      struct signal_ref *ref,
+                                      const char *signal_name,
+                                      va_list args);
+int luascript_signal_handle(struct fc_lua *fcl, const char *signal_name);
 struct signal_deprecator *luascript_signal_create(struct fc_lua *fcl,
                                                   const char *signal_name,
                                                   int nargs, ...);
@@ -45,6 +66,10 @@ bool luascript_signal_callback_defined(struct fc_lua *fcl,
                                        const char *signal_name,
                                        const char *callback_name);
 
+void luascript_signal_profile_set(struct fc_lua *fcl, bool enable);
+struct signal_profile *luascript_signal_profile_get(struct fc_lua *fcl,
+                                                    int *count);
+
 const char *luascript_signal_by_index(struct fc_lua *fcl, int sindex);
 const char *luascript_signal_callback_by_index(struct fc_lua *fcl,
                                                const char *signal_name,
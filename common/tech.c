@@ -232,14 +232,17 @@ void techs_precalc_data(void)
   fc_assert_msg(tech_cost_style_is_valid(game.info.tech_cost_style),
                 "Invalid tech_cost_style %d", game.info.tech_cost_style);
 
+  techs_precalc_reqs();
+
   advance_iterate(padvance) {
     int num_reqs = 0;
     bool min_req = TRUE;
 
-    advance_req_iterate(padvance, preq) {
-      (void) preq; /* Compiler wants us to do something with 'preq'. */
-      num_reqs++;
-    } advance_req_iterate_end;
+    advance_index_iterate(A_NONE, i) {
+      if (BV_ISSET(padvance->all_reqs, i)) {
+        num_reqs++;
+      }
+    } advance_index_iterate_end;
     padvance->num_reqs = num_reqs;
 
     switch (game.info.tech_cost_style) {
@@ -280,6 +283,30 @@ void techs_precalc_data(void)
   } advance_iterate_end;
 }
 
+/**********************************************************************//**
+  Precalculate the requirement closures of the technologies, so that
+  research_update() can check them as bitvectors instead of walking the
+  requirement chains.
+**************************************************************************/
+void techs_precalc_reqs(void)
+{
+  advance_iterate_all(padvance) {
+    BV_CLR_ALL(padvance->all_reqs);
+    BV_CLR_ALL(padvance->root_reqs);
+
+    advance_req_iterate(padvance, preq) {
+      BV_SET(padvance->all_reqs, advance_number(preq));
+    } advance_req_iterate_end;
+
+    advance_root_req_iterate(padvance, proot) {
+      /* A_NONE has A_NEVER as its root_req on the client. */
+      if (proot != A_NEVER) {
+        BV_SET(padvance->root_reqs, advance_number(proot));
+      }
+    } advance_root_req_iterate_end;
+  } advance_iterate_all_end;
+}
+
 /**********************************************************************//**
   Is the given tech a future tech.
 **************************************************************************/
@@ -118,6 +118,8 @@ struct tech_class {
   int cost_pct;
 };
 
+BV_DEFINE(bv_techs, A_ARRAY_SIZE);
+
 struct advance {
   Tech_type_id item_number;
   struct name_translation name;
@@ -151,9 +153,12 @@ struct advance {
    * itself. Precalculated at server then send to client.
    */
   int num_reqs;
-};
 
-BV_DEFINE(bv_techs, A_ARRAY_SIZE);
+  /* Techs advance_req_iterate() and advance_root_req_iterate() visit.
+   * Calculated by techs_precalc_reqs(), on both server and client. */
+  bv_techs all_reqs;
+  bv_techs root_reqs;
+};
 
 /* General advance/technology accessor functions. */
 Tech_type_id advance_count_real(void);
@@ -234,6 +239,7 @@ void techs_init(void);
 void techs_free(void);
 
 void techs_precalc_data(void);
+void techs_precalc_reqs(void);
 
 /* Iteration */
 
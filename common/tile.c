@@ -273,15 +273,15 @@ int tile_roads_output_incr(const struct tile *ptile, enum output_type_id o)
 {
   int const_incr = 0;
   int incr = 0;
+  bv_extras roads = ptile->extras;
 
-  extra_type_by_cause_iterate(EC_ROAD, pextra) {
-    if (tile_has_extra(ptile, pextra)) {
-      struct road_type *proad = extra_road_get(pextra);
+  BV_KEEP_ALL_FROM(roads, *extra_type_mask_by_cause(EC_ROAD));
+  bv_iterate_set(roads, idx) {
+    struct road_type *proad = extra_road_get(extra_by_number(idx));
 
-      const_incr += proad->tile_incr_const[o];
-      incr += proad->tile_incr[o];
-    }
-  } extra_type_by_cause_iterate_end;
+    const_incr += proad->tile_incr_const[o];
+    incr += proad->tile_incr[o];
+  } bv_iterate_set_end;
 
   return const_incr + incr * tile_terrain(ptile)->road_output_incr_pct[o] / 100;
 }
@@ -292,14 +292,12 @@ int tile_roads_output_incr(const struct tile *ptile, enum output_type_id o)
 int tile_roads_output_bonus(const struct tile *ptile, enum output_type_id o)
 {
   int bonus = 0;
+  bv_extras roads = ptile->extras;
 
-  extra_type_by_cause_iterate(EC_ROAD, pextra) {
-    if (tile_has_extra(ptile, pextra)) {
-      struct road_type *proad = extra_road_get(pextra);
-
-      bonus += proad->tile_bonus[o];
-    }
-  } extra_type_by_cause_iterate_end;
+  BV_KEEP_ALL_FROM(roads, *extra_type_mask_by_cause(EC_ROAD));
+  bv_iterate_set(roads, idx) {
+    bonus += extra_road_get(extra_by_number(idx))->tile_bonus[o];
+  } bv_iterate_set_end;
 
   return bonus;
 }
@@ -852,15 +850,7 @@ bool tile_has_road(const struct tile *ptile, const struct road_type *proad)
 ****************************************************************************/
 bool tile_has_river(const struct tile *ptile)
 {
-  /* TODO: Have a list of rivers and iterate only that */
-  extra_type_by_cause_iterate(EC_ROAD, priver) {
-    if (tile_has_extra(ptile, priver)
-        && road_has_flag(extra_road_get(priver), RF_RIVER)) {
-      return TRUE;
-    }
-  } extra_type_by_cause_iterate_end;
-
-  return FALSE;
+  return tile_has_road_flag(ptile, RF_RIVER);
 }
 
 /************************************************************************//**
@@ -868,15 +858,14 @@ bool tile_has_river(const struct tile *ptile)
 ****************************************************************************/
 bool tile_has_road_flag(const struct tile *ptile, enum road_flag_id flag)
 {
-  extra_type_by_cause_iterate(EC_ROAD, pextra) {
-    if (tile_has_extra(ptile, pextra)) {
-      struct road_type *proad = extra_road_get(pextra);
+  bv_extras roads = ptile->extras;
 
-      if (road_has_flag(proad, flag)) {
-        return TRUE;
-      }
+  BV_KEEP_ALL_FROM(roads, *extra_type_mask_by_cause(EC_ROAD));
+  bv_iterate_set(roads, idx) {
+    if (road_has_flag(extra_road_get(extra_by_number(idx)), flag)) {
+      return TRUE;
     }
-  } extra_type_by_cause_iterate_end;
+  } bv_iterate_set_end;
 
   return FALSE;
 }
@@ -886,12 +875,11 @@ bool tile_has_road_flag(const struct tile *ptile, enum road_flag_id flag)
 ****************************************************************************/
 bool tile_has_extra_flag(const struct tile *ptile, enum extra_flag_id flag)
 {
-  extra_type_iterate(pextra) {
-    if (tile_has_extra(ptile, pextra)
-        && extra_has_flag(pextra, flag)) {
+  bv_iterate_set(ptile->extras, idx) {
+    if (extra_has_flag(extra_by_number(idx), flag)) {
       return TRUE;
     }
-  } extra_type_iterate_end;
+  } bv_iterate_set_end;
 
   return FALSE;
 }
@@ -902,14 +890,7 @@ bool tile_has_extra_flag(const struct tile *ptile, enum extra_flag_id flag)
 bool tile_has_conflicting_extra(const struct tile *ptile,
                                 const struct extra_type *pextra)
 {
-  extra_type_iterate(pconfl) {
-    if (BV_ISSET(pextra->conflicts, extra_index(pconfl))
-        && tile_has_extra(ptile, pconfl)) {
-      return TRUE;
-    }
-  } extra_type_iterate_end;
-
-  return FALSE;
+  return BV_CHECK_MASK(pextra->conflicts, ptile->extras);
 }
 
 /************************************************************************//**
@@ -917,23 +898,11 @@ bool tile_has_conflicting_extra(const struct tile *ptile,
 ****************************************************************************/
 bool tile_has_visible_extra(const struct tile *ptile, const struct extra_type *pextra)
 {
-  bool hidden = FALSE;
-
   if (!BV_ISSET(ptile->extras, extra_index(pextra))) {
     return FALSE;
   }
 
-  extra_type_iterate(top) {
-    int topi = extra_index(top);
-
-    if (BV_ISSET(pextra->hidden_by, topi)
-        && BV_ISSET(ptile->extras, topi)) {
-      hidden = TRUE;
-      break;
-    }
-  } extra_type_iterate_end;
-
-  return !hidden;
+  return !BV_CHECK_MASK(pextra->hidden_by, ptile->extras);
 }
 
 /************************************************************************//**
@@ -941,13 +910,7 @@ bool tile_has_visible_extra(const struct tile *ptile, const struct extra_type *p
 ****************************************************************************/
 bool tile_has_cause_extra(const struct tile *ptile, enum extra_cause cause)
 {
-  extra_type_by_cause_iterate(cause, pextra) {
-    if (tile_has_extra(ptile, pextra)) {
-      return TRUE;
-    }
-  } extra_type_by_cause_iterate_end;
-
-  return FALSE;
+  return BV_CHECK_MASK(*extra_type_mask_by_cause(cause), ptile->extras);
 }
 
 /************************************************************************//**
@@ -0,0 +1,109 @@
+#!/usr/bin/env bash
+
+# Freeciv - Copyright (C) 2026 - Freeciv Development Team
+#  This program is free software; you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation; either version 2, or (at your option)
+#  any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+
+# Run AI-only server turns without clients and collect the per-turn
+# phase timings (freeciv-server --Timing) of each game.
+#
+# Every game is either a savegame file, or "new:SIZE:PLAYERS" for a
+# freshly generated map. Fixed seeds make the runs repeatable, so the
+# resulting csv files can be compared between builds.
+
+PROGRAM_NAME="turn-benchmark.sh"
+
+SERVER="freeciv-server"
+TURNS=20
+OUTDIR="."
+
+usage() {
+  echo "Usage: $PROGRAM_NAME [-s server] [-n turns] [-o outdir] game..."
+  echo "  game is a savegame file or new:SIZE:PLAYERS"
+}
+
+# Print the turn stored in a savegame, reading compressed ones too
+savegame_turn() {
+  case "$1" in
+    *.gz)  CAT="gzip -dc" ;;
+    *.bz2) CAT="bzip2 -dc" ;;
+    *.xz)  CAT="xz -dc" ;;
+    *.zst) CAT="zstd -dc" ;;
+    *)     CAT="cat" ;;
+  esac
+
+  $CAT "$1" | awk -F= '/^\[/ { sect = $0 }
+                       sect == "[game]" && $1 == "turn" { print $2; exit }'
+}
+
+while getopts "s:n:o:h" OPT ; do
+  case "$OPT" in
+    s) SERVER="$OPTARG" ;;
+    n) TURNS="$OPTARG" ;;
+    o) OUTDIR="$OPTARG" ;;
+    *) usage
+       exit 1 ;;
+  esac
+done
+shift $((OPTIND - 1))
+
+if test "$#" = "0" ; then
+  usage
+  exit 1
+fi
+
+mkdir -p "$OUTDIR" || exit 1
+WORKDIR="$(mktemp -d)" || exit 1
+trap 'rm -rf "$WORKDIR"' EXIT
+SCRIPT="$WORKDIR/benchmark.serv"
+
+for GAME in "$@" ; do
+  case "$GAME" in
+    new:*)
+      IFS=: read -r _ SIZE PLAYERS <<< "$GAME"
+      NAME="new-${SIZE}-${PLAYERS}"
+      LOADARGS=()
+      ENDTURN="$TURNS"
+      {
+        echo "set size $SIZE"
+        echo "set aifill $PLAYERS"
+        echo "set gameseed 42"
+        echo "set mapseed 42"
+      } > "$SCRIPT"
+      ;;
+    *)
+      START="$(savegame_turn "$GAME")"
+      if test "$START" = "" ; then
+        echo "$PROGRAM_NAME: can't read turn from \"$GAME\"" >&2
+        exit 1
+      fi
+      NAME="$(basename "$GAME")"
+      NAME="${NAME%%.*}"
+      LOADARGS=(--file "$GAME")
+      ENDTURN=$((START + TURNS))
+      : > "$SCRIPT"
+      ;;
+  esac
+
+  {
+    echo "set minplayers 0"
+    echo "set timeout -1"
+    echo "set endturn $ENDTURN"
+    echo "start"
+  } >> "$SCRIPT"
+
+  echo "$NAME: running $TURNS turns"
+  if ! "$SERVER" "${LOADARGS[@]}" --read "$SCRIPT" --exit-on-end \
+       --port 0 --Timing "$OUTDIR/$NAME.csv" --log "$OUTDIR/$NAME.log" \
+       < /dev/null > /dev/null ; then
+    echo "$PROGRAM_NAME: server failed on \"$GAME\", see $OUTDIR/$NAME.log" >&2
+    exit 1
+  fi
+done
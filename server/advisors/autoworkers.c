@@ -74,6 +74,72 @@ struct workermap {
   int eta;     /* Estimated number of turns until enroute arrives */
 };
 
+/* An improvement a worker could make at a tile */
+struct worker_option {
+  enum unit_activity act;
+  struct extra_type *target;
+  adv_want extra;  /* Benefit not visible in the tile value */
+  adv_want value;  /* Value of the tile after the work */
+  int turns;       /* Turns the work takes, travel not included */
+};
+
+#define SPECVEC_TAG worker_option
+#include "specvec.h"
+#define worker_option_vector_iterate(vector, ptr) \
+  TYPED_VECTOR_ITERATE(struct worker_option, vector, ptr)
+#define worker_option_vector_iterate_end VECTOR_ITERATE_END
+
+/* A job for the batched planner: an improvement at a city tile, or
+ * a city request. Evaluated once per worker unit type. */
+struct worker_site {
+  struct tile *ptile;
+  struct city *pcity;
+  struct worker_task *ptask;    /* City request, NULL for improvements */
+  struct worker_option option;
+  adv_want base;                /* Want before travel time */
+};
+
+#define SPECVEC_TAG worker_site
+#include "specvec.h"
+#define worker_site_vector_iterate(vector, ptr) \
+  TYPED_VECTOR_ITERATE(struct worker_site, vector, ptr)
+#define worker_site_vector_iterate_end VECTOR_ITERATE_END
+
+/* Path-finding map shared by the workers moving alike from one tile */
+struct worker_flood {
+  const struct unit_type *ptype;
+  const struct tile *ptile;
+  int moves_left;
+  int veteran;
+  int hp;
+  struct pf_map *pfm;
+};
+
+#define SPECVEC_TAG worker_flood
+#include "specvec.h"
+#define worker_flood_vector_iterate(vector, ptr) \
+  TYPED_VECTOR_ITERATE(struct worker_flood, vector, ptr)
+#define worker_flood_vector_iterate_end VECTOR_ITERATE_END
+
+/* A worker's offer for a job in the batched planner */
+struct worker_bid {
+  int worker;                   /* Index of the worker in the batch */
+  const struct worker_site *site;
+  struct pf_map *pfm;
+  adv_want want;
+  int completion;               /* Turns to reach the site and do the work */
+};
+
+#define SPECVEC_TAG worker_bid
+#include "specvec.h"
+#define worker_bid_vector_iterate(vector, ptr) \
+  TYPED_VECTOR_ITERATE(struct worker_bid, vector, ptr)
+#define worker_bid_vector_iterate_end VECTOR_ITERATE_END
+
+/* Bids each worker makes in the batched planner. A worker left without
+ * a job after the matching falls back to the greedy search. */
+#define WORKER_PLAN_BIDS 8
+
 action_id aw_actions_transform[MAX_NUM_ACTIONS];
 action_id aw_actions_extra[MAX_NUM_ACTIONS];
 action_id aw_actions_rmextra[MAX_NUM_ACTIONS];
@@ -422,6 +488,251 @@ autoworker_tile_behavior(const struct tile *ptile,
   return TB_NORMAL;
 }
 
+/**********************************************************************//**
+  List the improvements punit could make at city tile ptile, with the
+  value of the tile after each of them and the turns the work takes.
+  Travel time to the tile is not included.
+**************************************************************************/
+static void worker_tile_options(const struct civ_map *nmap,
+                                struct unit *punit, bool omniscient,
+                                struct city *pcity, int cindex,
+                                struct tile *ptile,
+                                struct worker_option_vector *options)
+{
+  const struct player *pplayer = unit_owner(punit);
+  struct worker_option option;
+
+  worker_option_vector_reserve(options, 0);
+
+  aw_transform_action_iterate(act) {
+    struct extra_type *target = NULL;
+    enum extra_cause cause =
+        activity_to_extra_cause(action_id_get_activity(act));
+    enum extra_rmcause rmcause =
+        activity_to_extra_rmcause(action_id_get_activity(act));
+
+    if (cause != EC_NONE) {
+      target = next_extra_for_tile(ptile, cause, pplayer, punit);
+    } else if (rmcause != ERM_NONE) {
+      target = prev_extra_in_tile(ptile, rmcause, pplayer, punit);
+    }
+
+    if (adv_city_worker_act_get(pcity, cindex,
+                                action_id_get_activity(act)) >= 0
+        && action_prob_possible(
+          action_speculate_unit_on_tile(nmap, act,
+                                        punit, unit_home(punit),
+                                        ptile, omniscient,
+                                        ptile, target))) {
+      option.act = action_id_get_activity(act);
+      option.target = target;
+      option.extra = 0.0;
+      option.value = adv_city_worker_act_get(pcity, cindex,
+                                             action_id_get_activity(act));
+      option.turns = get_turns_for_activity_at(punit,
+                                               action_id_get_activity(act),
+                                               ptile, target);
+      worker_option_vector_append(options, option);
+    } /* endif: can the worker perform this action */
+  } aw_transform_action_iterate_end;
+
+  extra_type_iterate(pextra) {
+    enum unit_activity act = ACTIVITY_LAST;
+    enum unit_activity eval_act = ACTIVITY_LAST;
+    adv_want base_value;
+    bool removing = tile_has_extra(ptile, pextra);
+
+    if (removing) {
+      aw_rmextra_action_iterate(try_act) {
+        struct action *taction = action_by_number(try_act);
+
+        if (is_extra_removed_by_action(pextra, taction)) {
+          /* We do not even evaluate actions we can't do.
+           * Removal is not considered prerequisite for anything */
+          if (action_prob_possible(
+                action_speculate_unit_on_tile(nmap, try_act,
+                                              punit,
+                                              unit_home(punit),
+                                              ptile, omniscient,
+                                              ptile, pextra))) {
+            act = action_get_activity(taction);
+            eval_act = action_get_activity(taction);
+            break;
+          }
+        }
+      } aw_rmextra_action_iterate_end;
+    } else {
+      aw_extra_action_iterate(try_act) {
+        struct action *taction = action_by_number(try_act);
+
+        if (is_extra_caused_by_action(pextra, taction)) {
+          eval_act = action_id_get_activity(try_act);
+          if (action_prob_possible(
+                action_speculate_unit_on_tile(nmap, try_act,
+                                              punit,
+                                              unit_home(punit),
+                                              ptile, omniscient,
+                                              ptile, pextra))) {
+            act = action_get_activity(taction);
+            break;
+          }
+        }
+      } aw_extra_action_iterate_end;
+    }
+
+    if (eval_act == ACTIVITY_LAST) {
+      /* No activity can provide (or remove) the extra */
+      continue;
+    }
+
+    if (removing) {
+      base_value = adv_city_worker_rmextra_get(pcity, cindex, pextra);
+    } else {
+      base_value = adv_city_worker_extra_get(pcity, cindex, pextra);
+    }
+
+    if (base_value >= 0) {
+      adv_want extra;
+      int turns;
+      struct road_type *proad;
+
+      turns = get_turns_for_activity_at(punit, eval_act, ptile, pextra);
+
+      proad = extra_road_get(pextra);
+
+      if (proad != NULL && road_provides_move_bonus(proad)) {
+        int mc_multiplier = 1;
+        int mc_divisor = 1;
+        int old_move_cost = tile_terrain(ptile)->movement_cost * SINGLE_MOVE;
+
+        /* Here 'old' means actually 'without the evaluated': In case of
+         * removal activity it's the value after the removal. */
+
+        extra_type_by_cause_iterate(EC_ROAD, pold) {
+          if (tile_has_extra(ptile, pold) && pold != pextra) {
+            struct road_type *po_road = extra_road_get(pold);
+
+            /* This ignores the fact that new road may be native to units that
+             * old road is not. */
+            if (po_road->move_cost < old_move_cost) {
+              old_move_cost = po_road->move_cost;
+            }
+          }
+        } extra_type_by_cause_iterate_end;
+
+        if (proad->move_cost < old_move_cost) {
+          if (proad->move_cost >= terrain_control.move_fragments) {
+            mc_divisor = proad->move_cost / terrain_control.move_fragments;
+          } else {
+            if (proad->move_cost == 0) {
+              mc_multiplier = 2;
+            } else {
+              mc_multiplier = 1 - proad->move_cost;
+            }
+            mc_multiplier += old_move_cost;
+          }
+        }
+
+        extra = adv_workers_road_bonus(nmap, ptile, proad)
+          * mc_multiplier / mc_divisor;
+
+      } else {
+        extra = 0;
+      }
+
+      if (extra_has_flag(pextra, EF_GLOBAL_WARMING)) {
+        extra -= pplayer->ai_common.warmth;
+      }
+      if (extra_has_flag(pextra, EF_NUCLEAR_WINTER)) {
+        extra -= pplayer->ai_common.frost;
+      }
+
+      if (removing) {
+        extra = -extra;
+      }
+
+      if (act != ACTIVITY_LAST) {
+        option.act = act;
+        option.target = pextra;
+        option.extra = extra;
+        option.value = base_value;
+        option.turns = turns;
+        worker_option_vector_append(options, option);
+      } else {
+        fc_assert(!removing);
+
+        road_deps_iterate(&(pextra->reqs), pdep) {
+          struct extra_type *dep_tgt;
+
+          dep_tgt = road_extra_get(pdep);
+
+          if (action_prob_possible(
+                action_speculate_unit_on_tile(nmap, ACTION_ROAD,
+                                              punit, unit_home(punit), ptile,
+                                              omniscient,
+                                              ptile, dep_tgt))) {
+            /* Consider building dependency road for later upgrade to target extra.
+             * Here we set value to be sum of dependency
+             * road and target extra values, which increases want, and turns is sum
+             * of dependency and target build turns, which decreases want. This can
+             * result in either bigger or lesser want than when checking dependency
+             * road for the sake of itself when its turn in extra_type_iterate() is. */
+            option.act = ACTIVITY_GEN_ROAD;
+            option.target = dep_tgt;
+            option.extra = extra;
+            option.value = base_value + adv_city_worker_extra_get(pcity, cindex,
+                                                                  dep_tgt);
+            option.turns = turns + get_turns_for_activity_at(punit,
+                                                             ACTIVITY_GEN_ROAD,
+                                                             ptile, dep_tgt);
+            worker_option_vector_append(options, option);
+          }
+        } road_deps_iterate_end;
+
+        extra_deps_iterate(&(pextra->reqs), pdep) {
+          /* Roads handled above already */
+          if (!is_extra_caused_by(pdep, EC_ROAD)) {
+            enum unit_activity eval_dep_act = ACTIVITY_LAST;
+            action_id eval_dep_action;
+
+            aw_extra_action_iterate(try_act) {
+              struct action *taction = action_by_number(try_act);
+
+              if (is_extra_caused_by_action(pdep, taction)) {
+                eval_dep_action = try_act;
+                eval_dep_act = action_id_get_activity(try_act);
+                break;
+              }
+            } aw_extra_action_iterate_end;
+
+            if (eval_dep_act != ACTIVITY_LAST) {
+              if (action_prob_possible(
+                    action_speculate_unit_on_tile(nmap, eval_dep_action,
+                                                  punit, unit_home(punit), ptile,
+                                                  omniscient,
+                                                  ptile, pdep))) {
+                /* Consider building dependency extra for later upgrade to
+                 * target extra. See similar road implementation above for
+                 * extended commentary. */
+                option.act = eval_dep_act;
+                option.target = pdep;
+                option.extra = 0.0;
+                option.value = base_value + adv_city_worker_extra_get(pcity,
+                                                                      cindex,
+                                                                      pdep);
+                option.turns = turns + get_turns_for_activity_at(punit,
+                                                                 eval_dep_act,
+                                                                 ptile, pdep);
+                worker_option_vector_append(options, option);
+              }
+            }
+          }
+        } extra_deps_iterate_end;
+      }
+    }
+  } extra_type_iterate_end;
+}
+
 /**********************************************************************//**
   Finds tiles to improve, using punit.
 
@@ -459,6 +770,7 @@ adv_want worker_evaluate_improvements(const struct civ_map *nmap,
   bool improve_worked = FALSE;
   int best_extra = 0;
   int best_delay = 0;
+  struct worker_option_vector options;
 
   /* Closest worker, if any, headed towards target tile */
   struct unit *enroute = NULL;
@@ -467,6 +779,7 @@ adv_want worker_evaluate_improvements(const struct civ_map *nmap,
   parameter.omniscience = !has_handicap(pplayer, H_MAP);
   parameter.get_TB = autoworker_tile_behavior;
   pfm = pf_map_new(&parameter);
+  worker_option_vector_init(&options);
 
   city_list_iterate(pplayer->cities, pcity) {
     struct tile *pcenter = city_tile(pcity);
@@ -533,268 +846,24 @@ adv_want worker_evaluate_improvements(const struct civ_map *nmap,
           oldv = city_tile_value(pcity, ptile, 0, 0);
 
           /* Now, consider various activities... */
-          aw_transform_action_iterate(act) {
-            struct extra_type *target = NULL;
-            enum extra_cause cause =
-                activity_to_extra_cause(action_id_get_activity(act));
-            enum extra_rmcause rmcause =
-                activity_to_extra_rmcause(action_id_get_activity(act));
-
-            if (cause != EC_NONE) {
-              target = next_extra_for_tile(ptile, cause, pplayer,
-                                           punit);
-            } else if (rmcause != ERM_NONE) {
-              target = prev_extra_in_tile(ptile, rmcause, pplayer,
-                                          punit);
-            }
-
-            if (adv_city_worker_act_get(pcity, cindex,
-                                        action_id_get_activity(act)) >= 0
-                && action_prob_possible(
-                  action_speculate_unit_on_tile(nmap, act,
-                                                punit, unit_home(punit),
-                                                ptile,
-                                                parameter.omniscience,
-                                                ptile, target))) {
-              adv_want base_value
-                = adv_city_worker_act_get(pcity, cindex,
-                                          action_id_get_activity(act));
-
-              turns = pos.turn
-                  + get_turns_for_activity_at(punit,
-                                              action_id_get_activity(act),
-                                              ptile, target);
-              if (pos.moves_left == 0) {
-                /* We need moves left to begin activity immediately. */
-                turns++;
-              }
-
-              consider_worker_action(pplayer,
-                                     action_id_get_activity(act),
-                                     target, 0.0, base_value,
-                                     oldv, in_use, turns,
-                                     &best_newv, &best_oldv, &best_extra,
-                                     &improve_worked,
-                                     &best_delay, best_act, best_target,
-                                     best_tile, ptile);
-
-            } /* endif: can the worker perform this action */
-          } aw_transform_action_iterate_end;
-
-          extra_type_iterate(pextra) {
-            enum unit_activity act = ACTIVITY_LAST;
-            enum unit_activity eval_act = ACTIVITY_LAST;
-            adv_want base_value;
-            bool removing = tile_has_extra(ptile, pextra);
-
-            if (removing) {
-              aw_rmextra_action_iterate(try_act) {
-                struct action *taction = action_by_number(try_act);
-
-                if (is_extra_removed_by_action(pextra, taction)) {
-                  /* We do not even evaluate actions we can't do.
-                   * Removal is not considered prerequisite for anything */
-                  if (action_prob_possible(
-                        action_speculate_unit_on_tile(nmap, try_act,
-                                                      punit,
-                                                      unit_home(punit),
-                                                      ptile,
-                                                      parameter.omniscience,
-                                                      ptile, pextra))) {
-                    act = action_get_activity(taction);
-                    eval_act = action_get_activity(taction);
-                    break;
-                  }
-                }
-              } aw_rmextra_action_iterate_end;
-            } else {
-              aw_extra_action_iterate(try_act) {
-                struct action *taction = action_by_number(try_act);
-
-                if (is_extra_caused_by_action(pextra, taction)) {
-                  eval_act = action_id_get_activity(try_act);
-                  if (action_prob_possible(
-                        action_speculate_unit_on_tile(nmap, try_act,
-                                                      punit,
-                                                      unit_home(punit),
-                                                      ptile,
-                                                      parameter.omniscience,
-                                                      ptile, pextra))) {
-                    act = action_get_activity(taction);
-                    break;
-                  }
-                }
-              } aw_extra_action_iterate_end;
-            }
-
-            if (eval_act == ACTIVITY_LAST) {
-              /* No activity can provide (or remove) the extra */
-              continue;
+          worker_tile_options(nmap, punit, parameter.omniscience,
+                              pcity, cindex, ptile, &options);
+
+          worker_option_vector_iterate(&options, poption) {
+            turns = pos.turn + poption->turns;
+            if (pos.moves_left == 0) {
+              /* We need moves left to begin activity immediately. */
+              turns++;
             }
 
-            if (removing) {
-              base_value = adv_city_worker_rmextra_get(pcity, cindex, pextra);
-            } else {
-              base_value = adv_city_worker_extra_get(pcity, cindex, pextra);
-            }
-
-            if (base_value >= 0) {
-              adv_want extra;
-              struct road_type *proad;
-
-              turns = pos.turn + get_turns_for_activity_at(punit, eval_act,
-                                                           ptile, pextra);
-              if (pos.moves_left == 0) {
-                /* We need moves left to begin activity immediately. */
-                turns++;
-              }
-
-              proad = extra_road_get(pextra);
-
-              if (proad != NULL && road_provides_move_bonus(proad)) {
-                int mc_multiplier = 1;
-                int mc_divisor = 1;
-                int old_move_cost = tile_terrain(ptile)->movement_cost * SINGLE_MOVE;
-
-                /* Here 'old' means actually 'without the evaluated': In case of
-                 * removal activity it's the value after the removal. */
-
-                extra_type_by_cause_iterate(EC_ROAD, pold) {
-                  if (tile_has_extra(ptile, pold) && pold != pextra) {
-                    struct road_type *po_road = extra_road_get(pold);
-
-                    /* This ignores the fact that new road may be native to units that
-                     * old road is not. */
-                    if (po_road->move_cost < old_move_cost) {
-                      old_move_cost = po_road->move_cost;
-                    }
-                  }
-                } extra_type_by_cause_iterate_end;
-
-                if (proad->move_cost < old_move_cost) {
-                  if (proad->move_cost >= terrain_control.move_fragments) {
-                    mc_divisor = proad->move_cost / terrain_control.move_fragments;
-                  } else {
-                    if (proad->move_cost == 0) {
-                      mc_multiplier = 2;
-                    } else {
-                      mc_multiplier = 1 - proad->move_cost;
-                    }
-                    mc_multiplier += old_move_cost;
-                  }
-                }
-
-                extra = adv_workers_road_bonus(nmap, ptile, proad)
-                  * mc_multiplier / mc_divisor;
-
-              } else {
-                extra = 0;
-              }
-
-              if (extra_has_flag(pextra, EF_GLOBAL_WARMING)) {
-                extra -= pplayer->ai_common.warmth;
-              }
-              if (extra_has_flag(pextra, EF_NUCLEAR_WINTER)) {
-                extra -= pplayer->ai_common.frost;
-              }
-
-              if (removing) {
-                extra = -extra;
-              }
-
-              if (act != ACTIVITY_LAST) {
-                consider_worker_action(pplayer, act, pextra, extra, base_value,
-                                       oldv, in_use, turns,
-                                       &best_newv, &best_oldv, &best_extra,
-                                       &improve_worked,
-                                       &best_delay, best_act, best_target,
-                                       best_tile, ptile);
-              } else {
-                fc_assert(!removing);
-
-                road_deps_iterate(&(pextra->reqs), pdep) {
-                  struct extra_type *dep_tgt;
-
-                  dep_tgt = road_extra_get(pdep);
-
-                  if (action_prob_possible(
-                        action_speculate_unit_on_tile(nmap, ACTION_ROAD,
-                                                      punit, unit_home(punit), ptile,
-                                                      parameter.omniscience,
-                                                      ptile, dep_tgt))) {
-                    /* Consider building dependency road for later upgrade to target extra.
-                     * Here we set value to be sum of dependency
-                     * road and target extra values, which increases want, and turns is sum
-                     * of dependency and target build turns, which decreases want. This can
-                     * result in either bigger or lesser want than when checking dependency
-                     * road for the sake of itself when its turn in extra_type_iterate() is. */
-                    int dep_turns
-                      = turns + get_turns_for_activity_at(punit,
-                                                          ACTIVITY_GEN_ROAD,
-                                                          ptile, dep_tgt);
-                    adv_want dep_value
-                      = base_value + adv_city_worker_extra_get(pcity, cindex,
-                                                               dep_tgt);
-
-                    consider_worker_action(pplayer, ACTIVITY_GEN_ROAD,
-                                           dep_tgt, extra, dep_value,
-                                           oldv, in_use, dep_turns,
-                                           &best_newv, &best_oldv, &best_extra,
-                                           &improve_worked,
-                                           &best_delay, best_act, best_target,
-                                           best_tile, ptile);
-                  }
-                } road_deps_iterate_end;
-
-                extra_deps_iterate(&(pextra->reqs), pdep) {
-                  /* Roads handled above already */
-                  if (!is_extra_caused_by(pdep, EC_ROAD)) {
-                    enum unit_activity eval_dep_act = ACTIVITY_LAST;
-                    action_id eval_dep_action;
-
-                    aw_extra_action_iterate(try_act) {
-                      struct action *taction = action_by_number(try_act);
-
-                      if (is_extra_caused_by_action(pdep, taction)) {
-                        eval_dep_action = try_act;
-                        eval_dep_act = action_id_get_activity(try_act);
-                        break;
-                      }
-                    } aw_extra_action_iterate_end;
-
-                    if (eval_dep_act != ACTIVITY_LAST) {
-                      if (action_prob_possible(
-                            action_speculate_unit_on_tile(nmap, eval_dep_action,
-                                                          punit, unit_home(punit), ptile,
-                                                          parameter.omniscience,
-                                                          ptile, pdep))) {
-                        /* Consider building dependency extra for later upgrade to
-                         * target extra. See similar road implementation above for
-                         * extended commentary. */
-                        int dep_turns
-                          = turns + get_turns_for_activity_at(punit,
-                                                              eval_dep_act,
-                                                              ptile, pdep);
-                        adv_want dep_value
-                          = base_value + adv_city_worker_extra_get(pcity,
-                                                                   cindex,
-                                                                   pdep);
-
-                        consider_worker_action(pplayer, eval_dep_act, pdep,
-                                               0.0, dep_value, oldv, in_use,
-                                               dep_turns, &best_newv,
-                                               &best_oldv,
-                                               &best_extra, &improve_worked,
-                                               &best_delay,
-                                               best_act, best_target,
-                                               best_tile, ptile);
-                      }
-                    }
-                  }
-                } extra_deps_iterate_end;
-              }
-            }
-          } extra_type_iterate_end;
+            consider_worker_action(pplayer, poption->act, poption->target,
+                                   poption->extra, poption->value,
+                                   oldv, in_use, turns,
+                                   &best_newv, &best_oldv, &best_extra,
+                                   &improve_worked,
+                                   &best_delay, best_act, best_target,
+                                   best_tile, ptile);
+          } worker_option_vector_iterate_end;
         } /* endif: can we arrive sooner than current worker, if any? */
       } /* endif: are we travelling to a legal destination? */
     } city_tile_iterate_index_end;
@@ -830,6 +899,7 @@ adv_want worker_evaluate_improvements(const struct civ_map *nmap,
   }
 
   pf_map_destroy(pfm);
+  worker_option_vector_free(&options);
 
   return best_newv;
 }
@@ -1179,6 +1249,430 @@ bool adv_worker_safe_tile(const struct civ_map *nmap,
   return TRUE;
 }
 
+/**********************************************************************//**
+  Auto-work with a worker unit if it's under AI control (e.g. human
+  player autoworker mode) or if the player is an AI. But don't
+  autowork with a unit under orders even for an AI player - these come
+  from the human player and take precedence.
+**************************************************************************/
+static bool auto_worker_controlled(const struct player *pplayer,
+                                   const struct unit *punit)
+{
+  return ((punit->ssa_controller == SSA_AUTOWORKER || is_ai(pplayer))
+          && (unit_type_get(punit)->adv.worker
+              || unit_is_cityfounder(punit))
+          && !unit_has_orders(punit)
+          && punit->moves_left > 0);
+}
+
+/**********************************************************************//**
+  Get an auto worker ready for finding work: wake it up, and stop its
+  current activity if it's no longer safe to continue.
+**************************************************************************/
+static void auto_worker_prepare(const struct civ_map *nmap,
+                                struct player *pplayer, struct unit *punit,
+                                struct workermap *state)
+{
+  log_debug("%s %s at (%d, %d) is controlled by server side agent %s.",
+            nation_rule_name(nation_of_player(pplayer)),
+            unit_rule_name(punit),
+            TILE_XY(unit_tile(punit)),
+            server_side_agent_name(SSA_AUTOWORKER));
+  if (punit->activity == ACTIVITY_SENTRY) {
+    unit_activity_handling(punit, ACTIVITY_IDLE, ACTION_NONE);
+  }
+  if (punit->activity == ACTIVITY_GOTO && punit->moves_left > 0) {
+    unit_activity_handling(punit, ACTIVITY_IDLE, ACTION_NONE);
+  }
+  if (punit->activity != ACTIVITY_IDLE) {
+    if (!is_ai(pplayer)) {
+      if (!adv_worker_safe_tile(nmap, pplayer, punit,
+                                 unit_tile(punit))) {
+        unit_activity_handling(punit, ACTIVITY_IDLE, ACTION_NONE);
+      }
+    } else {
+      CALL_PLR_AI_FUNC(settler_cont, pplayer, pplayer, punit, state);
+    }
+  }
+}
+
+/**********************************************************************//**
+  Find work for an idle auto worker on its own.
+**************************************************************************/
+static void auto_worker_run(const struct civ_map *nmap,
+                            struct player *pplayer, struct unit *punit,
+                            struct workermap *state)
+{
+  if (punit->activity == ACTIVITY_IDLE) {
+    if (!is_ai(pplayer)) {
+      auto_worker_findwork(nmap, pplayer, punit, state, 0);
+    } else {
+      CALL_PLR_AI_FUNC(settler_run, pplayer, pplayer, punit, state);
+    }
+  }
+}
+
+/**********************************************************************//**
+  Is the tile already taken by another worker of the player standing
+  on it?
+**************************************************************************/
+static bool worker_tile_taken(const struct player *pplayer,
+                              const struct unit *punit,
+                              const struct tile *ptile)
+{
+  unit_list_iterate(ptile->units, aunit) {
+    if (unit_owner(aunit) == pplayer
+        && aunit->id != punit->id
+        && unit_has_type_flag(aunit, UTYF_WORKERS)) {
+      return TRUE;
+    }
+  } unit_list_iterate_end;
+
+  return FALSE;
+}
+
+/**********************************************************************//**
+  Collect the jobs workers of the type of prep could take: the city
+  requests, and the tile improvements with their want before travel
+  time is accounted for. The want is the improvement measure used by
+  worker_evaluate_improvements() when comparing against tiles in use.
+**************************************************************************/
+static void worker_plan_sites(const struct civ_map *nmap,
+                              struct player *pplayer, struct unit *prep,
+                              bool omniscient,
+                              struct worker_site_vector *sites,
+                              struct worker_option_vector *options)
+{
+  struct worker_site site;
+
+  city_list_iterate(pplayer->cities, pcity) {
+    worker_task_list_iterate(pcity->task_reqs, ptask) {
+      if (auto_workers_speculate_can_act_at(prep, ptask->act, omniscient,
+                                            ptask->tgt, ptask->ptile)) {
+        site.ptile = ptask->ptile;
+        site.pcity = pcity;
+        site.ptask = ptask;
+        site.option.act = ptask->act;
+        site.option.target = ptask->tgt;
+        site.option.extra = 0.0;
+        site.option.value = 0.0;
+        site.option.turns = 0;
+        site.base = (ptask->want + 1) * 10;
+        worker_site_vector_append(sites, site);
+      }
+    } worker_task_list_iterate_end;
+
+    city_tile_iterate_index(nmap, city_map_radius_sq_get(pcity),
+                            city_tile(pcity), ptile, cindex) {
+      bool in_use = (tile_worked(ptile) == pcity);
+      adv_want oldv;
+
+      if (!in_use && !city_can_work_tile(pcity, ptile)) {
+        continue;
+      }
+
+      if (!adv_worker_safe_tile(nmap, pplayer, prep, ptile)) {
+        continue;
+      }
+
+      oldv = city_tile_value(pcity, ptile, 0, 0);
+      worker_tile_options(nmap, prep, omniscient, pcity, cindex, ptile,
+                          options);
+
+      worker_option_vector_iterate(options, poption) {
+        adv_want base = (poption->value - oldv) * WORKER_FACTOR;
+
+        if (!in_use) {
+          base /= 2;
+        }
+        base += MAX(poption->extra, 0) * WORKER_FACTOR;
+
+        if (base > 0) {
+          site.ptile = ptile;
+          site.pcity = pcity;
+          site.ptask = NULL;
+          site.option = *poption;
+          site.base = base;
+          worker_site_vector_append(sites, site);
+        }
+      } worker_option_vector_iterate_end;
+    } city_tile_iterate_index_end;
+  } city_list_iterate_end;
+}
+
+/**********************************************************************//**
+  Return the path-finding map for punit, sharing it with the workers
+  already planned that move alike from the same tile.
+**************************************************************************/
+static struct pf_map *worker_plan_flood(const struct civ_map *nmap,
+                                        struct unit *punit,
+                                        struct worker_flood_vector *floods)
+{
+  const struct unit_type *ptype = unit_type_get(punit);
+  struct worker_flood flood;
+  struct pf_parameter parameter;
+
+  worker_flood_vector_iterate(floods, pflood) {
+    if (pflood->ptype == ptype
+        && pflood->ptile == unit_tile(punit)
+        && pflood->moves_left == punit->moves_left
+        && pflood->veteran == punit->veteran
+        && pflood->hp == punit->hp) {
+      return pflood->pfm;
+    }
+  } worker_flood_vector_iterate_end;
+
+  pft_fill_unit_parameter(&parameter, nmap, punit);
+  parameter.omniscience = !has_handicap(unit_owner(punit), H_MAP);
+  parameter.get_TB = autoworker_tile_behavior;
+
+  flood.ptype = ptype;
+  flood.ptile = unit_tile(punit);
+  flood.moves_left = punit->moves_left;
+  flood.veteran = punit->veteran;
+  flood.hp = punit->hp;
+  flood.pfm = pf_map_new(&parameter);
+  worker_flood_vector_append(floods, flood);
+
+  return flood.pfm;
+}
+
+/**********************************************************************//**
+  Order bids best first. City requests come before tile improvements,
+  as they do for a single worker. The rest of the keys only make the
+  order stable.
+**************************************************************************/
+static int worker_bid_cmp(const void *a, const void *b)
+{
+  const struct worker_bid *pa = a, *pb = b;
+
+  if ((pa->site->ptask != NULL) != (pb->site->ptask != NULL)) {
+    return pa->site->ptask != NULL ? -1 : 1;
+  }
+  if (pa->want != pb->want) {
+    return pa->want > pb->want ? -1 : 1;
+  }
+  if (pa->worker != pb->worker) {
+    return pa->worker - pb->worker;
+  }
+  if (pa->site->ptile != pb->site->ptile) {
+    return tile_index(pa->site->ptile) - tile_index(pb->site->ptile);
+  }
+
+  return pa->site->option.act - pb->site->option.act;
+}
+
+/**********************************************************************//**
+  Add the best bids of the worker to bids. Only one bid per tile is
+  kept, as a tile can be given to one worker only.
+**************************************************************************/
+static void worker_plan_bids(const struct player *pplayer,
+                             struct unit *punit, int worker,
+                             struct pf_map *pfm,
+                             const struct worker_site_vector *sites,
+                             struct worker_bid_vector *own,
+                             struct worker_bid_vector *bids)
+{
+  int kept = 0;
+  size_t i;
+
+  worker_bid_vector_reserve(own, 0);
+
+  worker_site_vector_iterate(sites, psite) {
+    struct pf_position pos;
+    struct worker_bid bid;
+
+    if (worker_tile_taken(pplayer, punit, psite->ptile)
+        || !pf_map_position(pfm, psite->ptile, &pos)) {
+      continue;
+    }
+
+    bid.worker = worker;
+    bid.site = psite;
+    bid.pfm = pfm;
+
+    if (psite->ptask != NULL) {
+      bid.completion = pos.turn;
+      bid.want = (int) psite->base / (pos.turn + 1);
+    } else {
+      bid.completion = pos.turn + psite->option.turns;
+      if (pos.moves_left == 0) {
+        /* We need moves left to begin activity immediately. */
+        bid.completion++;
+      }
+      bid.want = amortize(psite->base, bid.completion);
+      if (bid.want <= 0) {
+        continue;
+      }
+    }
+
+    worker_bid_vector_append(own, bid);
+  } worker_site_vector_iterate_end;
+
+  if (worker_bid_vector_size(own) > 1) {
+    qsort(own->p, worker_bid_vector_size(own), sizeof(*own->p),
+          worker_bid_cmp);
+  }
+
+  for (i = 0; i < worker_bid_vector_size(own) && kept < WORKER_PLAN_BIDS;
+       i++) {
+    const struct worker_bid *pbid = worker_bid_vector_get(own, i);
+    bool seen = FALSE;
+    int j;
+
+    for (j = worker_bid_vector_size(bids) - kept;
+         j < (int) worker_bid_vector_size(bids); j++) {
+      if (worker_bid_vector_get(bids, j)->site->ptile == pbid->site->ptile) {
+        seen = TRUE;
+        break;
+      }
+    }
+
+    if (!seen) {
+      worker_bid_vector_append(bids, *pbid);
+      kept++;
+    }
+  }
+}
+
+/**********************************************************************//**
+  Assign work to all the idle workers in ids together.
+
+  The jobs are evaluated once per worker type, and workers that start
+  from the same tile with the same moves share their path-finding map.
+  Each worker bids for its best jobs, and the bids are matched best
+  first, giving each worker at most one job and each tile at most one
+  worker. Workers that get a job are sent there and their ids are
+  cleared. Those left over, and the units that are not pure workers,
+  keep their ids for the per-unit search.
+**************************************************************************/
+static void auto_workers_plan_batched(const struct civ_map *nmap,
+                                      struct player *pplayer,
+                                      int *ids, int count,
+                                      struct workermap *state)
+{
+  bool omniscient = !has_handicap(pplayer, H_MAP);
+  struct worker_site_vector *sites;
+  bool *evaluated;
+  struct worker_option_vector options;
+  struct worker_flood_vector floods;
+  struct worker_bid_vector own, bids;
+  struct unit **workers;
+  struct dbv claimed;
+  int planned = 0, assigned = 0;
+  int i;
+
+  TIMING_LOG(AIT_WORKERS, TIMER_START);
+
+  sites = fc_calloc(utype_count(), sizeof(*sites));
+  evaluated = fc_calloc(utype_count(), sizeof(*evaluated));
+  workers = fc_calloc(count, sizeof(*workers));
+  worker_option_vector_init(&options);
+  worker_flood_vector_init(&floods);
+  worker_bid_vector_init(&own);
+  worker_bid_vector_init(&bids);
+
+  for (i = 0; i < count; i++) {
+    struct unit *punit = player_unit_by_number(pplayer, ids[i]);
+    struct worker_site_vector *psites;
+
+    if (punit == NULL
+        || !unit_has_type_flag(punit, UTYF_WORKERS)
+        || unit_is_cityfounder(punit)
+        || punit->activity != ACTIVITY_IDLE
+        || punit->moves_left <= 0) {
+      continue;
+    }
+
+    psites = &sites[utype_index(unit_type_get(punit))];
+    if (!evaluated[utype_index(unit_type_get(punit))]) {
+      /* First worker of the type evaluates the jobs for all of them. */
+      worker_plan_sites(nmap, pplayer, punit, omniscient, psites,
+                        &options);
+      evaluated[utype_index(unit_type_get(punit))] = TRUE;
+    }
+
+    workers[i] = punit;
+    worker_plan_bids(pplayer, punit, i,
+                     worker_plan_flood(nmap, punit, &floods),
+                     psites, &own, &bids);
+    planned++;
+  }
+
+  if (worker_bid_vector_size(&bids) > 1) {
+    qsort(bids.p, worker_bid_vector_size(&bids), sizeof(*bids.p),
+          worker_bid_cmp);
+  }
+
+  dbv_init(&claimed, MAP_INDEX_SIZE);
+
+  worker_bid_vector_iterate(&bids, pbid) {
+    const struct worker_site *psite = pbid->site;
+    struct unit *punit;
+    struct extra_type *target = psite->option.target;
+    struct pf_path *path = NULL;
+    int saved_id = ids[pbid->worker];
+
+    if (workers[pbid->worker] == NULL
+        || dbv_isset(&claimed, tile_index(psite->ptile))) {
+      continue;
+    }
+
+    dbv_set(&claimed, tile_index(psite->ptile));
+    punit = workers[pbid->worker];
+    workers[pbid->worker] = NULL;
+    ids[pbid->worker] = IDENTITY_NUMBER_ZERO;
+
+    if (NULL == player_unit_by_number(pplayer, saved_id)
+        || punit->activity != ACTIVITY_IDLE
+        || punit->moves_left <= 0) {
+      /* Died or got busy while the workers before it acted. */
+      continue;
+    }
+
+    if (pf_map_parameter(pbid->pfm)->start_tile == unit_tile(punit)) {
+      path = pf_map_path(pbid->pfm, psite->ptile);
+    }
+
+    adv_unit_new_task(punit, AUT_AUTO_WORKER, psite->ptile);
+
+    if (auto_worker_setup_work(nmap, pplayer, punit, state, 0, &path,
+                               psite->ptile, psite->option.act, &target,
+                               pbid->completion)
+        && psite->ptask != NULL) {
+      clear_worker_task(psite->pcity, psite->ptask);
+    }
+
+    if (path != NULL) {
+      pf_path_destroy(path);
+    }
+    assigned++;
+  } worker_bid_vector_iterate_end;
+
+  log_debug("%s batched worker planner: %d workers, %d path-finding maps, "
+            "%d bids, %d assigned",
+            player_name(pplayer), planned,
+            (int) worker_flood_vector_size(&floods),
+            (int) worker_bid_vector_size(&bids), assigned);
+
+  dbv_free(&claimed);
+  worker_flood_vector_iterate(&floods, pflood) {
+    pf_map_destroy(pflood->pfm);
+  } worker_flood_vector_iterate_end;
+  worker_flood_vector_free(&floods);
+  worker_bid_vector_free(&own);
+  worker_bid_vector_free(&bids);
+  worker_option_vector_free(&options);
+  for (i = 0; i < utype_count(); i++) {
+    worker_site_vector_free(&sites[i]);
+  }
+  free(sites);
+  free(evaluated);
+  free(workers);
+
+  TIMING_LOG(AIT_WORKERS, TIMER_STOP);
+}
+
 /**********************************************************************//**
   Run through all the players workers and let those on ai.control work
   automagically.
@@ -1223,46 +1717,42 @@ void auto_workers_player(struct player *pplayer)
   log_debug("Frost = %d, game.nuclearwinter=%d",
             pplayer->ai_common.frost, game.info.nuclearwinter);
 
-  /* Auto-work with a worker unit if it's under AI control (e.g. human
-   * player autoworker mode) or if the player is an AI. But don't
-   * autowork with a unit under orders even for an AI player - these come
-   * from the human player and take precedence. */
-  unit_list_iterate_safe(pplayer->units, punit) {
-    if ((punit->ssa_controller == SSA_AUTOWORKER || is_ai(pplayer))
-        && (unit_type_get(punit)->adv.worker
-            || unit_is_cityfounder(punit))
-        && !unit_has_orders(punit)
-        && punit->moves_left > 0) {
-      log_debug("%s %s at (%d, %d) is controlled by server side agent %s.",
-                nation_rule_name(nation_of_player(pplayer)),
-                unit_rule_name(punit),
-                TILE_XY(unit_tile(punit)),
-                server_side_agent_name(SSA_AUTOWORKER));
-      if (punit->activity == ACTIVITY_SENTRY) {
-        unit_activity_handling(punit, ACTIVITY_IDLE, ACTION_NONE);
-      }
-      if (punit->activity == ACTIVITY_GOTO && punit->moves_left > 0) {
-        unit_activity_handling(punit, ACTIVITY_IDLE, ACTION_NONE);
-      }
-      if (punit->activity != ACTIVITY_IDLE) {
-        if (!is_ai(pplayer)) {
-          if (!adv_worker_safe_tile(nmap, pplayer, punit,
-                                     unit_tile(punit))) {
-            unit_activity_handling(punit, ACTIVITY_IDLE, ACTION_NONE);
-          }
-        } else {
-          CALL_PLR_AI_FUNC(settler_cont, pplayer, pplayer, punit, state);
+  if (game.server.worker_planner == WP_BATCHED) {
+    int *ids = fc_malloc(MAX(unit_list_size(pplayer->units), 1)
+                         * sizeof(*ids));
+    int count = 0;
+    int i;
+
+    unit_list_iterate_safe(pplayer->units, punit) {
+      if (auto_worker_controlled(pplayer, punit)) {
+        auto_worker_prepare(nmap, pplayer, punit, state);
+        if (punit->activity == ACTIVITY_IDLE) {
+          ids[count++] = punit->id;
         }
       }
-      if (punit->activity == ACTIVITY_IDLE) {
-        if (!is_ai(pplayer)) {
-          auto_worker_findwork(nmap, pplayer, punit, state, 0);
-        } else {
-          CALL_PLR_AI_FUNC(settler_run, pplayer, pplayer, punit, state);
-        }
+    } unit_list_iterate_safe_end;
+
+    auto_workers_plan_batched(nmap, pplayer, ids, count, state);
+
+    /* City founders, and the workers the planner found no job for */
+    for (i = 0; i < count; i++) {
+      struct unit *punit = player_unit_by_number(pplayer, ids[i]);
+
+      if (punit != NULL && punit->moves_left > 0) {
+        auto_worker_run(nmap, pplayer, punit, state);
       }
     }
-  } unit_list_iterate_safe_end;
+
+    free(ids);
+  } else {
+    unit_list_iterate_safe(pplayer->units, punit) {
+      if (auto_worker_controlled(pplayer, punit)) {
+        auto_worker_prepare(nmap, pplayer, punit, state);
+        auto_worker_run(nmap, pplayer, punit, state);
+      }
+    } unit_list_iterate_safe_end;
+  }
+
   /* Reset auto worker state for the next run. */
   if (is_ai(pplayer)) {
     CALL_PLR_AI_FUNC(settler_reset, pplayer, pplayer);
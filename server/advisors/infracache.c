@@ -19,7 +19,9 @@
 #include "city.h"
 #include "game.h"
 #include "map.h"
+#include "improvement.h"
 #include "player.h"
+#include "research.h"
 #include "tile.h"
 
 /* server */
@@ -36,6 +38,10 @@ struct worker_activity_cache {
   adv_want act[ACTIVITY_LAST];
   adv_want extra[MAX_EXTRA_TYPES];
   adv_want rmextra[MAX_EXTRA_TYPES];
+
+  /* Fingerprint of the tile and its neighbors at the time
+   * the values were calculated. */
+  unsigned int fingerprint;
 };
 
 static adv_want adv_calc_cultivate(const struct city *pcity,
@@ -240,59 +246,254 @@ static adv_want adv_calc_rmextra(const struct city *pcity,
   return goodness;
 }
 
+/**********************************************************************//**
+  Fingerprint of the player wide state the tile values of all the cities
+  of the player depend on: government, known techs and wonders.
+**************************************************************************/
+unsigned int adv_player_fingerprint(const struct player *pplayer)
+{
+  const struct research *presearch = research_get(pplayer);
+  unsigned int hash = ADV_FINGERPRINT_INIT;
+
+  hash = adv_fingerprint_add(hash, player_number(pplayer));
+  hash = adv_fingerprint_add(hash,
+                             government_number(government_of_player(pplayer)));
+  hash = adv_fingerprint_add(hash, presearch->techs_researched);
+  hash = adv_fingerprint_add(hash, presearch->future_tech);
+  hash = adv_fingerprint_add(hash, game.info.global_advance_count);
+
+  improvement_iterate(pimprove) {
+    if (is_great_wonder(pimprove)) {
+      const struct player *owner = great_wonder_owner(pimprove);
+
+      hash = adv_fingerprint_add(hash, owner != NULL
+                                       ? player_number(owner) + 1 : 0);
+    } else if (is_small_wonder(pimprove)) {
+      int wonder_city = pplayer->wonders[improvement_index(pimprove)];
+
+      hash = adv_fingerprint_add(hash, wonder_city);
+    }
+  } improvement_iterate_end;
+
+  return hash;
+}
+
+/**********************************************************************//**
+  Fingerprint of the city state the tile values depend on. Any change
+  in it invalidates the values of all the tiles of the city.
+**************************************************************************/
+static unsigned int infra_city_fingerprint(const struct city *pcity,
+                                           unsigned int player_hash)
+{
+  unsigned int hash = player_hash;
+
+  hash = adv_fingerprint_add(hash, city_map_radius_sq_get(pcity));
+  hash = adv_fingerprint_add(hash, city_size_get(pcity));
+  hash = adv_fingerprint_add(hash, city_celebrating(pcity));
+
+  city_built_iterate(pcity, pimprove) {
+    hash = adv_fingerprint_add(hash, improvement_number(pimprove));
+  } city_built_iterate_end;
+
+  return hash;
+}
+
+/**********************************************************************//**
+  Fingerprint of the tile state the tile values depend on. Neighbors
+  are included, as both the extra and effect requirements and the
+  terrain change rules can look at adjacent tiles.
+**************************************************************************/
+static unsigned int infra_tile_fingerprint(const struct civ_map *nmap,
+                                           const struct tile *ptile)
+{
+  const struct city *pworked = tile_worked(ptile);
+  const struct extra_type *presource = tile_resource(ptile);
+  unsigned int hash = ADV_FINGERPRINT_INIT;
+
+  hash = adv_fingerprint_add(hash, pworked != NULL ? pworked->id : 0);
+  hash = adv_fingerprint_add(hash, presource != NULL
+                                   ? extra_number(presource) + 1 : 0);
+
+  square_iterate(nmap, ptile, 1, ptile1) {
+    const struct player *owner = tile_owner(ptile1);
+    size_t i;
+
+    hash = adv_fingerprint_add(hash, tile_index(ptile1));
+    hash = adv_fingerprint_add(hash, terrain_number(tile_terrain(ptile1)));
+    hash = adv_fingerprint_add(hash, owner != NULL
+                                     ? player_number(owner) + 1 : 0);
+    for (i = 0; i < ARRAY_SIZE(ptile1->extras.vec); i++) {
+      hash = adv_fingerprint_add(hash, ptile1->extras.vec[i]);
+    }
+  } square_iterate_end;
+
+  return hash;
+}
+
+/**********************************************************************//**
+  Calculate the cached values of a single city tile.
+**************************************************************************/
+static void infra_tile_calc(struct city *pcity, const struct tile *ptile,
+                            int cindex)
+{
+  aw_transform_action_iterate(act) {
+    adv_city_worker_act_set(pcity, cindex, action_id_get_activity(act), -1);
+  } aw_transform_action_iterate_end;
+
+  adv_city_worker_act_set(pcity, cindex, ACTIVITY_MINE,
+                          adv_calc_plant(pcity, ptile));
+  adv_city_worker_act_set(pcity, cindex, ACTIVITY_IRRIGATE,
+                          adv_calc_cultivate(pcity, ptile));
+  adv_city_worker_act_set(pcity, cindex, ACTIVITY_TRANSFORM,
+                          adv_calc_transform(pcity, ptile));
+
+  /* road_bonus() is handled dynamically later; it takes into
+   * account settlers that have already been assigned to building
+   * roads this turn. */
+  extra_type_iterate(pextra) {
+    /* We have no use for extra value, if workers cannot be assigned
+     * to build it, so don't use time to calculate values otherwise */
+    if (pextra->buildable
+        && is_extra_caused_by_worker_action(pextra)) {
+      adv_city_worker_extra_set(pcity, cindex, pextra,
+                                adv_calc_extra(pcity, ptile, pextra));
+    } else {
+      adv_city_worker_extra_set(pcity, cindex, pextra, 0);
+    }
+    if (tile_has_extra(ptile, pextra)
+        && is_extra_removed_by_worker_action(pextra)) {
+      adv_city_worker_rmextra_set(pcity, cindex, pextra,
+                                  adv_calc_rmextra(pcity, ptile, pextra));
+    } else {
+      adv_city_worker_rmextra_set(pcity, cindex, pextra, 0);
+    }
+  } extra_type_iterate_end;
+}
+
+#ifdef INFRACACHE_VERIFY
+/**********************************************************************//**
+  Compare the cached values of the city against freshly calculated ones,
+  and log every difference found.
+**************************************************************************/
+static void infra_city_verify(const struct city *pcity)
+{
+  const struct civ_map *nmap = &(wld.map);
+  int radius_sq = city_map_radius_sq_get(pcity);
+
+  city_tile_iterate_index(nmap, radius_sq, city_tile(pcity), ptile, cindex) {
+    const struct {
+      enum unit_activity act;
+      adv_want value;
+    } acts[] = {
+      { ACTIVITY_MINE, adv_calc_plant(pcity, ptile) },
+      { ACTIVITY_IRRIGATE, adv_calc_cultivate(pcity, ptile) },
+      { ACTIVITY_TRANSFORM, adv_calc_transform(pcity, ptile) }
+    };
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(acts); i++) {
+      adv_want cached = adv_city_worker_act_get(pcity, cindex, acts[i].act);
+
+      if (cached != acts[i].value) {
+        log_error("Infrastructure cache of %s at (%d, %d): %s "
+                  "cached %g, full rebuild %g",
+                  city_name_get(pcity), TILE_XY(ptile),
+                  unit_activity_name(acts[i].act), cached, acts[i].value);
+      }
+    }
+
+    extra_type_iterate(pextra) {
+      if (pextra->buildable
+          && is_extra_caused_by_worker_action(pextra)) {
+        adv_want value = adv_calc_extra(pcity, ptile, pextra);
+        int cached = adv_city_worker_extra_get(pcity, cindex, pextra);
+
+        if (cached != (int) value) {
+          log_error("Infrastructure cache of %s at (%d, %d): build %s "
+                    "cached %d, full rebuild %d",
+                    city_name_get(pcity), TILE_XY(ptile),
+                    extra_rule_name(pextra), cached, (int) value);
+        }
+      }
+      if (tile_has_extra(ptile, pextra)
+          && is_extra_removed_by_worker_action(pextra)) {
+        adv_want value = adv_calc_rmextra(pcity, ptile, pextra);
+        int cached = adv_city_worker_rmextra_get(pcity, cindex, pextra);
+
+        if (cached != (int) value) {
+          log_error("Infrastructure cache of %s at (%d, %d): remove %s "
+                    "cached %d, full rebuild %d",
+                    city_name_get(pcity), TILE_XY(ptile),
+                    extra_rule_name(pextra), cached, (int) value);
+        }
+      }
+    } extra_type_iterate_end;
+  } city_tile_iterate_index_end;
+}
+#endif /* INFRACACHE_VERIFY */
+
 /**********************************************************************//**
   Do all tile improvement calculations and cache them for later.
 
   These values are used in settler_evaluate_improvements() so this function
   must be called before doing that. Currently this is only done when handling
   auto-workers or when the AI contemplates building worker units.
+
+  The values are kept from the previous call. If the city's own state
+  (size, buildings, celebration, or the player's government, techs and
+  wonders) has changed, all of its tiles are recalculated. Otherwise only
+  the tiles whose terrain, extras, ownership or working city changed,
+  on the tile itself or next to it, are.
 **************************************************************************/
 void initialize_infrastructure_cache(struct player *pplayer)
 {
   const struct civ_map *nmap = &(wld.map);
+  unsigned int player_hash = adv_player_fingerprint(pplayer);
+  int tiles = 0, recalculated = 0;
 
   city_list_iterate(pplayer->cities, pcity) {
+    struct adv_city *adv = pcity->server.adv;
     struct tile *pcenter = city_tile(pcity);
     int radius_sq = city_map_radius_sq_get(pcity);
+    unsigned int city_hash = infra_city_fingerprint(pcity, player_hash);
+    bool full;
+
+    if (adv->act_cache_radius_sq != radius_sq) {
+      adv_city_update(pcity);
+    }
 
-    city_map_iterate(radius_sq, city_index, city_x, city_y) {
-      aw_transform_action_iterate(act) {
-        adv_city_worker_act_set(pcity, city_index, action_id_get_activity(act),
-                                -1);
-      } aw_transform_action_iterate_end;
-    } city_map_iterate_end;
+    full = !adv->act_cache_valid || adv->act_cache_fingerprint != city_hash;
+
+    if (full) {
+      city_map_iterate(radius_sq, city_index, city_x, city_y) {
+        aw_transform_action_iterate(act) {
+          adv_city_worker_act_set(pcity, city_index,
+                                  action_id_get_activity(act), -1);
+        } aw_transform_action_iterate_end;
+      } city_map_iterate_end;
+    }
 
     city_tile_iterate_index(nmap, radius_sq, pcenter, ptile, cindex) {
-      adv_city_worker_act_set(pcity, cindex, ACTIVITY_MINE,
-                              adv_calc_plant(pcity, ptile));
-      adv_city_worker_act_set(pcity, cindex, ACTIVITY_IRRIGATE,
-                              adv_calc_cultivate(pcity, ptile));
-      adv_city_worker_act_set(pcity, cindex, ACTIVITY_TRANSFORM,
-                              adv_calc_transform(pcity, ptile));
-
-      /* road_bonus() is handled dynamically later; it takes into
-       * account settlers that have already been assigned to building
-       * roads this turn. */
-      extra_type_iterate(pextra) {
-        /* We have no use for extra value, if workers cannot be assigned
-         * to build it, so don't use time to calculate values otherwise */
-        if (pextra->buildable
-            && is_extra_caused_by_worker_action(pextra)) {
-          adv_city_worker_extra_set(pcity, cindex, pextra,
-                                    adv_calc_extra(pcity, ptile, pextra));
-        } else {
-          adv_city_worker_extra_set(pcity, cindex, pextra, 0);
-        }
-        if (tile_has_extra(ptile, pextra)
-            && is_extra_removed_by_worker_action(pextra)) {
-          adv_city_worker_rmextra_set(pcity, cindex, pextra,
-                                      adv_calc_rmextra(pcity, ptile, pextra));
-        } else {
-          adv_city_worker_rmextra_set(pcity, cindex, pextra, 0);
-        }
-      } extra_type_iterate_end;
+      unsigned int tile_hash = infra_tile_fingerprint(nmap, ptile);
+
+      tiles++;
+      if (full || adv->act_cache[cindex].fingerprint != tile_hash) {
+        infra_tile_calc(pcity, ptile, cindex);
+        adv->act_cache[cindex].fingerprint = tile_hash;
+        recalculated++;
+      }
     } city_tile_iterate_index_end;
+
+    adv->act_cache_fingerprint = city_hash;
+    adv->act_cache_valid = TRUE;
+
+#ifdef INFRACACHE_VERIFY
+    infra_city_verify(pcity);
+#endif
   } city_list_iterate_end;
+
+  log_debug("Infrastructure cache of %s: %d of %d tiles recalculated",
+            player_name(pplayer), recalculated, tiles);
 }
 
 /**********************************************************************//**
@@ -480,6 +681,7 @@ void adv_city_update(struct city *pcity)
            city_map_tiles(radius_sq)
            * sizeof(*(pcity->server.adv->act_cache)));
     pcity->server.adv->act_cache_radius_sq = radius_sq;
+    pcity->server.adv->act_cache_valid = FALSE;
   }
 }
 
@@ -492,6 +694,7 @@ void adv_city_alloc(struct city *pcity)
 
   pcity->server.adv->act_cache = NULL;
   pcity->server.adv->act_cache_radius_sq = -1;
+  pcity->server.adv->act_cache_valid = FALSE;
   /* Allocate memory for pcity->ai->act_cache */
   adv_city_update(pcity);
 }
@@ -16,6 +16,15 @@
 /* server/advisors */
 #include "advtools.h"
 
+/*
+ * The infrastructure cache is kept over turns, and only the tiles whose
+ * surroundings have changed get recalculated. Uncomment INFRACACHE_VERIFY
+ * to have every update compared against a full rebuild, with the
+ * differences logged as errors.
+ */
+
+/* #define INFRACACHE_VERIFY */
+
 struct player;
 
 struct adv_city {
@@ -24,6 +33,11 @@ struct adv_city {
   struct worker_activity_cache *act_cache;
   int act_cache_radius_sq;
 
+  /* Whether act_cache holds values calculated for the city state
+   * described by act_cache_fingerprint. */
+  bool act_cache_valid;
+  unsigned int act_cache_fingerprint;
+
   /* Building desirabilities - easiest to handle them here -- Syela */
   /* The units of building_want are output
    * (shields/gold/luxuries) multiplied by a priority
@@ -35,6 +49,21 @@ struct adv_city {
                                  * wonders wisely */
 };
 
+/* Fingerprints summarize the state cached values were calculated from,
+ * so that the values are recalculated only once it changes. */
+#define ADV_FINGERPRINT_INIT 2166136261u
+
+/**********************************************************************//**
+  Mix value into the fingerprint hash.
+**************************************************************************/
+static inline unsigned int adv_fingerprint_add(unsigned int hash,
+                                               unsigned int value)
+{
+  return (hash ^ value) * 16777619u;
+}
+
+unsigned int adv_player_fingerprint(const struct player *pplayer);
+
 void adv_city_alloc(struct city *pcity);
 void adv_city_free(struct city *pcity);
 
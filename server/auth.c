@@ -62,6 +62,11 @@ static const int auth_fail_wait[] = { 1, 1, 2, 3 };
 static bool is_guest_name(const char *name);
 static void get_unique_guest_name(char *name);
 static bool is_good_password(const char *password, char *msg);
+static bool auth_user_exists_done(struct connection *pconn, bool success,
+                                  bool exists);
+static void auth_user_save_done(struct connection *pconn, bool success);
+static void auth_user_verify_done(struct connection *pconn, bool success,
+                                  bool verified);
 
 /************************************************************************//**
   Handle authentication of a user; called by handle_login_request() if
@@ -97,57 +102,25 @@ bool auth_user(struct connection *pconn, char *username)
   } else {
     /* We are not a guest, we need an extra check as to whether a
      * connection can be established: the client must authenticate itself */
-    char buffer[MAX_LEN_MSG];
     bool exists = FALSE;
+    bool success;
 
     sz_strlcpy(pconn->username, username);
 
-    if (!script_fcdb_call("user_exists", pconn, &exists)) {
-      if (srvarg.auth_allow_guests) {
-        sz_strlcpy(tmpname, pconn->username);
-        get_unique_guest_name(tmpname); /* Don't pass pconn->username here */
-        sz_strlcpy(pconn->username, tmpname);
-
-        log_error("Error reading database; connection -> guest");
-        notify_conn_early(pconn->self, NULL, E_CONNECTION, ftc_warning,
-                          _("There was an error reading the user "
-                            "database, logging in as guest connection '%s'."),
-                          pconn->username);
-        establish_new_connection(pconn);
-      } else {
-        reject_new_connection(_("There was an error reading the user database "
-                                "and guest logins are not allowed. Sorry"),
-                              pconn);
-        log_normal(_("%s was rejected: Database error and guests not "
-                     "allowed."), pconn->username);
-        return FALSE;
-      }
-    } else if (exists) {
-      /* We found a user */
-      fc_snprintf(buffer, sizeof(buffer), _("Enter password for %s:"),
-                  pconn->username);
-      dsend_packet_authentication_req(pconn, AUTH_LOGIN_FIRST, buffer);
+    if (script_fcdb_auth_async()) {
+      /* Wait for the answer in AS_REQUESTING_OLD_PASS, so that the usual
+       * timeout applies. auth_user_exists_done() switches new users
+       * to AS_REQUESTING_NEW_PASS. */
+      script_fcdb_auth_queue(pconn, FCDB_USER_EXISTS, NULL);
+      pconn->server.auth_pending = TRUE;
       pconn->server.auth_settime = time(NULL);
       pconn->server.status = AS_REQUESTING_OLD_PASS;
-      log_debug("Password for %s requested.", pconn->username);
-    } else {
-      /* We couldn't find the user, they are new */
-      if (srvarg.auth_allow_newusers) {
-        /* TRANS: Try not to make the translation much longer than the original. */
-        sz_strlcpy(buffer, _("First time login. Set a new password and confirm it."));
-        dsend_packet_authentication_req(pconn, AUTH_NEWUSER_FIRST, buffer);
-        pconn->server.auth_settime = time(NULL);
-        pconn->server.status = AS_REQUESTING_NEW_PASS;
-        log_verbose(_("Registration for %s requested."), pconn->username);
-      } else {
-        reject_new_connection(_("This server allows only preregistered "
-                                "users. Sorry."), pconn);
-        log_normal(_("%s was rejected: Only preregistered users allowed."),
-                   pconn->username);
-
-        return FALSE;
-      }
+      return TRUE;
     }
+
+    success = script_fcdb_call("user_exists", pconn, &exists);
+
+    return auth_user_exists_done(pconn, success, exists);
   }
 
   return TRUE;
@@ -160,6 +133,12 @@ bool auth_handle_reply(struct connection *pconn, char *password)
 {
   char msg[MAX_LEN_MSG];
 
+  if (pconn->server.auth_pending) {
+    log_verbose("%s is sending auth packets while the previous one is "
+                "being checked", pconn->username);
+    return TRUE;
+  }
+
   if (pconn->server.status == AS_REQUESTING_NEW_PASS) {
 
     /* Check if the new password is acceptable */
@@ -176,27 +155,23 @@ bool auth_handle_reply(struct connection *pconn, char *password)
       }
     }
 
-    if (!script_fcdb_call("user_save", pconn, password)) {
-      notify_conn(pconn->self, NULL, E_CONNECTION, ftc_warning,
-                  _("Warning: There was an error in saving to the database. "
-                    "Continuing, but your stats will not be saved."));
-      log_error(_("Error writing to database for: %s"), pconn->username);
+    if (script_fcdb_auth_async()) {
+      script_fcdb_auth_queue(pconn, FCDB_USER_SAVE, password);
+      pconn->server.auth_pending = TRUE;
     } else {
-      log_normal(_("%s registered."), pconn->username);
+      auth_user_save_done(pconn,
+                          script_fcdb_call("user_save", pconn, password));
     }
-
-    establish_new_connection(pconn);
   } else if (pconn->server.status == AS_REQUESTING_OLD_PASS) {
-    bool success = FALSE;
-
-    if (script_fcdb_call("user_verify", pconn, password, &success)
-        && success) {
-      establish_new_connection(pconn);
+    if (script_fcdb_auth_async()) {
+      script_fcdb_auth_queue(pconn, FCDB_USER_VERIFY, password);
+      pconn->server.auth_pending = TRUE;
     } else {
-      pconn->server.status = AS_FAILED;
-      pconn->server.auth_tries++;
-      pconn->server.auth_settime = time(NULL)
-                                   + auth_fail_wait[pconn->server.auth_tries];
+      bool verified = FALSE;
+      bool success = script_fcdb_call("user_verify", pconn, password,
+                                      &verified);
+
+      auth_user_verify_done(pconn, success, verified);
     }
   } else {
     log_verbose("%s is sending unrequested auth packets", pconn->username);
@@ -206,6 +181,53 @@ bool auth_handle_reply(struct connection *pconn, char *password)
   return TRUE;
 }
 
+/************************************************************************//**
+  Handle the authentication calls the fcdb worker has finished. Called
+  from the main loop.
+****************************************************************************/
+void auth_process_results(void)
+{
+  struct fcdb_auth_result result;
+
+  while (script_fcdb_auth_result(&result)) {
+    struct connection *pconn = conn_by_number(result.conn_id);
+
+    if (pconn == NULL || pconn->server.is_closing
+        || !pconn->server.auth_pending) {
+      /* The connection went away or timed out meanwhile. */
+      continue;
+    }
+
+    pconn->server.auth_pending = FALSE;
+    if (result.access_set) {
+      conn_set_access(pconn, result.access_level, TRUE);
+    }
+
+    switch (result.call) {
+    case FCDB_USER_EXISTS:
+      if (!auth_user_exists_done(pconn, result.success, result.value)) {
+        connection_close_server(pconn, _("rejected"));
+      }
+      break;
+    case FCDB_USER_VERIFY:
+      auth_user_verify_done(pconn, result.success, result.value);
+      break;
+    case FCDB_USER_SAVE:
+      auth_user_save_done(pconn, result.success);
+      break;
+    }
+  }
+}
+
+/************************************************************************//**
+  Whether the fcdb worker still owes results to be handled by
+  auth_process_results().
+****************************************************************************/
+bool auth_results_pending(void)
+{
+  return script_fcdb_auth_pending();
+}
+
 /************************************************************************//**
   Checks on where in the authentication process we are.
 ****************************************************************************/
@@ -256,6 +278,101 @@ void auth_process_status(struct connection *pconn)
   }
 }
 
+/************************************************************************//**
+  Continue the login of a registered or new user once user_exists() has
+  been called. Returns FALSE if the connection got rejected.
+****************************************************************************/
+static bool auth_user_exists_done(struct connection *pconn, bool success,
+                                  bool exists)
+{
+  char buffer[MAX_LEN_MSG];
+
+  if (!success) {
+    if (srvarg.auth_allow_guests) {
+      char tmpname[MAX_LEN_NAME];
+
+      sz_strlcpy(tmpname, pconn->username);
+      get_unique_guest_name(tmpname); /* Don't pass pconn->username here */
+      sz_strlcpy(pconn->username, tmpname);
+
+      log_error("Error reading database; connection -> guest");
+      notify_conn_early(pconn->self, NULL, E_CONNECTION, ftc_warning,
+                        _("There was an error reading the user "
+                          "database, logging in as guest connection '%s'."),
+                        pconn->username);
+      establish_new_connection(pconn);
+    } else {
+      reject_new_connection(_("There was an error reading the user database "
+                              "and guest logins are not allowed. Sorry"),
+                            pconn);
+      log_normal(_("%s was rejected: Database error and guests not "
+                   "allowed."), pconn->username);
+      return FALSE;
+    }
+  } else if (exists) {
+    /* We found a user */
+    fc_snprintf(buffer, sizeof(buffer), _("Enter password for %s:"),
+                pconn->username);
+    dsend_packet_authentication_req(pconn, AUTH_LOGIN_FIRST, buffer);
+    pconn->server.auth_settime = time(NULL);
+    pconn->server.status = AS_REQUESTING_OLD_PASS;
+    log_debug("Password for %s requested.", pconn->username);
+  } else {
+    /* We couldn't find the user, they are new */
+    if (srvarg.auth_allow_newusers) {
+      /* TRANS: Try not to make the translation much longer than the original. */
+      sz_strlcpy(buffer, _("First time login. Set a new password and confirm it."));
+      dsend_packet_authentication_req(pconn, AUTH_NEWUSER_FIRST, buffer);
+      pconn->server.auth_settime = time(NULL);
+      pconn->server.status = AS_REQUESTING_NEW_PASS;
+      log_verbose(_("Registration for %s requested."), pconn->username);
+    } else {
+      reject_new_connection(_("This server allows only preregistered "
+                              "users. Sorry."), pconn);
+      log_normal(_("%s was rejected: Only preregistered users allowed."),
+                 pconn->username);
+
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/************************************************************************//**
+  Finish the registration of a new user once user_save() has been called.
+****************************************************************************/
+static void auth_user_save_done(struct connection *pconn, bool success)
+{
+  if (!success) {
+    notify_conn(pconn->self, NULL, E_CONNECTION, ftc_warning,
+                _("Warning: There was an error in saving to the database. "
+                  "Continuing, but your stats will not be saved."));
+    log_error(_("Error writing to database for: %s"), pconn->username);
+  } else {
+    log_normal(_("%s registered."), pconn->username);
+  }
+
+  establish_new_connection(pconn);
+}
+
+/************************************************************************//**
+  Accept the connection or throttle the next try once user_verify() has
+  been called.
+****************************************************************************/
+static void auth_user_verify_done(struct connection *pconn, bool success,
+                                  bool verified)
+{
+  if (success && verified) {
+    establish_new_connection(pconn);
+  } else {
+    pconn->server.status = AS_FAILED;
+    pconn->server.auth_tries++;
+    pconn->server.auth_settime = time(NULL)
+                                 + auth_fail_wait[pconn->server.auth_tries];
+  }
+}
+
 /************************************************************************//**
   See if the name qualifies as a guest login name
 ****************************************************************************/
@@ -100,6 +100,12 @@ static struct city_list *arrange_workers_queue = nullptr;
 /* Suppress sending cities during game_load() and end_phase() */
 static bool send_city_suppressed = FALSE;
 
+/* While frozen, city info sent to everyone or to the owner is queued
+ * and sent only once per city when thawed. */
+static int city_info_frozen = 0;
+static struct city_list *city_info_queue = nullptr;
+static int city_info_coalesced = 0;
+
 static bool city_workers_queue_remove(struct city *pcity);
 
 static void announce_trade_route_removal(struct city *pc1, struct city *pc2,
@@ -1880,6 +1886,9 @@ void remove_city(struct city *pcity)
 
   map_clear_border(pcenter);
   city_workers_queue_remove(pcity);
+  if (pcity->server.info_pending) {
+    city_list_remove(city_info_queue, pcity);
+  }
   city_thaw_workers_queue();
   city_refresh_queue_processing();
 
@@ -2367,6 +2376,9 @@ void send_player_cities(struct player *pplayer)
   A wrapper, accessing either broadcast_city_info() (dest == nullptr),
   or a convenience case of send_city_info_at_tile().
   Must specify non-nullptr pcity.
+
+  While city info sending is frozen, info for everyone or for the owner
+  is only queued; see city_info_freeze().
 ****************************************************************************/
 void send_city_info(struct player *dest, struct city *pcity)
 {
@@ -2382,6 +2394,27 @@ void send_city_info(struct player *dest, struct city *pcity)
 
   if (!dest || dest == powner) {
     pcity->server.synced = TRUE;
+
+    /* A city the clients have never heard of is sent right away, as
+     * the packets that follow may refer to it. */
+    if (city_info_frozen > 0 && pcity->server.info_sent) {
+      if (pcity->server.info_pending) {
+        city_info_coalesced++;
+      } else {
+        if (city_info_queue == nullptr) {
+          city_info_queue = city_list_new();
+        }
+        city_list_append(city_info_queue, pcity);
+        pcity->server.info_pending = TRUE;
+      }
+      if (!dest) {
+        pcity->server.info_broadcast = TRUE;
+      }
+
+      return;
+    }
+
+    pcity->server.info_sent = TRUE;
   }
 
   if (!dest) {
@@ -2400,6 +2433,57 @@ void send_city_info(struct player *dest, struct city *pcity)
   }
 }
 
+/************************************************************************//**
+  Start collecting the city info sends, so that a city changed several
+  times gets sent only once. Calls nest; the queued info is sent when
+  the outermost city_info_thaw() is called.
+****************************************************************************/
+void city_info_freeze(void)
+{
+  city_info_frozen++;
+}
+
+/************************************************************************//**
+  Send the city info queued since the matching city_info_freeze().
+****************************************************************************/
+void city_info_thaw(void)
+{
+  struct city_list *queue;
+
+  fc_assert_ret(city_info_frozen > 0);
+
+  if (--city_info_frozen > 0 || city_info_queue == nullptr) {
+    return;
+  }
+
+  /* Nothing is frozen any more, so the sends below go out directly. */
+  queue = city_info_queue;
+  city_info_queue = nullptr;
+
+  city_list_iterate(queue, pcity) {
+    bool broadcast = pcity->server.info_broadcast;
+
+    pcity->server.info_pending = FALSE;
+    pcity->server.info_broadcast = FALSE;
+    send_city_info(broadcast ? nullptr : city_owner(pcity), pcity);
+  } city_list_iterate_end;
+
+  city_list_destroy(queue);
+}
+
+/************************************************************************//**
+  Return the number of city info sends saved by queueing since the last
+  call.
+****************************************************************************/
+int city_info_coalesced_count(void)
+{
+  int count = city_info_coalesced;
+
+  city_info_coalesced = 0;
+
+  return count;
+}
+
 /************************************************************************//**
   Send info about a city, as seen by pviewer, to dest (usually dest will
   be pviewer->connections). If pplayer can see the city we update the city
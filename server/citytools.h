@@ -47,6 +47,9 @@ bool unit_conquer_city(struct unit *punit, struct city *pcity);
 
 bool send_city_suppression(bool now);
 void send_city_info(struct player *dest, struct city *pcity);
+void city_info_freeze(void);
+void city_info_thaw(void);
+int city_info_coalesced_count(void);
 void send_city_info_at_tile(struct player *pviewer, struct conn_list *dest,
                             struct city *pcity, struct tile *ptile);
 void send_all_known_cities(struct conn_list *dest);
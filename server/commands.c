@@ -617,15 +617,21 @@ static struct command commands[] = {
       "lua unsafe-cmd <script line>\n"
       "lua file <script file>\n"
       "lua unsafe-file <script file>\n"
+      "lua profile [on|off]\n"
       "lua <script line> (deprecated)"),
    N_("Evaluate a line of Freeciv script or a Freeciv script file in the "
       "current game."),
-   /* TRANS: Do not translate 'unsafe' or 'hack' */
+   /* TRANS: Do not translate 'unsafe', 'hack', 'lua profile', 'on'
+    * or 'off' */
    N_("Subcommands with the 'unsafe' prefix run the script in an instance "
       "separate from the ruleset. This instance doesn't restrict access "
       "to Lua functions that can be used to hack the computer running "
       "the Freeciv server. Access to it is therefore limited to the console "
-      "and connections with cmdlevel 'hack'"), NULL,
+      "and connections with cmdlevel 'hack'.\n"
+      "'lua profile on' starts counting the calls and the time used by "
+      "each signal callback, 'lua profile off' stops it, and 'lua "
+      "profile' shows the callbacks called so far, the slowest first."),
+   NULL,
    CMD_ECHO_ADMINS, VCF_NONE, 0
   },
   {"kick", ALLOW_CTRL,
@@ -692,6 +698,22 @@ static struct command commands[] = {
    NULL, mapimg_help,
    CMD_ECHO_ADMINS, VCF_NONE, 50
   },
+  {"profile",   ALLOW_HACK,
+   /* TRANS: translate text between <> only */
+   N_("profile start [<file>]\n"
+      "profile stop\n"
+      "profile save <file>\n"
+      "profile status"),
+   N_("Profile where the server spends its time."),
+   N_("While profiling, the wall time of the turn phases, the AI, path "
+      "finding, the city governor and savegames is collected per turn. "
+      "'profile save' writes it to a file: with the extension '.json' "
+      "as a trace in Chrome trace-event format, otherwise as per-turn "
+      "statistics in csv. A file given to 'profile start' gets written "
+      "when profiling stops, at the latest when the server exits."),
+   NULL,
+   CMD_ECHO_ADMINS, VCF_NONE, 0
+  },
   {"lock",   ALLOW_HACK,
    /* TRANS: translate text between <> only */
    N_("lock <setting>"),
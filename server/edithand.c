@@ -1300,6 +1300,7 @@ void handle_edit_player_vision(struct connection *pc, int plr_no,
 ****************************************************************************/
 void handle_edit_recalculate_borders(struct connection *pc)
 {
+  map_borders_invalidate();
   map_calculate_borders();
 }
 
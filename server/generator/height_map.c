@@ -94,6 +94,26 @@ void renormalize_hmap_poles(void)
   } whole_map_iterate_end;
 }
 
+/* Tiles of the height map that get random noise from one random state.
+ * Fixed, so the noise does not depend on the number of threads. */
+#define HMAP_NOISE_CHUNK 16384
+#define HMAP_NOISE_CHUNKS \
+  ((MAP_INDEX_SIZE + HMAP_NOISE_CHUNK - 1) / HMAP_NOISE_CHUNK)
+
+/**********************************************************************//**
+  Fill one chunk of the height map with uncorrelated random values.
+**************************************************************************/
+static void random_hmap_chunk(int chunk, void *data)
+{
+  const int smooth = *(const int *) data;
+  int last = MIN((chunk + 1) * HMAP_NOISE_CHUNK, MAP_INDEX_SIZE);
+  int idx;
+
+  for (idx = chunk * HMAP_NOISE_CHUNK; idx < last; idx++) {
+    height_map[idx] = fc_rand(1000 * smooth);
+  }
+}
+
 /**********************************************************************//**
   Create uncorrelated rand map and do some call to smoth to correlate
   it a little and create random shapes
@@ -103,7 +123,8 @@ void make_random_hmap(int smooth)
   int i = 0;
   height_map = fc_malloc(sizeof(*height_map) * MAP_INDEX_SIZE);
 
-  INITIALIZE_ARRAY(height_map, MAP_INDEX_SIZE, fc_rand(1000 * smooth));
+  parallel_rand_jobs_run(HMAP_NOISE_CHUNKS, mapgen_map_threads(),
+                         random_hmap_chunk, &smooth);
 
   for (; i < smooth; i++) {
     smooth_int_map(height_map, TRUE);
@@ -181,6 +202,57 @@ static void gen5rec(int step, int xl, int yt, int xr, int yb)
   gen5rec(2 * step / 3, (xr + xl) / 2, (yb + yt) / 2, xr, yb);
 }
 
+struct gen5_blocks {
+  int xdiv, ydiv;
+  int xmax, ymax;
+  int step;
+  int num;
+  int (*coords)[2];             /* Block numbers in x and y directions */
+};
+
+/**********************************************************************//**
+  Run gen5rec() on one of the blocks of make_pseudofractal1_hmap().
+**************************************************************************/
+static void gen5rec_block(int job, void *data)
+{
+  const struct gen5_blocks *blocks = data;
+  int x = blocks->coords[job][0];
+  int y = blocks->coords[job][1];
+
+  gen5rec(blocks->step, x * blocks->xmax / blocks->xdiv,
+          y * blocks->ymax / blocks->ydiv,
+          (x + 1) * blocks->xmax / blocks->xdiv,
+          (y + 1) * blocks->ymax / blocks->ydiv);
+}
+
+/**********************************************************************//**
+  Group of block number 'num' out of 'div' blocks along one axis.
+  Neighboring blocks share the points of their common edge, so they
+  always get different groups. Blocks at both ends also touch each
+  other when the map wraps.
+**************************************************************************/
+static int gen5_block_group(int num, int div, bool wrap)
+{
+  if (wrap && div % 2 == 1 && num == div - 1) {
+    return 2;
+  }
+
+  return num % 2;
+}
+
+/**********************************************************************//**
+  Add random fuzz to one chunk of the height map.
+**************************************************************************/
+static void gen5_fuzz_chunk(int chunk, void *data)
+{
+  int last = MIN((chunk + 1) * HMAP_NOISE_CHUNK, MAP_INDEX_SIZE);
+  int idx;
+
+  for (idx = chunk * HMAP_NOISE_CHUNK; idx < last; idx++) {
+    height_map[idx] = 8 * height_map[idx] + fc_rand(4) - 2;
+  }
+}
+
 /**********************************************************************//**
   Generator 5 makes earthlike worlds with one or more large continents and
   a scattering of smaller islands. It does so by dividing the world into
@@ -213,6 +285,8 @@ void make_pseudofractal1_hmap(int extra_div)
   int xmax = MAP_NATIVE_WIDTH - (xnowrap ? 1 : 0);
   int ymax = MAP_NATIVE_HEIGHT - (ynowrap ? 1 : 0);
   int x_current, y_current;
+  int xgroup, ygroup;
+  struct gen5_blocks blocks;
   /* Just need something > log(max(xsize, ysize)) for the recursion */
   int step = MAP_NATIVE_WIDTH + MAP_NATIVE_HEIGHT;
   /* Edges are avoided more strongly as this increases */
@@ -244,18 +318,38 @@ void make_pseudofractal1_hmap(int extra_div)
     }
   }
 
-  /* Calculate recursively on each block */
-  for (x_current = 0; x_current < xdiv; x_current++) {
-    for (y_current = 0; y_current < ydiv; y_current++) {
-      gen5rec(step, x_current * xmax / xdiv, y_current * ymax / ydiv,
-              (x_current + 1) * xmax / xdiv, (y_current + 1) * ymax / ydiv);
+  /* Calculate recursively on each block. Blocks of the same group do
+   * not touch each other, so they can be done in parallel. */
+  blocks.xdiv = xdiv;
+  blocks.ydiv = ydiv;
+  blocks.xmax = xmax;
+  blocks.ymax = ymax;
+  blocks.step = step;
+  blocks.coords = fc_malloc(xdiv * ydiv * sizeof(*blocks.coords));
+  for (xgroup = 0; xgroup < 3; xgroup++) {
+    for (ygroup = 0; ygroup < 3; ygroup++) {
+      blocks.num = 0;
+      for (x_current = 0; x_current < xdiv; x_current++) {
+        for (y_current = 0; y_current < ydiv; y_current++) {
+          if (gen5_block_group(x_current, xdiv, !xnowrap) == xgroup
+              && gen5_block_group(y_current, ydiv, !ynowrap) == ygroup) {
+            blocks.coords[blocks.num][0] = x_current;
+            blocks.coords[blocks.num][1] = y_current;
+            blocks.num++;
+          }
+        }
+      }
+      if (blocks.num > 0) {
+        parallel_rand_jobs_run(blocks.num, mapgen_map_threads(),
+                               gen5rec_block, &blocks);
+      }
     }
   }
+  free(blocks.coords);
 
   /* Put in some random fuzz */
-  whole_map_iterate(&(wld.map), ptile) {
-    hmap(ptile) = 8 * hmap(ptile) + fc_rand(4) - 2;
-  } whole_map_iterate_end;
+  parallel_rand_jobs_run(HMAP_NOISE_CHUNKS, mapgen_map_threads(),
+                         gen5_fuzz_chunk, nullptr);
 
   adjust_int_map(height_map, 0, hmap_max_level);
 }
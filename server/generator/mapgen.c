@@ -15,6 +15,7 @@
 #include <fc_config.h>
 #endif
 
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -3389,6 +3390,223 @@ static struct fair_tile *fair_map_island_new(int size, int startpos_num)
   return pisland;
 }
 
+struct fair_attempts {
+  const struct fair_tile *ptemplate;    /* The map before any island */
+  int players_per_island;
+  int teams_num;
+  int team_players_num;
+  int min_island_size;
+  int islandmass1, islandmass2, islandmass3; /* Of the first attempt */
+  atomic_int first_success;             /* Lowest attempt that succeeded */
+  struct fair_tile **results;           /* Map of each attempt, or nullptr */
+};
+
+/**********************************************************************//**
+  Make attempt number 'attempt' at placing the islands of all the players
+  on a copy of the template map. Every attempt uses a bit less land mass
+  than the previous one, for better chances. Returns the map, or nullptr
+  if the islands did not fit.
+**************************************************************************/
+static struct fair_tile *fair_map_attempt(const struct fair_attempts *attempts,
+                                          int attempt)
+{
+  struct fair_tile *pmap, *pisland;
+  int players_per_island = attempts->players_per_island;
+  int teams_num = attempts->teams_num;
+  int team_players_num = attempts->team_players_num;
+  int islandmass1 = attempts->islandmass1;
+  int islandmass2 = attempts->islandmass2;
+  int islandmass3 = attempts->islandmass3;
+  int i;
+  bool done = TRUE;
+
+  for (i = 0; i < attempt; i++) {
+    islandmass1 = MAX((islandmass1 * 99) / 100, attempts->min_island_size);
+    islandmass2 = MAX((islandmass2 * 99) / 100, attempts->min_island_size);
+    islandmass3 = MAX((islandmass3 * 99) / 100, attempts->min_island_size);
+  }
+
+  pmap = fair_map_new();
+  memcpy(pmap, attempts->ptemplate, MAP_INDEX_SIZE * sizeof(*pmap));
+
+  /* Create main player island. */
+  log_debug("Making main island.");
+  pisland = fair_map_island_new(islandmass1, players_per_island);
+
+  log_debug("Place main islands on the map.");
+  i = 0;
+
+  if (wld.map.server.team_placement != TEAM_PLACEMENT_DISABLED
+      && team_players_num > 0) {
+    /* Do team placement. Attempts may run in threads with small stacks,
+     * so the outwards indices go to the heap. */
+    struct iter_index *outwards_indices
+      = fc_malloc(MAP_NUM_ITERATE_OUTWARDS_INDICES
+                  * sizeof(*outwards_indices));
+    int start_x[teams_num], start_y[teams_num];
+    int dx = 0, dy = 0;
+    int j, k;
+
+    /* Build outwards_indices. */
+    memcpy(outwards_indices, MAP_ITERATE_OUTWARDS_INDICES,
+           MAP_NUM_ITERATE_OUTWARDS_INDICES * sizeof(*outwards_indices));
+    switch (wld.map.server.team_placement) {
+    case TEAM_PLACEMENT_DISABLED:
+      fc_assert(wld.map.server.team_placement != TEAM_PLACEMENT_DISABLED);
+      break;
+    case TEAM_PLACEMENT_CLOSEST:
+    case TEAM_PLACEMENT_CONTINENT:
+      for (j = 0; j < MAP_NUM_ITERATE_OUTWARDS_INDICES; j++) {
+        /* We want square distances for comparing. */
+        outwards_indices[j].dist =
+            map_vector_to_sq_distance(outwards_indices[j].dx,
+                                      outwards_indices[j].dy);
+      }
+      qsort(outwards_indices, MAP_NUM_ITERATE_OUTWARDS_INDICES,
+            sizeof(outwards_indices[0]), fair_team_placement_closest);
+      break;
+    case TEAM_PLACEMENT_HORIZONTAL:
+      qsort(outwards_indices, MAP_NUM_ITERATE_OUTWARDS_INDICES,
+            sizeof(outwards_indices[0]), fair_team_placement_horizontal);
+      break;
+    case TEAM_PLACEMENT_VERTICAL:
+      qsort(outwards_indices, MAP_NUM_ITERATE_OUTWARDS_INDICES,
+            sizeof(outwards_indices[0]), fair_team_placement_vertical);
+      break;
+    }
+
+    /* Make start point for teams. */
+    if (current_wrap_has_flag(WRAP_X)) {
+      dx = fc_rand(MAP_NATIVE_WIDTH);
+    }
+    if (current_wrap_has_flag(WRAP_Y)) {
+      dy = fc_rand(MAP_NATIVE_HEIGHT);
+    }
+    for (j = 0; j < teams_num; j++) {
+      start_x[j] = (MAP_NATIVE_WIDTH * (2 * j + 1)) / (2 * teams_num) + dx;
+      start_y[j] = (MAP_NATIVE_HEIGHT * (2 * j + 1)) / (2 * teams_num) + dy;
+      if (current_wrap_has_flag(WRAP_X)) {
+        start_x[j] = FC_WRAP(start_x[j], MAP_NATIVE_WIDTH);
+      }
+      if (current_wrap_has_flag(WRAP_Y)) {
+        start_y[j] = FC_WRAP(start_y[j], MAP_NATIVE_HEIGHT);
+      }
+    }
+    /* Randomize. */
+    array_shuffle(start_x, teams_num);
+    array_shuffle(start_y, teams_num);
+
+    j = 0;
+    teams_iterate(pteam) {
+      int members_count = player_list_size(team_members(pteam));
+      int team_id;
+      int x, y;
+
+      if (members_count <= 1) {
+        continue;
+      }
+      team_id = team_number(pteam);
+
+      NATIVE_TO_MAP_POS(&x, &y, start_x[j], start_y[j]);
+      log_verbose("Team %d (%s) will start on (%d, %d)",
+                  team_id, team_rule_name(pteam), x, y);
+
+      for (k = 0; k < members_count; k += players_per_island) {
+        if (!fair_map_place_island_team(pmap, x, y, pisland,
+                                        outwards_indices, team_id)) {
+          log_verbose("Failed to place island number %d for team %d (%s).",
+                      k, team_id, team_rule_name(pteam));
+          done = FALSE;
+          break;
+        }
+      }
+      if (!done) {
+        break;
+      }
+      i += k;
+      j++;
+    } teams_iterate_end;
+
+    free(outwards_indices);
+
+    fc_assert(!done || i == team_players_num);
+  }
+
+  if (done) {
+    /* Place last player islands. */
+    for (; i < player_count(); i += players_per_island) {
+      if (!fair_map_place_island_rand(pmap, pisland)) {
+        log_verbose("Failed to place island number %d.", i);
+        done = FALSE;
+        break;
+      }
+    }
+    fc_assert(!done || i == player_count());
+  }
+  fair_map_destroy(pisland);
+
+  if (done) {
+    log_debug("Create and place small islands on the map.");
+    for (i = 0; i < player_count(); i++) {
+      pisland = fair_map_island_new(islandmass2, 0);
+      if (!fair_map_place_island_rand(pmap, pisland)) {
+        log_verbose("Failed to place small island2 number %d.", i);
+        done = FALSE;
+        fair_map_destroy(pisland);
+        break;
+      }
+      fair_map_destroy(pisland);
+    }
+  }
+  if (done) {
+    for (i = 0; i < player_count(); i++) {
+      pisland = fair_map_island_new(islandmass3, 0);
+      if (!fair_map_place_island_rand(pmap, pisland)) {
+        log_verbose("Failed to place small island3 number %d.", i);
+        done = FALSE;
+        fair_map_destroy(pisland);
+        break;
+      }
+      fair_map_destroy(pisland);
+    }
+  }
+
+  if (!done) {
+    fair_map_destroy(pmap);
+    return nullptr;
+  }
+
+  return pmap;
+}
+
+/**********************************************************************//**
+  Job function running the attempts of map_generate_fair_islands().
+  Attempts after one that already succeeded are skipped, as only the
+  first successful attempt is used.
+**************************************************************************/
+static void fair_map_attempt_job(int attempt, void *data)
+{
+  struct fair_attempts *attempts = data;
+  int first;
+
+  if (attempt > atomic_load(&attempts->first_success)) {
+    attempts->results[attempt] = nullptr;
+    return;
+  }
+
+  attempts->results[attempt] = fair_map_attempt(attempts, attempt);
+  if (attempts->results[attempt] == nullptr) {
+    return;
+  }
+
+  first = atomic_load(&attempts->first_success);
+  while (attempt < first
+         && !atomic_compare_exchange_weak(&attempts->first_success,
+                                          &first, attempt)) {
+    /* Another attempt succeeded meanwhile, compare again. */
+  }
+}
+
 /**********************************************************************//**
   Build a map using generator 'FAIR'.
 **************************************************************************/
@@ -3396,13 +3614,13 @@ static bool map_generate_fair_islands(void)
 {
   struct terrain *deepest_ocean
     = pick_ocean(TERRAIN_OCEAN_DEPTH_MAXIMUM, FALSE);
-  struct fair_tile *pmap, *pisland;
+  struct fair_tile *pmap, *ptemplate;
+  struct fair_attempts attempts;
   int playermass, islandmass1 , islandmass2, islandmass3;
   int min_island_size = wld.map.server.tinyisles ? 1 : 2;
   int players_per_island = 1;
   int teams_num = 0, team_players_num = 0, single_players_num = 0;
   int i, iter = CLIP(1, 100000 / map_num_tiles(), 10);
-  bool done = FALSE;
 
   teams_iterate(pteam) {
     i = player_list_size(team_members(pteam));
@@ -3524,190 +3742,57 @@ static bool map_generate_fair_islands(void)
   log_debug("playermass=%d, islandmass1=%d, islandmass2=%d, islandmass3=%d",
             playermass, islandmass1, islandmass2, islandmass3);
 
-  pmap = fair_map_new();
-
-  while (--iter >= 0) {
-    done = TRUE;
-
-    whole_map_iterate(&(wld.map), ptile) {
-      struct fair_tile *pftile = pmap + tile_index(ptile);
-
-      if (tile_terrain(ptile) != deepest_ocean) {
-        pftile->flags |= (FTF_ASSIGNED | FTF_NO_HUT);
-        adjc_iterate(&(wld.map), ptile, atile) {
-          struct fair_tile *aftile = pmap + tile_index(atile);
-
-          if (!(aftile->flags & FTF_ASSIGNED)
-              && tile_terrain(atile) == deepest_ocean) {
-            aftile->flags |= FTF_OCEAN;
-          }
-        } adjc_iterate_end;
-      }
-      pftile->pterrain = tile_terrain(ptile);
-      pftile->presource = tile_resource(ptile);
-      pftile->extras = *tile_extras(ptile);
-    } whole_map_iterate_end;
-
-    /* Create main player island. */
-    log_debug("Making main island.");
-    pisland = fair_map_island_new(islandmass1, players_per_island);
-
-    log_debug("Place main islands on the map.");
-    i = 0;
-
-    if (wld.map.server.team_placement != TEAM_PLACEMENT_DISABLED
-        && team_players_num > 0) {
-      /* Do team placement. */
-      struct iter_index outwards_indices[MAP_NUM_ITERATE_OUTWARDS_INDICES];
-      int start_x[teams_num], start_y[teams_num];
-      int dx = 0, dy = 0;
-      int j, k;
-
-      /* Build outwards_indices. */
-      memcpy(outwards_indices, MAP_ITERATE_OUTWARDS_INDICES,
-             sizeof(outwards_indices));
-      switch (wld.map.server.team_placement) {
-      case TEAM_PLACEMENT_DISABLED:
-        fc_assert(wld.map.server.team_placement != TEAM_PLACEMENT_DISABLED);
-        break;
-      case TEAM_PLACEMENT_CLOSEST:
-      case TEAM_PLACEMENT_CONTINENT:
-        for (j = 0; j < MAP_NUM_ITERATE_OUTWARDS_INDICES; j++) {
-          /* We want square distances for comparing. */
-          outwards_indices[j].dist =
-              map_vector_to_sq_distance(outwards_indices[j].dx,
-                                        outwards_indices[j].dy);
-        }
-        qsort(outwards_indices, MAP_NUM_ITERATE_OUTWARDS_INDICES,
-              sizeof(outwards_indices[0]), fair_team_placement_closest);
-        break;
-      case TEAM_PLACEMENT_HORIZONTAL:
-        qsort(outwards_indices, MAP_NUM_ITERATE_OUTWARDS_INDICES,
-              sizeof(outwards_indices[0]), fair_team_placement_horizontal);
-        break;
-      case TEAM_PLACEMENT_VERTICAL:
-        qsort(outwards_indices, MAP_NUM_ITERATE_OUTWARDS_INDICES,
-              sizeof(outwards_indices[0]), fair_team_placement_vertical);
-        break;
-      }
-
-      /* Make start point for teams. */
-      if (current_wrap_has_flag(WRAP_X)) {
-        dx = fc_rand(MAP_NATIVE_WIDTH);
-      }
-      if (current_wrap_has_flag(WRAP_Y)) {
-        dy = fc_rand(MAP_NATIVE_HEIGHT);
-      }
-      for (j = 0; j < teams_num; j++) {
-        start_x[j] = (MAP_NATIVE_WIDTH * (2 * j + 1)) / (2 * teams_num) + dx;
-        start_y[j] = (MAP_NATIVE_HEIGHT * (2 * j + 1)) / (2 * teams_num) + dy;
-        if (current_wrap_has_flag(WRAP_X)) {
-          start_x[j] = FC_WRAP(start_x[j], MAP_NATIVE_WIDTH);
-        }
-        if (current_wrap_has_flag(WRAP_Y)) {
-          start_y[j] = FC_WRAP(start_y[j], MAP_NATIVE_HEIGHT);
-        }
-      }
-      /* Randomize. */
-      array_shuffle(start_x, teams_num);
-      array_shuffle(start_y, teams_num);
-
-      j = 0;
-      teams_iterate(pteam) {
-        int members_count = player_list_size(team_members(pteam));
-        int team_id;
-        int x, y;
-
-        if (members_count <= 1) {
-          continue;
-        }
-        team_id = team_number(pteam);
-
-        NATIVE_TO_MAP_POS(&x, &y, start_x[j], start_y[j]);
-        log_verbose("Team %d (%s) will start on (%d, %d)",
-                    team_id, team_rule_name(pteam), x, y);
-
-        for (k = 0; k < members_count; k += players_per_island) {
-          if (!fair_map_place_island_team(pmap, x, y, pisland,
-                                          outwards_indices, team_id)) {
-            log_verbose("Failed to place island number %d for team %d (%s).",
-                        k, team_id, team_rule_name(pteam));
-            done = FALSE;
-            break;
-          }
-        }
-        if (!done) {
-          break;
-        }
-        i += k;
-        j++;
-      } teams_iterate_end;
+  /* All the attempts start from the same map. */
+  ptemplate = fair_map_new();
+  whole_map_iterate(&(wld.map), ptile) {
+    struct fair_tile *pftile = ptemplate + tile_index(ptile);
 
-      fc_assert(!done || i == team_players_num);
-    }
+    if (tile_terrain(ptile) != deepest_ocean) {
+      pftile->flags |= (FTF_ASSIGNED | FTF_NO_HUT);
+      adjc_iterate(&(wld.map), ptile, atile) {
+        struct fair_tile *aftile = ptemplate + tile_index(atile);
 
-    if (done) {
-      /* Place last player islands. */
-      for (; i < player_count(); i += players_per_island) {
-        if (!fair_map_place_island_rand(pmap, pisland)) {
-          log_verbose("Failed to place island number %d.", i);
-          done = FALSE;
-          break;
-        }
-      }
-      fc_assert(!done || i == player_count());
-    }
-    fair_map_destroy(pisland);
-
-    if (done) {
-      log_debug("Create and place small islands on the map.");
-      for (i = 0; i < player_count(); i++) {
-        pisland = fair_map_island_new(islandmass2, 0);
-        if (!fair_map_place_island_rand(pmap, pisland)) {
-          log_verbose("Failed to place small island2 number %d.", i);
-          done = FALSE;
-          fair_map_destroy(pisland);
-          break;
-        }
-        fair_map_destroy(pisland);
-      }
-    }
-    if (done) {
-      for (i = 0; i < player_count(); i++) {
-        pisland = fair_map_island_new(islandmass3, 0);
-        if (!fair_map_place_island_rand(pmap, pisland)) {
-          log_verbose("Failed to place small island3 number %d.", i);
-          done = FALSE;
-          fair_map_destroy(pisland);
-          break;
+        if (!(aftile->flags & FTF_ASSIGNED)
+            && tile_terrain(atile) == deepest_ocean) {
+          aftile->flags |= FTF_OCEAN;
         }
-        fair_map_destroy(pisland);
-      }
-    }
-
-    if (done) {
-      break;
-    }
-
-    fair_map_destroy(pmap);
-    pmap = fair_map_new();
-
-    /* Decrease land mass, for better chances. */
-    islandmass1 = (islandmass1 * 99) / 100;
-    if (islandmass1 < min_island_size) {
-      islandmass1 = min_island_size;
-    }
-    islandmass2 = (islandmass2 * 99) / 100;
-    if (islandmass2 < min_island_size) {
-      islandmass2 = min_island_size;
-    }
-    islandmass3 = (islandmass3 * 99) / 100;
-    if (islandmass3 < min_island_size) {
-      islandmass3 = min_island_size;
+      } adjc_iterate_end;
     }
-  }
+    pftile->pterrain = tile_terrain(ptile);
+    pftile->presource = tile_resource(ptile);
+    pftile->extras = *tile_extras(ptile);
+  } whole_map_iterate_end;
 
-  if (!done) {
+  /* Run the attempts concurrently, each with a random state of its own
+   * seeded from the attempt number, and use the first one, in attempt
+   * order, that succeeds. So the map only depends on the map seed, not
+   * on the number of threads. */
+  attempts.ptemplate = ptemplate;
+  attempts.players_per_island = players_per_island;
+  attempts.teams_num = teams_num;
+  attempts.team_players_num = team_players_num;
+  attempts.min_island_size = min_island_size;
+  attempts.islandmass1 = islandmass1;
+  attempts.islandmass2 = islandmass2;
+  attempts.islandmass3 = islandmass3;
+  atomic_init(&attempts.first_success, iter);
+  attempts.results = fc_malloc(iter * sizeof(*attempts.results));
+
+  parallel_rand_jobs_run(iter, mapgen_max_threads(),
+                         fair_map_attempt_job, &attempts);
+
+  pmap = nullptr;
+  for (i = 0; i < iter; i++) {
+    if (pmap == nullptr) {
+      pmap = attempts.results[i];
+    } else if (attempts.results[i] != nullptr) {
+      fair_map_destroy(attempts.results[i]);
+    }
+  }
+  free(attempts.results);
+  fair_map_destroy(ptemplate);
+
+  if (pmap == nullptr) {
     log_verbose("Failed to create map after %d iterations.", iter);
     wld.map.server.generator = MAPGEN_ISLAND;
     return FALSE;
@@ -14,9 +14,15 @@
 #include <fc_config.h>
 #endif
 
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>             /* sysconf() */
+#endif
+
 /* utility */
 #include "fcintl.h"
+#include "fcthread.h"
 #include "log.h"
+#include "mem.h"
 #include "rand.h"
 #include "support.h"            /* bool type */
 
@@ -34,6 +40,199 @@
 **************************************************************************/
 static bool *placed_map;
 
+/* Smaller maps are not worth starting threads for. */
+#define MAPGEN_TILES_PER_THREAD 16384
+#define MAPGEN_MAX_THREADS 16
+
+struct mapgen_jobs {
+  mapgen_job_func func;
+  void *data;
+  int num_jobs;
+  int num_threads;
+  bool own_rand;
+  RANDOM_TYPE seed;
+};
+
+struct mapgen_worker {
+  const struct mapgen_jobs *jobs;
+  int first;
+};
+
+/**********************************************************************//**
+  Return the number of processors the map generator may use.
+**************************************************************************/
+int mapgen_max_threads(void)
+{
+  int num = 1;
+
+#ifdef _SC_NPROCESSORS_ONLN
+  num = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+  return CLIP(1, num, MAPGEN_MAX_THREADS);
+}
+
+/**********************************************************************//**
+  Return the number of threads worth using for a pass over all the tiles
+  of the current map.
+**************************************************************************/
+int mapgen_map_threads(void)
+{
+  return CLIP(1, MAP_INDEX_SIZE / MAPGEN_TILES_PER_THREAD,
+              mapgen_max_threads());
+}
+
+/**********************************************************************//**
+  Do a single job. Jobs with their own random state get one seeded from
+  the job number, so their random numbers do not depend on the thread
+  that runs them, nor on the order the jobs run in.
+**************************************************************************/
+static void mapgen_job_run(const struct mapgen_jobs *jobs, int job)
+{
+  if (jobs->own_rand) {
+    RANDOM_STATE rstate;
+
+    fc_rand_use_state(&rstate);
+    fc_srand(jobs->seed + (RANDOM_TYPE) job * 0x9E3779B9);
+    jobs->func(job, jobs->data);
+    fc_rand_use_state(nullptr);
+  } else {
+    jobs->func(job, jobs->data);
+  }
+}
+
+/**********************************************************************//**
+  Thread function of mapgen_jobs_run(). Does every num_threads-th job.
+**************************************************************************/
+static void mapgen_worker_run(void *arg)
+{
+  const struct mapgen_worker *worker = arg;
+  const struct mapgen_jobs *jobs = worker->jobs;
+  int job;
+
+  for (job = worker->first; job < jobs->num_jobs;
+       job += jobs->num_threads) {
+    mapgen_job_run(jobs, job);
+  }
+}
+
+/**********************************************************************//**
+  Do all the jobs on up to num_threads threads, including the calling
+  one, and return when they are done.
+**************************************************************************/
+static void mapgen_jobs_run(struct mapgen_jobs *jobs)
+{
+  struct mapgen_worker workers[MAPGEN_MAX_THREADS];
+  fc_thread threads[MAPGEN_MAX_THREADS];
+  bool started[MAPGEN_MAX_THREADS];
+  int i;
+
+  jobs->num_threads = CLIP(1, MIN(jobs->num_threads, jobs->num_jobs),
+                           MAPGEN_MAX_THREADS);
+
+  for (i = 0; i < jobs->num_threads; i++) {
+    workers[i].jobs = jobs;
+    workers[i].first = i;
+  }
+
+  /* The first share is done by the calling thread. */
+  started[0] = FALSE;
+  for (i = 1; i < jobs->num_threads; i++) {
+    started[i] = (fc_thread_start(&threads[i], mapgen_worker_run,
+                                  &workers[i]) == 0);
+  }
+  mapgen_worker_run(&workers[0]);
+
+  for (i = 1; i < jobs->num_threads; i++) {
+    if (started[i]) {
+      fc_thread_wait(&threads[i]);
+    } else {
+      mapgen_worker_run(&workers[i]);
+    }
+  }
+}
+
+/**********************************************************************//**
+  Call func for each job number from 0 to num_jobs - 1, on up to
+  num_threads threads. The jobs must not write to data the other jobs
+  use. Returns when all the jobs are done.
+**************************************************************************/
+void parallel_jobs_run(int num_jobs, int num_threads,
+                       mapgen_job_func func, void *data)
+{
+  struct mapgen_jobs jobs;
+
+  jobs.func = func;
+  jobs.data = data;
+  jobs.num_jobs = num_jobs;
+  jobs.num_threads = num_threads;
+  jobs.own_rand = FALSE;
+  jobs.seed = 0;
+  mapgen_jobs_run(&jobs);
+}
+
+/**********************************************************************//**
+  Like parallel_jobs_run(), but each job draws its random numbers from a
+  state of its own. Those are seeded from one number taken from the
+  global random state and the job number, so a given map seed gives the
+  same results with any number of threads.
+**************************************************************************/
+void parallel_rand_jobs_run(int num_jobs, int num_threads,
+                            mapgen_job_func func, void *data)
+{
+  struct mapgen_jobs jobs;
+
+  jobs.func = func;
+  jobs.data = data;
+  jobs.num_jobs = num_jobs;
+  jobs.num_threads = num_threads;
+  jobs.own_rand = TRUE;
+  jobs.seed = fc_rand(MAX_UINT32);
+  mapgen_jobs_run(&jobs);
+}
+
+struct map_index_ranges {
+  map_index_range_func func;
+  void *data;
+  int num_ranges;
+};
+
+/**********************************************************************//**
+  Job function of parallel_map_index_iterate().
+**************************************************************************/
+static void map_index_range_run(int job, void *data)
+{
+  const struct map_index_ranges *ranges = data;
+
+  ranges->func((long) MAP_INDEX_SIZE * job / ranges->num_ranges,
+               (long) MAP_INDEX_SIZE * (job + 1) / ranges->num_ranges,
+               ranges->data);
+}
+
+/**********************************************************************//**
+  Call func for consecutive ranges of tile indices covering the whole
+  map, in several threads if the map is large enough and there are
+  processors for them. func must only read the map and only write the
+  entries of its own range, so the result does not depend on the
+  number of threads. Returns when all the ranges are done.
+**************************************************************************/
+void parallel_map_index_iterate(map_index_range_func func, void *data)
+{
+  struct map_index_ranges ranges;
+
+  ranges.func = func;
+  ranges.data = data;
+  ranges.num_ranges = mapgen_map_threads();
+
+  if (ranges.num_ranges == 1) {
+    func(0, MAP_INDEX_SIZE, data);
+    return;
+  }
+
+  parallel_jobs_run(ranges.num_ranges, ranges.num_ranges,
+                    map_index_range_run, &ranges);
+}
+
 /**********************************************************************//**
   Return TRUE if initialized
 **************************************************************************/
@@ -182,6 +381,37 @@ bool is_normal_nat_pos(int x, int y)
   return is_normal_map_pos(x, y);
 }
 
+struct smooth_pass {
+  const int *source_map;
+  int *target_map;
+  const float *weight;
+  bool axe;
+  bool zeroes_at_edges;
+};
+
+/**********************************************************************//**
+  One smooth_int_map() pass over the tiles [first, last).
+**************************************************************************/
+static void smooth_int_map_range(int first, int last, void *data)
+{
+  const struct smooth_pass *pass = data;
+  int idx;
+
+  for (idx = first; idx < last; idx++) {
+    struct tile *ptile = index_to_tile(&(wld.map), idx);
+    float N = 0, D = 0;
+
+    axis_iterate(&(wld.map), ptile, pnear, i, 2, pass->axe) {
+      D += pass->weight[i + 2];
+      N += pass->weight[i + 2] * pass->source_map[tile_index(pnear)];
+    } axis_iterate_end;
+    if (pass->zeroes_at_edges) {
+      D = 1;
+    }
+    pass->target_map[idx] = (float)N / D;
+  }
+}
+
 /**********************************************************************//**
   Apply a Gaussian diffusion filter on the map. The size of the map is
   MAP_INDEX_SIZE and the map is indexed by native_pos_to_index function.
@@ -192,41 +422,30 @@ void smooth_int_map(int *int_map, bool zeroes_at_edges)
 {
   static const float weight_standard[5] = { 0.13, 0.19, 0.37, 0.19, 0.13 };
   static const float weight_isometric[5] = { 0.15, 0.21, 0.29, 0.21, 0.15 };
-  const float *weight;
-  bool axe = TRUE;
-  int *target_map, *source_map;
+  struct smooth_pass pass;
   int *alt_int_map = fc_calloc(MAP_INDEX_SIZE, sizeof(*alt_int_map));
 
   fc_assert_ret(NULL != int_map);
 
-  weight = weight_standard;
-  target_map = alt_int_map;
-  source_map = int_map;
+  pass.weight = weight_standard;
+  pass.axe = TRUE;
+  pass.zeroes_at_edges = zeroes_at_edges;
+  pass.target_map = alt_int_map;
+  pass.source_map = int_map;
 
   do {
-    whole_map_iterate(&(wld.map), ptile) {
-      float N = 0, D = 0;
-
-      axis_iterate(&(wld.map), ptile, pnear, i, 2, axe) {
-        D += weight[i + 2];
-        N += weight[i + 2] * source_map[tile_index(pnear)];
-      } axis_iterate_end;
-      if (zeroes_at_edges) {
-        D = 1;
-      }
-      target_map[tile_index(ptile)] = (float)N / D;
-    } whole_map_iterate_end;
+    parallel_map_index_iterate(smooth_int_map_range, &pass);
 
     if (MAP_IS_ISOMETRIC) {
-      weight = weight_isometric;
+      pass.weight = weight_isometric;
     }
 
-    axe = !axe;
+    pass.axe = !pass.axe;
 
-    source_map = alt_int_map;
-    target_map = int_map;
+    pass.source_map = alt_int_map;
+    pass.target_map = int_map;
 
-  } while (!axe);
+  } while (!pass.axe);
 
   FC_FREE(alt_int_map);
 }
@@ -558,6 +777,28 @@ static int real_distance_to_land(const struct tile *ptile, int max)
   return max + 1;
 }
 
+struct land_distance {
+  int *dist;
+  int max;
+};
+
+/**********************************************************************//**
+  real_distance_to_land() of the ocean tiles [first, last).
+**************************************************************************/
+static void land_distance_range(int first, int last, void *data)
+{
+  struct land_distance *distances = data;
+  int idx;
+
+  for (idx = first; idx < last; idx++) {
+    const struct tile *ptile = index_to_tile(&(wld.map), idx);
+
+    if (terrain_type_terrain_class(tile_terrain(ptile)) == TC_OCEAN) {
+      distances->dist[idx] = real_distance_to_land(ptile, distances->max);
+    }
+  }
+}
+
 /**********************************************************************//**
   Determines what is the most popular ocean type around (need 2/3 of the
   adjacent tiles).
@@ -593,16 +834,23 @@ void smooth_water_depth(void)
   const int OCEAN_DEPTH_STEP = 25;
   const int OCEAN_DEPTH_RAND = 15;
   const int OCEAN_DIST_MAX = TERRAIN_OCEAN_DEPTH_MAXIMUM / OCEAN_DEPTH_STEP;
+  struct land_distance distances;
   struct terrain *ocean;
   int dist;
 
+  /* Replacing ocean types below does not change the distances, so they
+   * can be searched for all the tiles in advance. */
+  distances.dist = fc_malloc(MAP_INDEX_SIZE * sizeof(*distances.dist));
+  distances.max = OCEAN_DIST_MAX;
+  parallel_map_index_iterate(land_distance_range, &distances);
+
   /* First, improve the coasts. */
   whole_map_iterate(&(wld.map), ptile) {
     if (terrain_type_terrain_class(tile_terrain(ptile)) != TC_OCEAN) {
       continue;
     }
 
-    dist = real_distance_to_land(ptile, OCEAN_DIST_MAX);
+    dist = distances.dist[tile_index(ptile)];
     if (dist <= OCEAN_DIST_MAX) {
       /* Overwrite the terrain (but preserve frozenness). */
       ocean = pick_ocean(dist * OCEAN_DEPTH_STEP
@@ -617,6 +865,7 @@ void smooth_water_depth(void)
       }
     }
   } whole_map_iterate_end;
+  free(distances.dist);
 
   /* Now, try to have something more continuous. */
   whole_map_iterate(&(wld.map), ptile) {
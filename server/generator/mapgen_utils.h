@@ -14,6 +14,8 @@
 #define FC__MAPGEN_UTILS_H
 
 typedef void (*tile_knowledge_cb)(struct tile *ptile);
+typedef void (*map_index_range_func)(int first, int last, void *data);
+typedef void (*mapgen_job_func)(int job, void *data);
 
 #define MG_UNUSED mapgen_terrain_property_invalid()
 
@@ -105,6 +107,14 @@ void adjust_int_map_filtered(int *int_map, int int_map_min,
       (bool (*)(const struct tile *ptile, const void *data))NULL)
 void smooth_int_map(int *int_map, bool zeroes_at_edges);
 
+int mapgen_max_threads(void);
+int mapgen_map_threads(void);
+void parallel_jobs_run(int num_jobs, int num_threads,
+                       mapgen_job_func func, void *data);
+void parallel_rand_jobs_run(int num_jobs, int num_threads,
+                            mapgen_job_func func, void *data);
+void parallel_map_index_iterate(map_index_range_func func, void *data);
+
 /* placed_map tool */
 void create_placed_map(void);
 void destroy_placed_map(void);
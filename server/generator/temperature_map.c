@@ -111,6 +111,44 @@ void destroy_tmap(void)
   temperature_map = NULL;
 }
 
+/**********************************************************************//**
+  Set the temperature of the tiles [first, last) to their colatitude.
+**************************************************************************/
+static void create_base_tmap_range(int first, int last, void *data)
+{
+  int i;
+
+  for (i = first; i < last; i++) {
+    temperature_map[i] = map_colatitude(index_to_tile(&(wld.map), i));
+  }
+}
+
+/**********************************************************************//**
+  Set the real temperature of the tiles [first, last), taking height and
+  nearby ocean into account.
+**************************************************************************/
+static void create_real_tmap_range(int first, int last, void *data)
+{
+  int i;
+
+  for (i = first; i < last; i++) {
+    struct tile *ptile = index_to_tile(&(wld.map), i);
+    /* The base temperature is equal to base map_colatitude */
+    int t = map_colatitude(ptile);
+    /* High land can be 30% cooler */
+    float height = - 0.3 * MAX(0, hmap(ptile) - hmap_shore_level)
+        / (hmap_max_level - hmap_shore_level);
+    int tcn = count_terrain_class_near_tile(&(wld.map), ptile, FALSE, TRUE, TC_OCEAN);
+    /* Near ocean temperature can be 15% more "temperate" */
+    float temperate = (0.15 * (wld.map.server.temperature / 100 - t
+                               / MAX_COLATITUDE)
+                       * 2 * MIN(50, tcn)
+                       / 100);
+
+    tmap(ptile) =  t * (1.0 + temperate) * (1.0 + height);
+  }
+}
+
 /**********************************************************************//**
   Initialize the temperature_map
   if arg is FALSE, create a dummy tmap == map_colatitude
@@ -126,26 +164,8 @@ void create_tmap(bool real)
   fc_assert_ret(NULL == temperature_map);
 
   temperature_map = fc_malloc(sizeof(*temperature_map) * MAP_INDEX_SIZE);
-  whole_map_iterate(&(wld.map), ptile) {
-    /* The base temperature is equal to base map_colatitude */
-    int t = map_colatitude(ptile);
-
-    if (!real) {
-      tmap(ptile) = t;
-    } else {
-      /* High land can be 30% cooler */
-      float height = - 0.3 * MAX(0, hmap(ptile) - hmap_shore_level)
-          / (hmap_max_level - hmap_shore_level);
-      int tcn = count_terrain_class_near_tile(&(wld.map), ptile, FALSE, TRUE, TC_OCEAN);
-      /* Near ocean temperature can be 15% more "temperate" */
-      float temperate = (0.15 * (wld.map.server.temperature / 100 - t
-                                 / MAX_COLATITUDE)
-                         * 2 * MIN(50, tcn)
-                         / 100);
-
-      tmap(ptile) =  t * (1.0 + temperate) * (1.0 + height);
-    }
-  } whole_map_iterate_end;
+  parallel_map_index_iterate(real ? create_real_tmap_range : create_base_tmap_range,
+                             NULL);
 
   /* Adjust to get evenly distributed frequencies.
    * Only call adjust when the colatitude range is large enough for this to
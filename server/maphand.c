@@ -15,6 +15,8 @@
 #include <fc_config.h>
 #endif
 
+#include <string.h>
+
 /* utility */
 #include "bitvector.h"
 #include "fcintl.h"
@@ -27,6 +29,7 @@
 #include "ai.h"
 #include "base.h"
 #include "borders.h"
+#include "effects.h"
 #include "events.h"
 #include "game.h"
 #include "map.h"
@@ -59,6 +62,39 @@
 
 #include "maphand.h"
 
+/* Incremental border recalculation. map_calculate_borders() reruns
+ * map_claim_border() only for the border sources that have changed, or
+ * have a changed tile within their radius, since the previous run.
+ * Sources that don't, would not claim anything anyway. */
+struct border_tile_state {
+  struct terrain *terrain;
+  bv_extras extras;
+  Continent_id continent;
+  struct player *owner;
+  struct tile *claimer;
+};
+
+struct border_source_state {
+  struct player *owner;
+  int radius_sq;                /* -1 if the tile is not a border source */
+  int strength;
+  int city_radius_sq;
+};
+
+static struct {
+  int num_tiles;                /* 0 when there's no state */
+  bool all_dirty;
+  bool in_pass;
+  enum borders_mode mode;
+  int permanent_radius_sq;
+  struct border_tile_state *tiles;
+  struct border_source_state *sources;
+  bool *dirty;                  /* Changed since the previous run */
+  bool *dirty_next;             /* Changed during the current run */
+} borders_cache;
+
+static void map_border_mark(const struct tile *ptile);
+
 /* Suppress send_tile_info() during game_load() */
 static bool send_tile_suppressed = FALSE;
 
@@ -559,7 +595,7 @@ void send_tile_info(struct conn_list *dest, struct tile *ptile,
                          : 0;
 
       if (pplayer != NULL) {
-        dbv_to_bv(info.extras.vec, &(map_get_player_tile(ptile, pplayer)->extras));
+        info.extras = map_get_player_tile(ptile, pplayer)->extras;
       } else {
 	info.extras = ptile->extras;
       }
@@ -581,25 +617,25 @@ void send_tile_info(struct conn_list *dest, struct tile *ptile,
       info.known = TILE_KNOWN_UNSEEN;
       info.continent = tile_continent(ptile);
       owner = (game.server.foggedborders
-               ? plrtile->owner
+               ? player_tile_owner(plrtile)
                : tile_owner(ptile));
-      eowner = plrtile->extras_owner;
+      eowner = player_tile_extras_owner(plrtile);
       info.owner = (owner ? player_number(owner) : MAP_TILE_OWNER_NULL);
       info.extras_owner = (eowner ? player_number(eowner) : MAP_TILE_OWNER_NULL);
       info.worked = (NULL != psite)
                     ? psite->identity
                     : IDENTITY_NUMBER_ZERO;
 
-      info.terrain = (NULL != plrtile->terrain)
-                      ? terrain_number(plrtile->terrain)
+      info.terrain = (0 != plrtile->terrain)
+                      ? plrtile->terrain - 1
                       : terrain_count();
-      info.resource = (NULL != plrtile->resource)
-                       ? extra_number(plrtile->resource)
+      info.resource = (0 != plrtile->resource)
+                       ? plrtile->resource - 1
                        : MAX_EXTRA_TYPES;
       info.placing = -1;
       info.place_turn = 0;
 
-      dbv_to_bv(info.extras.vec, &(plrtile->extras));
+      info.extras = plrtile->extras;
 
       /* Labels never change, so they are not subject to fog of war */
       if (ptile->label != NULL) {
@@ -737,6 +773,80 @@ void map_vision_update(struct player *pplayer, struct tile *ptile,
   unbuffer_shared_vision(pplayer);
 }
 
+/**********************************************************************//**
+  Change by 'count' the seen count of the tiles within to_radius_sq of
+  to_tile that are not also within from_radius_sq of from_tile, layer by
+  layer. This is all that changes when 'count' vision sources of the
+  player move from from_tile to to_tile: call it once with a positive
+  count for the tiles coming into sight, and once the move is done with
+  the tiles swapped and the count negated for the tiles going out of
+  sight. Tiles seen from both places are not touched at all.
+
+  With from_tile nullptr, the whole circle around to_tile is changed.
+**************************************************************************/
+void map_vision_shift(struct player *pplayer,
+                      const struct tile *from_tile,
+                      const v_radius_t from_radius_sq,
+                      struct tile *to_tile,
+                      const v_radius_t to_radius_sq,
+                      int count, bool can_reveal_tiles)
+{
+  v_radius_t change;
+  int max_radius = -1, from_max_radius = -1;
+  int shift_dx = 0, shift_dy = 0;
+
+  vision_layer_iterate(v) {
+    max_radius = MAX(max_radius, to_radius_sq[v]);
+    if (from_tile != nullptr) {
+      from_max_radius = MAX(from_max_radius, from_radius_sq[v]);
+    }
+  } vision_layer_iterate_end;
+
+  if (max_radius < 0) {
+    return;
+  }
+
+  if (from_max_radius >= 0) {
+    int reach;
+
+    map_distance_vector(&shift_dx, &shift_dy, from_tile, to_tile);
+
+    /* A tile is in sight from from_tile when the vector to it from there,
+     * the vector from to_tile plus the shift, is within the radius. That
+     * only holds as long as neither circle wraps onto itself; otherwise
+     * the same tile may be counted through several vectors. The test has
+     * to give the same answer with the tiles swapped. */
+    reach = (int)sqrt((double)MAX(max_radius, from_max_radius))
+      + map_vector_to_real_distance(shift_dx, shift_dy) + 1;
+    if (4 * reach > MIN(MAP_NATIVE_WIDTH, MAP_NATIVE_HEIGHT)) {
+      from_max_radius = -1;
+    }
+  }
+
+  buffer_shared_vision(pplayer);
+  circle_dxyr_iterate(&(wld.map), to_tile, max_radius, tile1, dx, dy, dr) {
+    int from_dr = (from_max_radius < 0 ? -1
+                   : map_vector_to_sq_distance(dx + shift_dx,
+                                               dy + shift_dy));
+    bool changed = FALSE;
+
+    vision_layer_iterate(v) {
+      if (dr <= to_radius_sq[v]
+          && (from_max_radius < 0 || from_dr > from_radius_sq[v])) {
+        change[v] = count;
+        changed = TRUE;
+      } else {
+        change[v] = 0;
+      }
+    } vision_layer_iterate_end;
+
+    if (changed) {
+      shared_vision_change_seen(pplayer, tile1, change, can_reveal_tiles);
+    }
+  } circle_dxyr_iterate_end;
+  unbuffer_shared_vision(pplayer);
+}
+
 /**********************************************************************//**
   Turn a player's ability to see inside their borders on or off.
 
@@ -1060,9 +1170,9 @@ void map_change_seen(struct player *pplayer,
 
     update_player_tile_last_seen(pplayer, ptile);
     if (game.server.foggedborders) {
-      plrtile->owner = tile_owner(ptile);
+      player_tile_set_owner(plrtile, tile_owner(ptile));
     }
-    plrtile->extras_owner = extra_owner(ptile);
+    player_tile_set_extras_owner(plrtile, extra_owner(ptile));
     send_tile_info(pplayer->connections, ptile, FALSE);
   }
 
@@ -1182,7 +1292,10 @@ void change_playertile_site(struct player_tile *ptile,
 **************************************************************************/
 void map_set_known(struct tile *ptile, struct player *pplayer)
 {
-  dbv_set(&pplayer->tile_known, tile_index(ptile));
+  if (!dbv_isset(&pplayer->tile_known, tile_index(ptile))) {
+    dbv_set(&pplayer->tile_known, tile_index(ptile));
+    map_border_mark(ptile);
+  }
 }
 
 /**********************************************************************//**
@@ -1286,12 +1399,12 @@ void remove_player_from_maps(struct player *pplayer)
       }
 
       /* Remove references to player from others' maps */
-      if (aplrtile->owner == pplayer) {
-        aplrtile->owner = NULL;
+      if (player_tile_owner(aplrtile) == pplayer) {
+        player_tile_set_owner(aplrtile, NULL);
         changed = TRUE;
       }
-      if (aplrtile->extras_owner == pplayer) {
-        aplrtile->extras_owner = NULL;
+      if (player_tile_extras_owner(aplrtile) == pplayer) {
+        player_tile_set_extras_owner(aplrtile, NULL);
         changed = TRUE;
       }
 
@@ -1334,12 +1447,12 @@ static void player_tile_init(struct tile *ptile, struct player *pplayer)
 {
   struct player_tile *plrtile = map_get_player_tile(ptile, pplayer);
 
-  plrtile->terrain = T_UNKNOWN;
-  plrtile->resource = NULL;
-  plrtile->owner = NULL;
-  plrtile->extras_owner = NULL;
+  player_tile_set_terrain(plrtile, T_UNKNOWN);
+  player_tile_set_resource(plrtile, NULL);
+  player_tile_set_owner(plrtile, NULL);
+  player_tile_set_extras_owner(plrtile, NULL);
   plrtile->site = NULL;
-  dbv_init(&(plrtile->extras), extra_count());
+  BV_CLR_ALL(plrtile->extras);
   if (!game.server.last_updated_year) {
     plrtile->last_updated = game.info.turn;
   } else {
@@ -1362,8 +1475,6 @@ static void player_tile_free(struct tile *ptile, struct player *pplayer)
   if (plrtile->site != NULL) {
     vision_site_destroy(plrtile->site);
   }
-
-  dbv_free(&(plrtile->extras));
 }
 
 /**********************************************************************//**
@@ -1404,27 +1515,28 @@ bool update_player_tile_knowledge(struct player *pplayer, struct tile *ptile)
 {
   struct player_tile *plrtile = map_get_player_tile(ptile, pplayer);
 
-  if (plrtile->terrain != ptile->terrain
-      || !bv_match_dbv(&(plrtile->extras), ptile->extras.vec)
-      || plrtile->resource != ptile->resource
-      || plrtile->owner != tile_owner(ptile)
-      || plrtile->extras_owner != extra_owner(ptile)) {
-    plrtile->terrain = ptile->terrain;
-    extra_type_iterate(pextra) {
-      if (player_knows_extra_exist(pplayer, pextra, ptile)) {
-	dbv_set(&(plrtile->extras), extra_number(pextra));
-      } else {
-	dbv_clr(&(plrtile->extras), extra_number(pextra));
+  if (player_tile_terrain(plrtile) != ptile->terrain
+      || !BV_ARE_EQUAL(plrtile->extras, ptile->extras)
+      || player_tile_resource(plrtile) != ptile->resource
+      || player_tile_owner(plrtile) != tile_owner(ptile)
+      || player_tile_extras_owner(plrtile) != extra_owner(ptile)) {
+    player_tile_set_terrain(plrtile, ptile->terrain);
+    /* Copy the whole vector, then drop just the extras present on the
+     * tile that the player can't see. */
+    plrtile->extras = ptile->extras;
+    bv_iterate_set(ptile->extras, idx) {
+      if (!player_knows_extra_exist(pplayer, extra_by_number(idx), ptile)) {
+        BV_CLR(plrtile->extras, idx);
       }
-    } extra_type_iterate_end;
+    } bv_iterate_set_end;
     if (ptile->resource != NULL
         && player_knows_extra_exist(pplayer, ptile->resource, ptile)) {
-      plrtile->resource = ptile->resource;
+      player_tile_set_resource(plrtile, ptile->resource);
     } else {
-      plrtile->resource = NULL;
+      player_tile_set_resource(plrtile, NULL);
     }
-    plrtile->owner = tile_owner(ptile);
-    plrtile->extras_owner = extra_owner(ptile);
+    player_tile_set_owner(plrtile, tile_owner(ptile));
+    player_tile_set_extras_owner(plrtile, extra_owner(ptile));
 
     return TRUE;
   }
@@ -1511,7 +1623,7 @@ static bool really_give_tile_info_from_player_to_player(struct player *pfrom,
       /* Update and send tile knowledge */
       map_set_known(ptile, pdest);
       dest_tile->terrain = from_tile->terrain;
-      dbv_copy(&(dest_tile->extras), &(from_tile->extras));
+      dest_tile->extras = from_tile->extras;
       dest_tile->resource = from_tile->resource;
       dest_tile->owner    = from_tile->owner;
       dest_tile->extras_owner = from_tile->extras_owner;
@@ -2148,6 +2260,7 @@ static void map_claim_border_ownership(struct tile *ptile,
   }
 
   tile_set_owner(ptile, powner, psource);
+  map_border_mark(ptile);
 
   /* Needed only when foggedborders enabled, but we do it unconditionally
    * in case foggedborders ever gets enabled later. Better to have correct
@@ -2242,6 +2355,66 @@ void map_update_border(struct tile *ptile, struct player *owner,
   }
 }
 
+/**********************************************************************//**
+  Would border source 'psource', owned by 'owner', claim 'ptile' at
+  squared distance 'dr' from it.
+**************************************************************************/
+bool map_border_claim_wanted(struct tile *ptile, struct tile *psource,
+                             struct player *owner, int dr)
+{
+  struct tile *dclaimer = tile_claimer(ptile);
+
+  if (dclaimer == psource) {
+    /* Already claimed by the psource */
+    return FALSE;
+  }
+
+  if (dr != 0 && is_border_source(ptile)) {
+    /* Do not claim border sources other than self */
+    /* Note that this is extremely important at the moment for
+     * base claiming to work correctly in case there's two
+     * fortresses near each other. There could be infinite
+     * recursion in them claiming each other. */
+    return FALSE;
+  }
+
+  if (!map_is_known(ptile, owner) && game.info.borders < BORDERS_EXPAND) {
+    return FALSE;
+  }
+
+  /* Always claim source itself (distance, dr, to it 0) */
+  if (dr != 0 && NULL != dclaimer) {
+    struct city *ccity = tile_city(dclaimer);
+    int strength_old, strength_new;
+
+    if (ccity != NULL) {
+      /* Previously claimed by city */
+      int city_x, city_y;
+
+      map_distance_vector(&city_x, &city_y, ccity->tile, ptile);
+
+      if (map_vector_to_sq_distance(city_x, city_y)
+          <= city_map_radius_sq_get(ccity)
+             + game.info.border_city_permanent_radius_sq) {
+        /* Tile is within region permanently claimed by city */
+        return FALSE;
+      }
+    }
+
+    strength_old = tile_border_strength(ptile, dclaimer);
+    strength_new = tile_border_strength(ptile, psource);
+
+    if (strength_new <= strength_old) {
+      /* Stronger shall prevail,
+       * in case of equal strength older shall prevail */
+      return FALSE;
+    }
+  }
+
+  /* Only certain tiles are claimable */
+  return is_tile_claimable(ptile, psource, owner);
+}
+
 /**********************************************************************//**
   Update borders for this source. Call this for each new source.
 
@@ -2267,67 +2440,231 @@ void map_claim_border(struct tile *ptile, struct player *owner,
   }
 
   circle_dxyr_iterate(&(wld.map), ptile, radius_sq, dtile, dx, dy, dr) {
-    struct tile *dclaimer = tile_claimer(dtile);
-
-    if (dclaimer == ptile) {
-      /* Already claimed by the ptile */
-      continue;
+    if (map_border_claim_wanted(dtile, ptile, owner, dr)) {
+      map_claim_ownership(dtile, owner, ptile, dr == 0);
     }
+  } circle_dxyr_iterate_end;
+}
 
-    if (dr != 0 && is_border_source(dtile)) {
-      /* Do not claim border sources other than self */
-      /* Note that this is extremely important at the moment for
-       * base claiming to work correctly in case there's two
-       * fortresses near each other. There could be infinite
-       * recursion in them claiming each other. */
-      continue;
+/**********************************************************************//**
+  Mark a tile changed for the next map_calculate_borders(). During the
+  recalculation itself this also affects the sources still to go.
+**************************************************************************/
+static void map_border_mark(const struct tile *ptile)
+{
+  if (borders_cache.num_tiles > 0) {
+    borders_cache.dirty[tile_index(ptile)] = TRUE;
+    if (borders_cache.in_pass) {
+      borders_cache.dirty_next[tile_index(ptile)] = TRUE;
     }
+  }
+}
 
-    if (!map_is_known(dtile, owner) && game.info.borders < BORDERS_EXPAND) {
-      continue;
-    }
+/**********************************************************************//**
+  Mark every tile a border source may affect changed: its border radius,
+  and for a city also the region it claims permanently.
+**************************************************************************/
+static void map_border_mark_circle(struct tile *psource,
+                                   const struct border_source_state *pstate)
+{
+  int radius_sq = pstate->radius_sq;
+
+  if (pstate->city_radius_sq >= 0) {
+    radius_sq = MAX(radius_sq, pstate->city_radius_sq
+                               + game.info.border_city_permanent_radius_sq);
+  }
 
-    /* Always claim source itself (distance, dr, to it 0) */
-    if (dr != 0 && NULL != dclaimer && dclaimer != ptile) {
-      struct city *ccity = tile_city(dclaimer);
-      int strength_old, strength_new;
+  if (radius_sq >= 0) {
+    circle_iterate(&(wld.map), psource, radius_sq, ptile) {
+      borders_cache.dirty[tile_index(ptile)] = TRUE;
+    } circle_iterate_end;
+  }
+}
 
-      if (ccity != NULL) {
-        /* Previously claimed by city */
-        int city_x, city_y;
+/**********************************************************************//**
+  Make the next map_calculate_borders() recalculate all border sources.
+**************************************************************************/
+void map_borders_invalidate(void)
+{
+  borders_cache.all_dirty = TRUE;
+}
 
-        map_distance_vector(&city_x, &city_y, ccity->tile, dtile);
+/**********************************************************************//**
+  Free the incremental border recalculation state.
+**************************************************************************/
+void map_borders_free(void)
+{
+  FC_FREE(borders_cache.tiles);
+  FC_FREE(borders_cache.sources);
+  FC_FREE(borders_cache.dirty);
+  FC_FREE(borders_cache.dirty_next);
+  borders_cache.num_tiles = 0;
+  borders_cache.all_dirty = TRUE;
+}
 
-        if (map_vector_to_sq_distance(city_x, city_y)
-            <= city_map_radius_sq_get(ccity)
-               + game.info.border_city_permanent_radius_sq) {
-          /* Tile is within region permanently claimed by city */
-          continue;
+/**********************************************************************//**
+  Can the Tile_Claimable effects only change with the things the border
+  cache keeps track of, i.e. the terrain and extras of the tile and its
+  neighbours?
+**************************************************************************/
+static bool tile_claimable_is_local(void)
+{
+  effect_list_iterate(get_effects(EFT_TILE_CLAIMABLE), peffect) {
+    if (peffect->multiplier != nullptr) {
+      return FALSE;
+    }
+
+    requirement_vector_iterate(&peffect->reqs, preq) {
+      switch (preq->source.kind) {
+      case VUT_NONE:
+      case VUT_TERRAIN:
+      case VUT_TERRAINCLASS:
+      case VUT_TERRFLAG:
+      case VUT_TERRAINALTER:
+      case VUT_TILE_REL:
+      case VUT_MAX_DISTANCE_SQ:
+      case VUT_MAX_REGION_TILES:
+      case VUT_MINLATITUDE:
+      case VUT_MAXLATITUDE:
+      case VUT_TOPO:
+      case VUT_WRAP:
+        /* Only change with terrain, which recalculates everything */
+        break;
+      case VUT_EXTRA:
+      case VUT_EXTRAFLAG:
+      case VUT_ROADFLAG:
+        if (preq->range != REQ_RANGE_TILE
+            && preq->range != REQ_RANGE_CADJACENT
+            && preq->range != REQ_RANGE_ADJACENT) {
+          return FALSE;
         }
+        break;
+      default:
+        return FALSE;
       }
+    } requirement_vector_iterate_end;
+  } effect_list_iterate_end;
 
-      strength_old = tile_border_strength(dtile, dclaimer);
-      strength_new = tile_border_strength(dtile, ptile);
+  return TRUE;
+}
 
-      if (strength_new <= strength_old) {
-        /* Stronger shall prevail,
-         * in case of equal strength older shall prevail */
-        continue;
-      }
+/**********************************************************************//**
+  Current border source state of the tile.
+**************************************************************************/
+static void border_source_state_get(struct tile *ptile,
+                                    struct border_source_state *pstate)
+{
+  memset(pstate, 0, sizeof(*pstate));
+  pstate->city_radius_sq = -1;
+
+  if (is_border_source(ptile)) {
+    struct city *pcity = tile_city(ptile);
+
+    pstate->owner = tile_owner(ptile);
+    pstate->radius_sq = tile_border_source_radius_sq(ptile);
+    pstate->strength = tile_border_source_strength(ptile);
+    pstate->city_radius_sq = (pcity != nullptr
+                              ? city_map_radius_sq_get(pcity) : -1);
+  } else {
+    pstate->radius_sq = -1;
+  }
+}
+
+/**********************************************************************//**
+  Compare the tiles and border sources with the state stored after the
+  previous run, and mark what has changed. Returns FALSE if all sources
+  must be recalculated.
+**************************************************************************/
+static bool map_borders_find_changes(bool *changed_sources)
+{
+  bool local = TRUE;
+
+  whole_map_iterate(&(wld.map), ptile) {
+    int idx = tile_index(ptile);
+    struct border_tile_state *pts = borders_cache.tiles + idx;
+    struct border_source_state src;
+
+    if (pts->terrain != tile_terrain(ptile)
+        || pts->continent != tile_continent(ptile)) {
+      /* Can change regions far away */
+      local = FALSE;
+    }
+    if (!BV_ARE_EQUAL(pts->extras, *tile_extras(ptile))
+        || pts->owner != tile_owner(ptile)
+        || pts->claimer != tile_claimer(ptile)) {
+      borders_cache.dirty[idx] = TRUE;
+      adjc_iterate(&(wld.map), ptile, adjc_tile) {
+        borders_cache.dirty[tile_index(adjc_tile)] = TRUE;
+      } adjc_iterate_end;
     }
 
-    /* Only certain tiles are claimable */
-    if (is_tile_claimable(dtile, ptile, owner)) {
-      map_claim_ownership(dtile, owner, ptile, dr == 0);
+    border_source_state_get(ptile, &src);
+    if (memcmp(&src, borders_cache.sources + idx, sizeof(src)) != 0) {
+      changed_sources[idx] = TRUE;
+      map_border_mark_circle(ptile, borders_cache.sources + idx);
+      map_border_mark_circle(ptile, &src);
     }
-  } circle_dxyr_iterate_end;
+  } whole_map_iterate_end;
+
+  return local;
+}
+
+/**********************************************************************//**
+  Store the state of all tiles and border sources after a run.
+**************************************************************************/
+static void map_borders_store(void)
+{
+  whole_map_iterate(&(wld.map), ptile) {
+    int idx = tile_index(ptile);
+    struct border_tile_state *pts = borders_cache.tiles + idx;
+
+    pts->terrain = tile_terrain(ptile);
+    pts->extras = *tile_extras(ptile);
+    pts->continent = tile_continent(ptile);
+    pts->owner = tile_owner(ptile);
+    pts->claimer = tile_claimer(ptile);
+    border_source_state_get(ptile, borders_cache.sources + idx);
+  } whole_map_iterate_end;
+}
+
+/**********************************************************************//**
+  Does any tile within radius of the border source need recalculation?
+**************************************************************************/
+static bool map_border_source_dirty(struct tile *psource)
+{
+  circle_iterate(&(wld.map), psource,
+                 tile_border_source_radius_sq(psource), ptile) {
+    if (borders_cache.dirty[tile_index(ptile)]) {
+      return TRUE;
+    }
+  } circle_iterate_end;
+
+  return FALSE;
+}
+
+/**********************************************************************//**
+  Has the tile changed during the latest map_calculate_borders(), so
+  that a source before it may claim it only on the next run?
+**************************************************************************/
+bool map_border_tile_pending(const struct tile *ptile)
+{
+  return (borders_cache.num_tiles > 0
+          && !borders_cache.all_dirty
+          && borders_cache.dirty[tile_index(ptile)]);
 }
 
 /**********************************************************************//**
   Update borders for all sources. Call this on turn end.
+
+  Only the sources that could claim something, because they or tiles
+  within their radius have changed since the previous call, are
+  recalculated. The result is the same as recalculating all of them.
 **************************************************************************/
 void map_calculate_borders(void)
 {
+  bool full;
+  bool *changed_sources;
+
   if (BORDERS_DISABLED == game.info.borders) {
     return;
   }
@@ -2339,11 +2676,54 @@ void map_calculate_borders(void)
 
   log_verbose("map_calculate_borders()");
 
+  if (borders_cache.num_tiles != MAP_INDEX_SIZE) {
+    map_borders_free();
+    borders_cache.num_tiles = MAP_INDEX_SIZE;
+    borders_cache.tiles = fc_calloc(MAP_INDEX_SIZE,
+                                    sizeof(*borders_cache.tiles));
+    borders_cache.sources = fc_calloc(MAP_INDEX_SIZE,
+                                      sizeof(*borders_cache.sources));
+    borders_cache.dirty = fc_calloc(MAP_INDEX_SIZE,
+                                    sizeof(*borders_cache.dirty));
+    borders_cache.dirty_next = fc_calloc(MAP_INDEX_SIZE,
+                                         sizeof(*borders_cache.dirty_next));
+  }
+
+  changed_sources = fc_calloc(MAP_INDEX_SIZE, sizeof(*changed_sources));
+
+  full = (borders_cache.all_dirty
+          || borders_cache.mode != game.info.borders
+          || borders_cache.permanent_radius_sq
+             != game.info.border_city_permanent_radius_sq
+          || !tile_claimable_is_local());
+  if (!map_borders_find_changes(changed_sources)) {
+    full = TRUE;
+  }
+
+  borders_cache.in_pass = TRUE;
   whole_map_iterate(&(wld.map), ptile) {
-    if (is_border_source(ptile)) {
+    if (is_border_source(ptile)
+        && (full || changed_sources[tile_index(ptile)]
+            || map_border_source_dirty(ptile))) {
       map_claim_border(ptile, ptile->owner, -1);
     }
   } whole_map_iterate_end;
+  borders_cache.in_pass = FALSE;
+
+  free(changed_sources);
+
+  /* What changed during this run is left for the next one. */
+  memcpy(borders_cache.dirty, borders_cache.dirty_next,
+         MAP_INDEX_SIZE * sizeof(*borders_cache.dirty));
+  memset(borders_cache.dirty_next, 0,
+         MAP_INDEX_SIZE * sizeof(*borders_cache.dirty_next));
+  map_borders_store();
+  borders_cache.all_dirty = FALSE;
+  borders_cache.mode = game.info.borders;
+  borders_cache.permanent_radius_sq
+    = game.info.border_city_permanent_radius_sq;
+
+  sanity_check_borders();
 
   log_verbose("map_calculate_borders() workers");
   city_thaw_workers_queue();
@@ -2491,7 +2871,25 @@ void vision_clear_sight(struct vision *vision)
   const v_radius_t vision_radius_sq = V_RADIUS(-1, -1, -1);
 
   vision_change_sight(vision, vision_radius_sq);
+  vision_arrange_fogged_cities();
+}
+
+/**********************************************************************//**
+  Set the sight points of the vision source without fogging or unfogging
+  anything; the caller has already changed the seen counts, see
+  map_vision_shift().
+**************************************************************************/
+void vision_set_sight(struct vision *vision, const v_radius_t radius_sq)
+{
+  memcpy(vision->radius_sq, radius_sq, sizeof(v_radius_t));
+}
 
+/**********************************************************************//**
+  Rearrange the workers of the cities that lost sight of a worked tile
+  when vision was cleared.
+**************************************************************************/
+void vision_arrange_fogged_cities(void)
+{
   /* Owner of some city might have lost vision of a tile previously worked */
   players_iterate(pplayer) {
     city_list_iterate(pplayer->cities, pcity) {
@@ -14,9 +14,11 @@
 #define FC__MAPHAND_H
 
 /* common */
+#include "extras.h"
 #include "fc_types.h"
 #include "map.h"
 #include "packets.h"
+#include "player.h"
 #include "terrain.h"
 #include "vision.h"
 
@@ -27,13 +29,13 @@ struct section_file;
 struct conn_list;
 
 
+/* What a player knows about a tile. There is one for every tile and
+ * player, so it is kept small: the terrain, resource and owners are
+ * stored as their index plus one, 0 standing for none, and read and
+ * written through the player_tile_*() accessors below. */
 struct player_tile {
   struct vision_site *site;		/* NULL for no vision site */
-  struct extra_type *resource;          /* NULL for no resource */
-  struct terrain *terrain;		/* NULL for unknown tiles */
-  struct player *owner; 		/* NULL for unowned */
-  struct player *extras_owner;
-  struct dbv extras;
+  bv_extras extras;
 
   /* If you build a city with an unknown square within city radius
      the square stays unknown. However, we still have to keep count
@@ -42,8 +44,97 @@ struct player_tile {
   v_radius_t own_seen;
   v_radius_t seen_count;
   short last_updated;
+
+  unsigned char terrain;                /* 0 for unknown tiles */
+  unsigned char resource;               /* 0 for no resource */
+  unsigned short owner;                 /* 0 for unowned */
+  unsigned short extras_owner;
 };
 
+FC_STATIC_ASSERT(MAX_NUM_TERRAINS < 0xFF, player_tile_terrain_fits);
+FC_STATIC_ASSERT(MAX_EXTRA_TYPES < 0xFF, player_tile_resource_fits);
+FC_STATIC_ASSERT(MAX_NUM_PLAYER_SLOTS < 0xFFFF, player_tile_owner_fits);
+
+/**********************************************************************//**
+  Return the terrain the player knows the tile to have, T_UNKNOWN for
+  unknown tiles.
+**************************************************************************/
+static inline struct terrain *
+player_tile_terrain(const struct player_tile *plrtile)
+{
+  return (plrtile->terrain == 0 ? T_UNKNOWN
+          : terrain_by_number(plrtile->terrain - 1));
+}
+
+/**********************************************************************//**
+  Set the terrain the player knows the tile to have.
+**************************************************************************/
+static inline void player_tile_set_terrain(struct player_tile *plrtile,
+                                           const struct terrain *pterrain)
+{
+  plrtile->terrain = (pterrain == T_UNKNOWN ? 0
+                      : terrain_number(pterrain) + 1);
+}
+
+/**********************************************************************//**
+  Return the resource the player knows to be on the tile, or NULL.
+**************************************************************************/
+static inline struct extra_type *
+player_tile_resource(const struct player_tile *plrtile)
+{
+  return (plrtile->resource == 0 ? NULL
+          : extra_by_number(plrtile->resource - 1));
+}
+
+/**********************************************************************//**
+  Set the resource the player knows to be on the tile.
+**************************************************************************/
+static inline void player_tile_set_resource(struct player_tile *plrtile,
+                                            const struct extra_type *pres)
+{
+  plrtile->resource = (pres == NULL ? 0 : extra_number(pres) + 1);
+}
+
+/**********************************************************************//**
+  Return the owner the player knows the tile to have, or NULL.
+**************************************************************************/
+static inline struct player *
+player_tile_owner(const struct player_tile *plrtile)
+{
+  return (plrtile->owner == 0 ? NULL
+          : player_by_number(plrtile->owner - 1));
+}
+
+/**********************************************************************//**
+  Set the owner the player knows the tile to have.
+**************************************************************************/
+static inline void player_tile_set_owner(struct player_tile *plrtile,
+                                         const struct player *powner)
+{
+  plrtile->owner = (powner == NULL ? 0 : player_number(powner) + 1);
+}
+
+/**********************************************************************//**
+  Return the owner of the extras the player knows of, or NULL.
+**************************************************************************/
+static inline struct player *
+player_tile_extras_owner(const struct player_tile *plrtile)
+{
+  return (plrtile->extras_owner == 0 ? NULL
+          : player_by_number(plrtile->extras_owner - 1));
+}
+
+/**********************************************************************//**
+  Set the owner of the extras the player knows of.
+**************************************************************************/
+static inline void
+player_tile_set_extras_owner(struct player_tile *plrtile,
+                             const struct player *powner)
+{
+  plrtile->extras_owner = (powner == NULL ? 0
+                           : player_number(powner) + 1);
+}
+
 void global_warming(int effect);
 void nuclear_winter(int effect);
 void climate_change(bool warming, int effect);
@@ -70,6 +161,12 @@ void map_vision_update(struct player *pplayer, struct tile *ptile,
                        const v_radius_t old_radius_sq,
                        const v_radius_t new_radius_sq,
                        bool can_reveal_tiles);
+void map_vision_shift(struct player *pplayer,
+                      const struct tile *from_tile,
+                      const v_radius_t from_radius_sq,
+                      struct tile *to_tile,
+                      const v_radius_t to_radius_sq,
+                      int count, bool can_reveal_tiles);
 void map_set_border_vision(struct player *pplayer,
                            const bool is_enabled);
 void map_show_all(struct player *pplayer);
@@ -109,6 +206,11 @@ void enable_fog_of_war_player(struct player *pplayer);
 void disable_fog_of_war_player(struct player *pplayer);
 
 void map_calculate_borders(void);
+void map_borders_invalidate(void);
+void map_borders_free(void);
+bool map_border_claim_wanted(struct tile *ptile, struct tile *psource,
+                             struct player *owner, int dr);
+bool map_border_tile_pending(const struct tile *ptile);
 void map_claim_border(struct tile *ptile, struct player *powner,
                       int radius_sq);
 void map_claim_ownership(struct tile *ptile, struct player *powner,
@@ -132,7 +234,9 @@ void bounce_units_on_terrain_change(struct tile *ptile);
 
 void vision_change_sight(struct vision *vision,
                          const v_radius_t radius_sq);
+void vision_set_sight(struct vision *vision, const v_radius_t radius_sq);
 void vision_clear_sight(struct vision *vision);
+void vision_arrange_fogged_cities(void);
 
 void change_playertile_site(struct player_tile *ptile,
                             struct vision_site *new_site);
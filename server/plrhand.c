@@ -1653,7 +1653,7 @@ void server_player_init(struct player *pplayer, bool initmap,
 
   adv_data_default(pplayer);
 
-  /* We don't push this in calc_civ_score(), or it will be reset
+  /* We don't push this in calc_civ_scores(), or it will be reset
    * every turn. */
   pplayer->score.units_built = 0;
   pplayer->score.units_killed = 0;
@@ -2042,7 +2042,9 @@ void server_remove_player(struct player *pplayer)
   /* Must be called after the player was destroyed */
   send_player_remove_info_c(pslot, nullptr);
 
-  /* Recalculate borders. */
+  /* Recalculate borders. The player pointer may be reused, so
+   * everything must be recalculated. */
+  map_borders_invalidate();
   map_calculate_borders();
 }
 
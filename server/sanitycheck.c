@@ -21,6 +21,7 @@
 
 /* common */
 #include "ai.h"
+#include "borders.h"
 #include "city.h"
 #include "game.h"
 #include "government.h"
@@ -718,4 +719,35 @@ void real_sanity_check_tile(struct tile *ptile, const char *file,
   } unit_list_iterate_end;
 }
 
+/**********************************************************************//**
+  Verify that the borders are what recalculating every border source
+  would make them, i.e. that no source would claim anything more. Tiles
+  that changed during the latest map_calculate_borders() are left for
+  the next one.
+**************************************************************************/
+void real_sanity_check_borders(const char *file, const char *function,
+                               int line)
+{
+  if (BORDERS_DISABLED == game.info.borders) {
+    return;
+  }
+
+  whole_map_iterate(&(wld.map), psource) {
+    struct player *owner = tile_owner(psource);
+
+    if (owner == NULL || !is_border_source(psource)) {
+      continue;
+    }
+
+    circle_dxyr_iterate(&(wld.map), psource,
+                        tile_border_source_radius_sq(psource),
+                        ptile, dx, dy, dr) {
+      if (!map_border_tile_pending(ptile)) {
+        SANITY_TILE(ptile, !map_border_claim_wanted(ptile, psource,
+                                                    owner, dr));
+      }
+    } circle_dxyr_iterate_end;
+  } whole_map_iterate_end;
+}
+
 #endif /* SANITY_CHECKING */
@@ -33,6 +33,11 @@ void real_sanity_check_city(struct city *pcity, const char *file,
 void real_sanity_check_tile(struct tile *ptile, const char *file,
                             const char *function, int line);
 
+#  define sanity_check_borders() \
+  real_sanity_check_borders(__FILE__, __FUNCTION__, __FC_LINE__)
+void real_sanity_check_borders(const char *file, const char *function,
+                               int line);
+
 #  define sanity_check() \
   real_sanity_check(__FILE__, __FUNCTION__, __FC_LINE__)
 void real_sanity_check( const char *file, const char *function, int line);
@@ -41,6 +46,7 @@ void real_sanity_check( const char *file, const char *function, int line);
 
 #  define sanity_check_city(x) (void)0
 #  define sanity_check_tile(x) (void)0
+#  define sanity_check_borders() (void)0
 #  define sanity_check() (void)0
 
 #endif /* SANITY_CHECKING */
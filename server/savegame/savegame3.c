@@ -209,8 +209,9 @@ extern bool sg_success;
  *                  will be the y coordinate
  * Example:
  *   LOAD_MAP_CHAR(ch, ptile,
- *                 map_get_player_tile(ptile, plr)->terrain
- *                   = char2terrain(ch), file, "player%d.map_t%04d", plrno);
+ *                 player_tile_set_terrain(map_get_player_tile(ptile, plr),
+ *                                         char2terrain(ch)),
+ *                 file, "player%d.map_t%04d", plrno);
  *
  * Note: some (but not all) of the code this is replacing used to skip over
  *       lines that did not exist. This allowed for backward-compatibility.
@@ -311,10 +312,7 @@ static void worklist_save(struct section_file *file,
                           int max_length, const char *path, ...);
 static void unit_ordering_calc(void);
 static void unit_ordering_apply(void);
-static void sg_extras_set_dbv(struct dbv *extras, char ch, struct extra_type **idx);
 static void sg_extras_set_bv(bv_extras *extras, char ch, struct extra_type **idx);
-static char sg_extras_get_dbv(struct dbv *extras, struct extra_type *presource,
-                              const int *idx);
 static char sg_extras_get_bv(bv_extras extras, struct extra_type *presource,
                              const int *idx);
 static struct terrain *char2terrain(char ch);
@@ -1090,39 +1088,6 @@ static void unit_ordering_apply(void)
   } whole_map_iterate_end;
 }
 
-/************************************************************************//**
-  Helper function for loading extras from a savegame.
-
-  'ch' gives the character loaded from the savegame. Extras are packed
-  in four to a character in hex notation. 'index' is a mapping of
-  savegame bit -> base bit.
-****************************************************************************/
-static void sg_extras_set_dbv(struct dbv *extras, char ch,
-                              struct extra_type **idx)
-{
-  int i, bin;
-  const char *pch = strchr(hex_chars, ch);
-
-  if (!pch || ch == '\0') {
-    log_sg("Unknown hex value: '%c' (%d)", ch, ch);
-    bin = 0;
-  } else {
-    bin = pch - hex_chars;
-  }
-
-  for (i = 0; i < 4; i++) {
-    struct extra_type *pextra = idx[i];
-
-    if (pextra == NULL) {
-      continue;
-    }
-    if ((bin & (1 << i))
-        && (wld.map.server.have_huts || !is_extra_caused_by(pextra, EC_HUT))) {
-      dbv_set(extras, extra_index(pextra));
-    }
-  }
-}
-
 /************************************************************************//**
   Helper function for loading extras from a savegame.
 
@@ -1156,39 +1121,6 @@ static void sg_extras_set_bv(bv_extras *extras, char ch,
   }
 }
 
-/************************************************************************//**
-  Helper function for saving extras into a savegame.
-
-  Extras are packed in four to a character in hex notation. 'index'
-  specifies which set of extras are included in this character.
-****************************************************************************/
-static char sg_extras_get_dbv(struct dbv *extras, struct extra_type *presource,
-                              const int *idx)
-{
-  int i, bin = 0;
-  int max = dbv_bits(extras);
-
-  for (i = 0; i < 4; i++) {
-    int extra = idx[i];
-
-    if (extra < 0) {
-      break;
-    }
-
-    if (extra < max
-        && (dbv_isset(extras, extra)
-            /* An invalid resource, a resource that can't exist at the tile's
-             * current terrain, isn't in the bit extra vector. Save it so it
-             * can return if the tile's terrain changes to something it can
-             * exist on. */
-            || extra_by_number(extra) == presource)) {
-      bin |= (1 << i);
-    }
-  }
-
-  return hex_chars[bin];
-}
-
 /************************************************************************//**
   Helper function for saving extras into a savegame.
 
@@ -4127,6 +4059,7 @@ static void sg_load_players(struct loaddata *loading)
   unit_ordering_apply();
 
   /* All vision is ready; this calls city_thaw_workers_queue(). */
+  map_borders_invalidate();
   map_calculate_borders();
 
   /* Make sure everything is consistent. */
@@ -7237,15 +7170,15 @@ static void sg_load_player_vision(struct loaddata *loading,
 
   /* Load player map (terrain). */
   LOAD_MAP_CHAR(ch, ptile,
-                map_get_player_tile(ptile, plr)->terrain
-                  = char2terrain(ch), loading->file,
+                player_tile_set_terrain(map_get_player_tile(ptile, plr),
+                                        char2terrain(ch)), loading->file,
                 "player%d.map_t%04d", plrno);
 
   /* Load player map (extras). */
   halfbyte_iterate_extras(j, loading->extra.size) {
     LOAD_MAP_CHAR(ch, ptile,
-                  sg_extras_set_dbv(&(map_get_player_tile(ptile, plr)->extras),
-                                    ch, loading->extra.order + 4 * j),
+                  sg_extras_set_bv(&(map_get_player_tile(ptile, plr)->extras),
+                                   ch, loading->extra.order + 4 * j),
                   loading->file, "player%d.map_e%02d_%04d", plrno, j);
   } halfbyte_iterate_extras_end;
 
@@ -7257,7 +7190,7 @@ static void sg_load_player_vision(struct loaddata *loading,
       int pres_id = extra_number(pres);
 
       if (BV_ISSET(plrtile->extras, pres_id)) {
-        if (plrtile->terrain == nullptr) {
+        if (player_tile_terrain(plrtile) == T_UNKNOWN) {
           if (!regr_warn) {
             sg_regr(3030000, "FoW tile (%d, %d) has extras, though it's on unknown.",
                     TILE_XY(ptile));
@@ -7265,8 +7198,8 @@ static void sg_load_player_vision(struct loaddata *loading,
           }
           BV_CLR(plrtile->extras, pres_id);
         } else {
-          plrtile->resource = pres;
-          if (!terrain_has_resource(plrtile->terrain, pres)) {
+          player_tile_set_resource(plrtile, pres);
+          if (!terrain_has_resource(player_tile_terrain(plrtile), pres)) {
             BV_CLR(plrtile->extras, pres_id);
           }
         }
@@ -7300,24 +7233,27 @@ static void sg_load_player_vision(struct loaddata *loading,
         sg_failure_ret('\0' != token[0],
                        "Savegame corrupt - map size not correct.");
         if (strcmp(token, "-") == 0) {
-          map_get_player_tile(ptile, plr)->owner = NULL;
+          player_tile_set_owner(map_get_player_tile(ptile, plr), NULL);
         } else  {
           sg_failure_ret(str_to_int(token, &number),
                          "Savegame corrupt - got tile owner=%s in (%d, %d).",
                          token, x, y);
-          map_get_player_tile(ptile, plr)->owner = player_by_number(number);
+          player_tile_set_owner(map_get_player_tile(ptile, plr),
+                                player_by_number(number));
         }
 
         scanin(&ptr2, ",", token2, sizeof(token2));
         sg_failure_ret('\0' != token2[0],
                        "Savegame corrupt - map size not correct.");
         if (strcmp(token2, "-") == 0) {
-          map_get_player_tile(ptile, plr)->extras_owner = NULL;
+          player_tile_set_extras_owner(map_get_player_tile(ptile, plr),
+                                         NULL);
         } else  {
           sg_failure_ret(str_to_int(token2, &number),
                          "Savegame corrupt - got extras owner=%s in (%d, %d).",
                          token, x, y);
-          map_get_player_tile(ptile, plr)->extras_owner = player_by_number(number);
+          player_tile_set_extras_owner(map_get_player_tile(ptile, plr),
+                                         player_by_number(number));
         }
       }
     }
@@ -7374,7 +7310,7 @@ static void sg_load_player_vision(struct loaddata *loading,
       /* Non fogged borders aren't loaded. See hrm Bug #879084 */
       struct player_tile *plrtile = map_get_player_tile(ptile, plr);
 
-      plrtile->owner = tile_owner(ptile);
+      player_tile_set_owner(plrtile, tile_owner(ptile));
     }
   } whole_map_iterate_end;
 }
@@ -7519,7 +7455,7 @@ static void sg_save_player_vision(struct savedata *saving,
 
   /* Save the map (terrain). */
   SAVE_MAP_CHAR(ptile,
-                terrain2char(map_get_player_tile(ptile, plr)->terrain),
+                terrain2char(player_tile_terrain(map_get_player_tile(ptile, plr))),
                 saving->file, "player%d.map_t%04d", plrno);
 
   if (game.server.foggedborders) {
@@ -7535,11 +7471,11 @@ static void sg_save_player_vision(struct savedata *saving,
         struct tile *ptile = native_pos_to_tile(&(wld.map), x, y);
         struct player_tile *plrtile = map_get_player_tile(ptile, plr);
 
-        if (plrtile == NULL || plrtile->owner == NULL) {
+        if (plrtile == NULL || player_tile_owner(plrtile) == NULL) {
           strcpy(token, "-");
         } else {
           fc_snprintf(token, sizeof(token), "%d",
-                      player_number(plrtile->owner));
+                      player_number(player_tile_owner(plrtile)));
         }
         strcat(line, token);
         if (x < MAP_NATIVE_WIDTH) {
@@ -7559,11 +7495,11 @@ static void sg_save_player_vision(struct savedata *saving,
         struct tile *ptile = native_pos_to_tile(&(wld.map), x, y);
         struct player_tile *plrtile = map_get_player_tile(ptile, plr);
 
-        if (plrtile == NULL || plrtile->extras_owner == NULL) {
+        if (plrtile == NULL || player_tile_extras_owner(plrtile) == NULL) {
           strcpy(token, "-");
         } else {
           fc_snprintf(token, sizeof(token), "%d",
-                      player_number(plrtile->extras_owner));
+                      player_number(player_tile_extras_owner(plrtile)));
         }
         strcat(line, token);
         if (x < MAP_NATIVE_WIDTH) {
@@ -7589,9 +7525,10 @@ static void sg_save_player_vision(struct savedata *saving,
     }
 
     SAVE_MAP_CHAR(ptile,
-                  sg_extras_get_dbv(&(map_get_player_tile(ptile, plr)->extras),
-                                    map_get_player_tile(ptile, plr)->resource,
-                                    mod),
+                  sg_extras_get_bv(map_get_player_tile(ptile, plr)->extras,
+                                   player_tile_resource(
+                                     map_get_player_tile(ptile, plr)),
+                                   mod),
                   saving->file, "player%d.map_e%02d_%04d", plrno, j);
   } halfbyte_iterate_extras_end;
 
@@ -19,6 +19,7 @@
 #include "log.h"
 #include "mem.h"
 #include "registry.h"
+#include "timing.h"
 
 /* common */
 #include "ai.h"
@@ -47,6 +48,7 @@ static fc_thread *save_thread = nullptr;
 void savegame_load(struct section_file *sfile)
 {
   const char *savefile_options;
+  PROF_ZONE_BEGIN(prof_start);
 
   fc_assert_ret(sfile != nullptr);
 
@@ -94,6 +96,8 @@ void savegame_load(struct section_file *sfile)
   log_debug("Loading secfile in %.3f seconds.", timer_read_seconds(loadtimer));
   timer_destroy(loadtimer);
 #endif // DEBUG_TIMERS
+
+  PROF_ZONE_END(prof_start, "savegame_load");
 }
 
 /************************************************************************//**
@@ -102,7 +106,11 @@ void savegame_load(struct section_file *sfile)
 void savegame_save(struct section_file *sfile, const char *save_reason,
                    bool scenario)
 {
+  PROF_ZONE_BEGIN(prof_start);
+
   savegame3_save(sfile, save_reason, scenario);
+
+  PROF_ZONE_END(prof_start, "savegame_save");
 }
 
 struct save_thread_data
@@ -317,7 +325,11 @@ void save_game(const char *orig_filename, const char *save_reason,
   if (save_thread != nullptr) {
     fc_thread_start(save_thread, &save_thread_run, stdata);
   } else {
+    PROF_ZONE_BEGIN(prof_start);
+
     save_thread_run(stdata);
+
+    PROF_ZONE_END(prof_start, "savegame_write");
   }
 
 #ifdef LOG_TIMERS
@@ -156,9 +156,72 @@ static void print_landarea_map(struct claim_map *pcmap, int turn)
 #endif /* LAND_AREA_DEBUG > 2 */
 
 /**********************************************************************//**
-  Count landarea, settled area, and claims map for all players.
+  Return whether the tile is in the city map of any of the player's
+  cities.
+**************************************************************************/
+static bool player_claims_tile(const struct player *pplayer,
+                               const struct tile *ptile)
+{
+  city_list_iterate(pplayer->cities, pcity) {
+    if (city_map_includes_tile(pcity, ptile)) {
+      return TRUE;
+    }
+  } city_list_iterate_end;
+
+  return FALSE;
+}
+
+/**********************************************************************//**
+  Count landarea and settled area for all players in one pass over the
+  map. Claims are checked only for the tiles that have nothing but units
+  on them, so no claim map of the whole map is built.
 **************************************************************************/
 static void build_landarea_map(struct claim_map *pcmap)
+{
+  const struct civ_map *nmap = &(wld.map);
+
+  memset(pcmap, 0, sizeof(*pcmap));
+
+  whole_map_iterate(nmap, ptile) {
+    struct player *owner = nullptr;
+
+    if (is_ocean_tile(ptile)) {
+      /* Nothing. */
+    } else if (tile_city(ptile) != nullptr) {
+      owner = city_owner(tile_city(ptile));
+      pcmap->player[player_index(owner)].settledarea++;
+    } else if (tile_worked(ptile) != nullptr) {
+      owner = city_owner(tile_worked(ptile));
+      pcmap->player[player_index(owner)].settledarea++;
+    } else if (unit_list_size(ptile->units) > 0) {
+      /* Because of allied stacking these calculations are a bit off. */
+      owner = unit_owner(unit_list_get(ptile->units, 0));
+      if (player_claims_tile(owner, ptile)) {
+        pcmap->player[player_index(owner)].settledarea++;
+      }
+    }
+
+    if (BORDERS_DISABLED != game.info.borders) {
+      /* If borders are enabled, use owner information directly from the
+       * map. Otherwise use the calculations above. */
+      owner = tile_owner(ptile);
+    }
+    if (owner) {
+      pcmap->player[player_index(owner)].landarea++;
+    }
+  } whole_map_iterate_end;
+
+#if LAND_AREA_DEBUG >= 2
+  print_landarea_map(pcmap, turn);
+#endif
+}
+
+#ifdef FREECIV_DEBUG
+/**********************************************************************//**
+  Count landarea and settled area for all players the long way, with a
+  claim map of the whole map. Used to cross-check build_landarea_map().
+**************************************************************************/
+static void build_landarea_map_full(struct claim_map *pcmap)
 {
   bv_player *claims = fc_calloc(MAP_INDEX_SIZE, sizeof(*claims));
   const struct civ_map *nmap = &(wld.map);
@@ -207,11 +270,32 @@ static void build_landarea_map(struct claim_map *pcmap)
   } whole_map_iterate_end;
 
   FC_FREE(claims);
+}
 
-#if LAND_AREA_DEBUG >= 2
-  print_landarea_map(pcmap, turn);
-#endif
+/**********************************************************************//**
+  Check the land areas counted by build_landarea_map() against the ones
+  from the full claim map.
+**************************************************************************/
+static void check_landarea_map(const struct claim_map *pcmap)
+{
+  static struct claim_map full;
+
+  build_landarea_map_full(&full);
+
+  players_iterate(pplayer) {
+    int idx = player_index(pplayer);
+
+    fc_assert_msg(pcmap->player[idx].landarea == full.player[idx].landarea
+                  && (pcmap->player[idx].settledarea
+                      == full.player[idx].settledarea),
+                  "%s: land area %d/%d, settled area %d/%d",
+                  player_name(pplayer),
+                  pcmap->player[idx].landarea, full.player[idx].landarea,
+                  pcmap->player[idx].settledarea,
+                  full.player[idx].settledarea);
+  } players_iterate_end;
 }
+#endif /* FREECIV_DEBUG */
 
 /**********************************************************************//**
   Returns the given player's land and settled areas from a claim map.
@@ -246,14 +330,15 @@ static void get_player_landarea(struct claim_map *pcmap,
 }
 
 /**********************************************************************//**
-  Calculates the civilization score for the player.
+  Calculates the civilization score for the player. The land areas of
+  all players are in pcmap.
 **************************************************************************/
-void calc_civ_score(struct player *pplayer)
+static void calc_player_score(struct player *pplayer,
+                              struct claim_map *pcmap)
 {
   const struct research *presearch;
   struct city *wonder_city;
   int landarea = 0, settledarea = 0;
-  static struct claim_map cmap;
 
   pplayer->score.happy = 0;
   pplayer->score.content = 0;
@@ -303,9 +388,7 @@ void calc_civ_score(struct player *pplayer)
     pplayer->score.literacy += (city_population(pcity) * bonus) / 100;
   } city_list_iterate_end;
 
-  build_landarea_map(&cmap);
-
-  get_player_landarea(&cmap, pplayer, &landarea, &settledarea);
+  get_player_landarea(pcmap, pplayer, &landarea, &settledarea);
   pplayer->score.landarea = landarea;
   pplayer->score.settledarea = settledarea;
 
@@ -337,6 +420,24 @@ void calc_civ_score(struct player *pplayer)
   pplayer->score.game = get_civ_score(pplayer);
 }
 
+/**********************************************************************//**
+  Calculates the civilization scores of all players. The land area is
+  counted once for everybody, not again for each player.
+**************************************************************************/
+void calc_civ_scores(void)
+{
+  static struct claim_map cmap;
+
+  build_landarea_map(&cmap);
+#ifdef FREECIV_DEBUG
+  check_landarea_map(&cmap);
+#endif
+
+  players_iterate(pplayer) {
+    calc_player_score(pplayer, &cmap);
+  } players_iterate_end;
+}
+
 /**********************************************************************//**
   Return the score given by the units stats.
 **************************************************************************/
@@ -16,7 +16,7 @@
 /* common */
 #include "fc_types.h"
 
-void calc_civ_score(struct player *pplayer);
+void calc_civ_scores(void);
 
 int get_civ_score(const struct player *pplayer);
 
@@ -42,8 +42,10 @@
 
 /* utility */
 #include "capability.h"
+#include "fcthread.h"
 #include "log.h"
 #include "md5.h"
+#include "mem.h"
 #include "registry.h"
 #include "string_vector.h"
 
@@ -74,8 +76,12 @@
 
 #define FCDB_CAPS "+fcdb"
 
-static void script_fcdb_functions_define(void);
-static bool script_fcdb_functions_check(const char *fcdb_luafile);
+static void script_fcdb_functions_define(struct fc_lua *lfcl);
+static bool script_fcdb_functions_check(struct fc_lua *lfcl,
+                                        const char *fcdb_luafile);
+static struct fc_lua *script_fcdb_state_new(const char *fcdb_luafile);
+static void script_fcdb_auth_start(const char *fcdb_luafile);
+static void script_fcdb_auth_stop(void);
 
 static void script_fcdb_cmd_reply(struct fc_lua *lfcl, enum log_level level,
                                   const char *format, ...)
@@ -86,6 +92,38 @@ static void script_fcdb_cmd_reply(struct fc_lua *lfcl, enum log_level level,
 **************************************************************************/
 static struct fc_lua *fcl = NULL;
 
+/* A login request handed to the authentication worker. The connection
+ * data the script may read is copied, as the connection itself belongs
+ * to the main thread and can be closed meanwhile. */
+struct fcdb_auth_job {
+  struct fcdb_auth_result result;
+  char username[MAX_LEN_NAME];
+  char ipaddr[MAX_LEN_ADDR];
+  char password[MAX_LEN_PASSWORD];
+  enum cmdlevel access_level;
+  enum cmdlevel granted_access_level;
+};
+
+#define SPECLIST_TAG fcdb_auth_job
+#define SPECLIST_TYPE struct fcdb_auth_job
+#include "speclist.h"
+
+/**********************************************************************//**
+  The authentication worker runs the user_exists(), user_verify() and
+  user_save() calls in its own lua state, with its own database
+  connection, so that a slow database does not stall the main loop.
+**************************************************************************/
+static struct {
+  struct fc_lua *fcl;
+  fc_thread thread;
+  fc_mutex mutex;
+  fc_thread_cond cond;
+  struct fcdb_auth_job_list *requests;
+  struct fcdb_auth_job_list *results;
+  int pending;                  /* Requests without a fetched result. */
+  bool quit;
+} auth_worker;
+
 /**********************************************************************//**
   Add fcdb callback functions; these must be defined in the lua script
   'database.lua':
@@ -119,41 +157,42 @@ static struct fc_lua *fcl = NULL;
   If an error occurred, the functions return a non-NULL string error
   message as the last return value.
 **************************************************************************/
-static void script_fcdb_functions_define(void)
+static void script_fcdb_functions_define(struct fc_lua *lfcl)
 {
-  luascript_func_add(fcl, "database_init", TRUE, 0, 0);
-  luascript_func_add(fcl, "database_capstr", TRUE, 0, 1, API_TYPE_STRING);
-  luascript_func_add(fcl, "database_free", TRUE, 0, 0);
+  luascript_func_add(lfcl, "database_init", TRUE, 0, 0);
+  luascript_func_add(lfcl, "database_capstr", TRUE, 0, 1, API_TYPE_STRING);
+  luascript_func_add(lfcl, "database_free", TRUE, 0, 0);
 
-  luascript_func_add(fcl, "user_exists", TRUE, 1, 1, API_TYPE_CONNECTION,
+  luascript_func_add(lfcl, "user_exists", TRUE, 1, 1, API_TYPE_CONNECTION,
                      API_TYPE_BOOL);
-  luascript_func_add(fcl, "user_verify", TRUE, 2, 1, API_TYPE_CONNECTION,
+  luascript_func_add(lfcl, "user_verify", TRUE, 2, 1, API_TYPE_CONNECTION,
                      API_TYPE_STRING, API_TYPE_BOOL);
-  luascript_func_add(fcl, "user_save", FALSE, 2, 0, API_TYPE_CONNECTION,
+  luascript_func_add(lfcl, "user_save", FALSE, 2, 0, API_TYPE_CONNECTION,
                      API_TYPE_STRING);
-  luascript_func_add(fcl, "user_log", TRUE, 2, 0, API_TYPE_CONNECTION,
+  luascript_func_add(lfcl, "user_log", TRUE, 2, 0, API_TYPE_CONNECTION,
                      API_TYPE_BOOL);
-  luascript_func_add(fcl, "user_delegate_to", FALSE, 3, 1,
+  luascript_func_add(lfcl, "user_delegate_to", FALSE, 3, 1,
                      API_TYPE_CONNECTION, API_TYPE_PLAYER, API_TYPE_STRING,
                      API_TYPE_BOOL);
-  luascript_func_add(fcl, "user_take", FALSE, 4, 1, API_TYPE_CONNECTION,
+  luascript_func_add(lfcl, "user_take", FALSE, 4, 1, API_TYPE_CONNECTION,
                      API_TYPE_CONNECTION, API_TYPE_PLAYER, API_TYPE_BOOL,
                      API_TYPE_BOOL);
-  luascript_func_add(fcl, "conn_established", FALSE, 1, 0, API_TYPE_CONNECTION);
-  luascript_func_add(fcl, "game_start", FALSE, 1, 1,
+  luascript_func_add(lfcl, "conn_established", FALSE, 1, 0, API_TYPE_CONNECTION);
+  luascript_func_add(lfcl, "game_start", FALSE, 1, 1,
                      API_TYPE_INT, API_TYPE_INT);
 }
 
 /**********************************************************************//**
   Check the existence of all needed functions.
 **************************************************************************/
-static bool script_fcdb_functions_check(const char *fcdb_luafile)
+static bool script_fcdb_functions_check(struct fc_lua *lfcl,
+                                        const char *fcdb_luafile)
 {
   bool ret = TRUE;
   struct strvec *missing_func_required = strvec_new();
   struct strvec *missing_func_optional = strvec_new();
 
-  if (!luascript_func_check(fcl, missing_func_required,
+  if (!luascript_func_check(lfcl, missing_func_required,
                             missing_func_optional)) {
     strvec_iterate(missing_func_required, func_name) {
       log_error("Database script '%s' does not define the required function "
@@ -230,73 +269,249 @@ static int md5sum(lua_State *L)
   lua_pushstring(L, sum);
   return 1;
 }
-#endif /* HAVE_FCDB */
 
 /**********************************************************************//**
-  Initialize the scripting state. Returns the status of the freeciv
-  database lua state.
+  Create a lua state for the freeciv database and load the database
+  script into it. Returns NULL on failure.
 **************************************************************************/
-bool script_fcdb_init(const char *fcdb_luafile)
+static struct fc_lua *script_fcdb_state_new(const char *fcdb_luafile)
 {
-#ifdef HAVE_FCDB
-  if (fcl != NULL) {
-    fc_assert_ret_val(fcl->state != NULL, FALSE);
-
-    return TRUE;
-  }
+  struct fc_lua *lfcl = luascript_new(NULL, FALSE);
 
-  if (!fcdb_luafile) {
-    /* Use default freeciv database lua file. */
-    fcdb_luafile = FC_CONF_PATH "/" SCRIPT_FCDB_LUA_FILE;
-  }
-
-  fcl = luascript_new(NULL, FALSE);
-  if (fcl == NULL) {
+  if (lfcl == NULL) {
     log_error("Error loading the Freeciv database lua definition.");
-    return FALSE;
+    return NULL;
   }
 
-  tolua_common_a_open(fcl->state);
-  api_fcdb_specenum_open(fcl->state);
-  tolua_game_open(fcl->state);
+  tolua_common_a_open(lfcl->state);
+  api_fcdb_specenum_open(lfcl->state);
+  tolua_game_open(lfcl->state);
 
 #ifdef MESON_BUILD
   /* Tolua adds 'tolua_' prefix to _open() function names,
    * and we can't pass it a basename where the original
    * 'tolua_' has been stripped when generating from meson. */
-  tolua_tolua_fcdb_open(fcl->state);
+  tolua_tolua_fcdb_open(lfcl->state);
 #else  /* MESON_BUILD */
-  tolua_fcdb_open(fcl->state);
+  tolua_fcdb_open(lfcl->state);
 #endif /* MESON_BUILD */
-  lua_register(fcl->state, "md5sum", md5sum);
+  lua_register(lfcl->state, "md5sum", md5sum);
 #ifdef HAVE_FCDB_MYSQL
-  luaL_requiref(fcl->state, "ls_mysql", luaopen_luasql_mysql, 1);
-  lua_pop(fcl->state, 1);
+  luaL_requiref(lfcl->state, "ls_mysql", luaopen_luasql_mysql, 1);
+  lua_pop(lfcl->state, 1);
 #endif
 #ifdef HAVE_FCDB_ODBC
-  luaL_requiref(fcl->state, "ls_odbc", luaopen_luasql_odbc, 1);
-  lua_pop(fcl->state, 1);
+  luaL_requiref(lfcl->state, "ls_odbc", luaopen_luasql_odbc, 1);
+  lua_pop(lfcl->state, 1);
 #endif
 #ifdef HAVE_FCDB_POSTGRES
-  luaL_requiref(fcl->state, "ls_postgres", luaopen_luasql_postgres, 1);
-  lua_pop(fcl->state, 1);
+  luaL_requiref(lfcl->state, "ls_postgres", luaopen_luasql_postgres, 1);
+  lua_pop(lfcl->state, 1);
 #endif
 #ifdef HAVE_FCDB_SQLITE3
-  luaL_requiref(fcl->state, "ls_sqlite3", luaopen_luasql_sqlite3, 1);
-  lua_pop(fcl->state, 1);
+  luaL_requiref(lfcl->state, "ls_sqlite3", luaopen_luasql_sqlite3, 1);
+  lua_pop(lfcl->state, 1);
 #endif
-  tolua_common_z_open(fcl->state);
+  tolua_common_z_open(lfcl->state);
 
-  luascript_func_init(fcl);
+  luascript_func_init(lfcl);
 
   /* Define the prototypes for the needed lua functions. */
-  script_fcdb_functions_define();
+  script_fcdb_functions_define(lfcl);
 
-  if (luascript_do_file(fcl, fcdb_luafile)
-      || !script_fcdb_functions_check(fcdb_luafile)) {
+  if (luascript_do_file(lfcl, fcdb_luafile)
+      || !script_fcdb_functions_check(lfcl, fcdb_luafile)) {
     log_error("Error loading the Freeciv database lua script '%s'.",
               fcdb_luafile);
-    script_fcdb_free();
+    luascript_destroy(lfcl);
+    return NULL;
+  }
+
+  return lfcl;
+}
+
+#ifdef FREECIV_HAVE_THREAD_COND
+/**********************************************************************//**
+  Free a job, wiping the password it may hold.
+**************************************************************************/
+static void fcdb_auth_job_destroy(struct fcdb_auth_job *pjob)
+{
+  memset(pjob->password, 0, sizeof(pjob->password));
+  free(pjob);
+}
+
+/**********************************************************************//**
+  Run one authentication call in the worker's lua state. The script gets
+  a stand-in connection carrying the copied user data.
+**************************************************************************/
+static void script_fcdb_auth_run(struct fcdb_auth_job *pjob)
+{
+  struct fcdb_auth_result *presult = &pjob->result;
+  struct connection conn;
+
+  memset(&conn, 0, sizeof(conn));
+  conn.used = TRUE;
+  conn.id = presult->conn_id;
+  conn.access_level = pjob->access_level;
+  conn.server.granted_access_level = pjob->granted_access_level;
+  sz_strlcpy(conn.username, pjob->username);
+  sz_strlcpy(conn.server.ipaddr, pjob->ipaddr);
+
+  switch (presult->call) {
+  case FCDB_USER_EXISTS:
+    presult->success = luascript_func_call(auth_worker.fcl, "user_exists",
+                                           &conn, &presult->value);
+    break;
+  case FCDB_USER_VERIFY:
+    presult->success = luascript_func_call(auth_worker.fcl, "user_verify",
+                                           &conn, pjob->password,
+                                           &presult->value);
+    break;
+  case FCDB_USER_SAVE:
+    presult->success = luascript_func_call(auth_worker.fcl, "user_save",
+                                           &conn, pjob->password);
+    break;
+  }
+
+  memset(pjob->password, 0, sizeof(pjob->password));
+
+  /* auth.set_cmdlevel() only changed the stand-in; the main thread
+   * applies it to the real connection. */
+  presult->access_set = (conn.access_level != pjob->access_level);
+  presult->access_level = conn.access_level;
+}
+
+/**********************************************************************//**
+  Authentication worker thread main loop.
+**************************************************************************/
+static void script_fcdb_auth_thread(void *arg)
+{
+  fc_mutex_allocate(&auth_worker.mutex);
+  while (!auth_worker.quit) {
+    struct fcdb_auth_job *pjob
+      = fcdb_auth_job_list_front(auth_worker.requests);
+
+    if (pjob == NULL) {
+      fc_thread_cond_wait(&auth_worker.cond, &auth_worker.mutex);
+      continue;
+    }
+
+    fcdb_auth_job_list_pop_front(auth_worker.requests);
+    fc_mutex_release(&auth_worker.mutex);
+
+    script_fcdb_auth_run(pjob);
+
+    fc_mutex_allocate(&auth_worker.mutex);
+    fcdb_auth_job_list_append(auth_worker.results, pjob);
+  }
+  fc_mutex_release(&auth_worker.mutex);
+}
+#endif /* FREECIV_HAVE_THREAD_COND */
+
+/**********************************************************************//**
+  Start the authentication worker with a lua state of its own. If that
+  fails, authentication keeps running on the main thread.
+**************************************************************************/
+static void script_fcdb_auth_start(const char *fcdb_luafile)
+{
+#ifdef FREECIV_HAVE_THREAD_COND
+  struct fc_lua *lfcl = script_fcdb_state_new(fcdb_luafile);
+
+  if (lfcl != NULL && !luascript_func_call(lfcl, "database_init")) {
+    luascript_destroy(lfcl);
+    lfcl = NULL;
+  }
+  if (lfcl == NULL) {
+    log_error("Could not set up the database authentication worker, "
+              "authenticating in the main thread.");
+    return;
+  }
+
+  if (auth_worker.requests == NULL) {
+    auth_worker.requests = fcdb_auth_job_list_new();
+    auth_worker.results = fcdb_auth_job_list_new();
+    auth_worker.pending = 0;
+    fc_mutex_init(&auth_worker.mutex);
+    fc_thread_cond_init(&auth_worker.cond);
+  }
+  auth_worker.quit = FALSE;
+
+  if (fc_thread_start(&auth_worker.thread, script_fcdb_auth_thread,
+                      NULL) != 0) {
+    log_error("Could not start the database authentication worker, "
+              "authenticating in the main thread.");
+    luascript_func_call(lfcl, "database_free");
+    luascript_destroy(lfcl);
+    return;
+  }
+
+  auth_worker.fcl = lfcl;
+#endif /* FREECIV_HAVE_THREAD_COND */
+}
+
+/**********************************************************************//**
+  Stop the authentication worker. Requests it did not get to yet are
+  run right here, so that every queued request still gets its result.
+  The queues are freed once all the results have been fetched.
+**************************************************************************/
+static void script_fcdb_auth_stop(void)
+{
+#ifdef FREECIV_HAVE_THREAD_COND
+  if (auth_worker.fcl != NULL) {
+    struct fcdb_auth_job *pjob;
+
+    fc_mutex_allocate(&auth_worker.mutex);
+    auth_worker.quit = TRUE;
+    fc_thread_cond_signal(&auth_worker.cond);
+    fc_mutex_release(&auth_worker.mutex);
+    fc_thread_wait(&auth_worker.thread);
+
+    while ((pjob = fcdb_auth_job_list_front(auth_worker.requests))) {
+      fcdb_auth_job_list_pop_front(auth_worker.requests);
+      script_fcdb_auth_run(pjob);
+      fcdb_auth_job_list_append(auth_worker.results, pjob);
+    }
+
+    if (!luascript_func_call(auth_worker.fcl, "database_free")) {
+      log_error("Error closing the database connection of the "
+                "authentication worker.");
+    }
+    luascript_destroy(auth_worker.fcl);
+    auth_worker.fcl = NULL;
+  }
+
+  if (auth_worker.requests != NULL && auth_worker.pending == 0) {
+    fcdb_auth_job_list_destroy(auth_worker.requests);
+    fcdb_auth_job_list_destroy(auth_worker.results);
+    auth_worker.requests = NULL;
+    auth_worker.results = NULL;
+    fc_thread_cond_destroy(&auth_worker.cond);
+    fc_mutex_destroy(&auth_worker.mutex);
+  }
+#endif /* FREECIV_HAVE_THREAD_COND */
+}
+#endif /* HAVE_FCDB */
+
+/**********************************************************************//**
+  Initialize the scripting state. Returns the status of the freeciv
+  database lua state.
+**************************************************************************/
+bool script_fcdb_init(const char *fcdb_luafile)
+{
+#ifdef HAVE_FCDB
+  if (fcl != NULL) {
+    fc_assert_ret_val(fcl->state != NULL, FALSE);
+
+    return TRUE;
+  }
+
+  if (!fcdb_luafile) {
+    /* Use default freeciv database lua file. */
+    fcdb_luafile = FC_CONF_PATH "/" SCRIPT_FCDB_LUA_FILE;
+  }
+
+  fcl = script_fcdb_state_new(fcdb_luafile);
+  if (fcl == NULL) {
     return FALSE;
   }
 
@@ -311,6 +526,10 @@ bool script_fcdb_init(const char *fcdb_luafile)
       log_error(_("Database capabilities not compatible with server"));
       return FALSE;
     }
+
+    if (srvarg.auth_enabled) {
+      script_fcdb_auth_start(fcdb_luafile);
+    }
   }
 
 #endif /* HAVE_FCDB */
@@ -371,12 +590,110 @@ bool script_fcdb_call(const char *func_name, ...)
   return success;
 }
 
+/**********************************************************************//**
+  Whether authentication calls are run by the worker thread. If not,
+  auth code has to use script_fcdb_call() directly.
+**************************************************************************/
+bool script_fcdb_auth_async(void)
+{
+#if defined(HAVE_FCDB) && defined(FREECIV_HAVE_THREAD_COND)
+  return auth_worker.fcl != NULL;
+#else
+  return FALSE;
+#endif
+}
+
+/**********************************************************************//**
+  Queue an authentication call for the connection to the worker thread.
+  The result is fetched later with script_fcdb_auth_result().
+**************************************************************************/
+void script_fcdb_auth_queue(const struct connection *pconn,
+                            enum fcdb_auth_call call, const char *password)
+{
+#if defined(HAVE_FCDB) && defined(FREECIV_HAVE_THREAD_COND)
+  struct fcdb_auth_job *pjob;
+
+  fc_assert_ret(auth_worker.fcl != NULL);
+
+  pjob = fc_calloc(1, sizeof(*pjob));
+  pjob->result.conn_id = pconn->id;
+  pjob->result.call = call;
+  pjob->access_level = pconn->access_level;
+  pjob->granted_access_level = pconn->server.granted_access_level;
+  sz_strlcpy(pjob->username, pconn->username);
+  sz_strlcpy(pjob->ipaddr, pconn->server.ipaddr);
+  if (password != NULL) {
+    sz_strlcpy(pjob->password, password);
+  }
+
+  fc_mutex_allocate(&auth_worker.mutex);
+  fcdb_auth_job_list_append(auth_worker.requests, pjob);
+  auth_worker.pending++;
+  fc_thread_cond_signal(&auth_worker.cond);
+  fc_mutex_release(&auth_worker.mutex);
+#endif /* HAVE_FCDB && FREECIV_HAVE_THREAD_COND */
+}
+
+/**********************************************************************//**
+  Fetch the next finished authentication call. Returns FALSE if there
+  is none.
+**************************************************************************/
+bool script_fcdb_auth_result(struct fcdb_auth_result *presult)
+{
+#if defined(HAVE_FCDB) && defined(FREECIV_HAVE_THREAD_COND)
+  struct fcdb_auth_job *pjob;
+
+  if (auth_worker.requests == NULL) {
+    return FALSE;
+  }
+
+  fc_mutex_allocate(&auth_worker.mutex);
+  pjob = fcdb_auth_job_list_front(auth_worker.results);
+  if (pjob != NULL) {
+    fcdb_auth_job_list_pop_front(auth_worker.results);
+    auth_worker.pending--;
+  }
+  fc_mutex_release(&auth_worker.mutex);
+
+  if (pjob == NULL) {
+    return FALSE;
+  }
+
+  *presult = pjob->result;
+  fcdb_auth_job_destroy(pjob);
+
+  if (auth_worker.pending == 0 && auth_worker.fcl == NULL) {
+    /* Worker was stopped; this was the last result it owed. */
+    script_fcdb_auth_stop();
+  }
+
+  return TRUE;
+#else
+  return FALSE;
+#endif /* HAVE_FCDB && FREECIV_HAVE_THREAD_COND */
+}
+
+/**********************************************************************//**
+  Whether some queued authentication call has not been fetched yet.
+**************************************************************************/
+bool script_fcdb_auth_pending(void)
+{
+#if defined(HAVE_FCDB) && defined(FREECIV_HAVE_THREAD_COND)
+  /* Only the main thread changes the counter. */
+  return auth_worker.pending > 0;
+#else
+  return FALSE;
+#endif
+}
+
 /**********************************************************************//**
   Free the scripting data.
 **************************************************************************/
 void script_fcdb_free(void)
 {
 #ifdef HAVE_FCDB
+  script_fcdb_auth_stop();
+
   if (!script_fcdb_call("database_free", 0)) {
     log_error("Error closing the database connection. Continuing anyway...");
   }
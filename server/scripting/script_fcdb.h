@@ -17,6 +17,9 @@
 /* utility */
 #include "support.h"            /* fc__attribute() */
 
+/* common */
+#include "connection.h"
+
 /* server */
 #include "fcdb.h"
 
@@ -28,4 +31,26 @@ void script_fcdb_free(void);
 
 bool script_fcdb_do_string(struct connection *caller, const char *str);
 
+/* Authentication calls which may be run by the fcdb worker thread. */
+enum fcdb_auth_call {
+  FCDB_USER_EXISTS,
+  FCDB_USER_VERIFY,
+  FCDB_USER_SAVE
+};
+
+struct fcdb_auth_result {
+  int conn_id;
+  enum fcdb_auth_call call;
+  bool success;               /* The lua function could be called. */
+  bool value;                 /* Return value of user_exists/user_verify. */
+  bool access_set;            /* The script changed the access level. */
+  enum cmdlevel access_level;
+};
+
+bool script_fcdb_auth_async(void);
+void script_fcdb_auth_queue(const struct connection *pconn,
+                            enum fcdb_auth_call call, const char *password);
+bool script_fcdb_auth_result(struct fcdb_auth_result *presult);
+bool script_fcdb_auth_pending(void);
+
 #endif /* FC__SCRIPT_FCDB_H */
@@ -28,6 +28,7 @@
 
 /* utility */
 #include "astring.h"
+#include "fcintl.h"
 #include "log.h"
 #include "mem.h"
 #include "registry.h"
@@ -404,16 +405,59 @@ void script_server_state_save(struct section_file *file)
 
 /***********************************************************************//**
   Invoke all the callback functions attached to a given signal.
+  Use script_server_signal_emit() instead of calling this directly.
 ***************************************************************************/
-void script_server_signal_emit(const char *signal_name, ...)
+void script_server_signal_emit_ref(struct signal_ref *ref,
+                                   const char *signal_name, ...)
 {
   va_list args;
 
   va_start(args, signal_name);
-  luascript_signal_emit_valist(fcl_main, signal_name, args);
+  luascript_signal_emit_ref_valist(fcl_main, ref, signal_name, args);
   va_end(args);
 }
 
+/***********************************************************************//**
+  Turn profiling of the signal callbacks on or off.
+***************************************************************************/
+void script_server_profile_set(bool enable)
+{
+  luascript_signal_profile_set(fcl_main, enable);
+}
+
+/***********************************************************************//**
+  Send the profile of the signal callbacks to the caller.
+***************************************************************************/
+void script_server_profile_report(struct connection *caller)
+{
+  struct signal_profile *profile;
+  int count, i;
+
+  profile = luascript_signal_profile_get(fcl_main, &count);
+
+  if (count == 0) {
+    cmd_reply(CMD_LUA, caller, C_COMMENT,
+              fcl_main->profiling
+              ? _("No signal callbacks called since profiling started.")
+              /* TRANS: Do not translate 'lua profile on' */
+              : _("No profile. Start profiling with 'lua profile on'."));
+    free(profile);
+    return;
+  }
+
+  cmd_reply(CMD_LUA, caller, C_COMMENT, "%-28s %-28s %8s %10s %10s",
+            _("Signal"), _("Callback"), _("Calls"), _("Total ms"),
+            _("ms/call"));
+  for (i = 0; i < count; i++) {
+    cmd_reply(CMD_LUA, caller, C_COMMENT, "%-28s %-28s %8d %10.1f %10.3f",
+              profile[i].signal_name, profile[i].callback_name,
+              profile[i].calls, profile[i].seconds * 1000.0,
+              profile[i].seconds * 1000.0 / profile[i].calls);
+  }
+
+  free(profile);
+}
+
 /***********************************************************************//**
   Declare any new signal types you need here.
 ***************************************************************************/
@@ -18,6 +18,7 @@
 #include "support.h"
 
 /* common/scriptcore */
+#include "luascript_signal.h"
 #include "luascript_types.h"
 
 struct section_file;
@@ -42,8 +43,21 @@ bool script_server_unsafe_do_file(struct connection *caller,
 void script_server_state_load(struct section_file *file);
 void script_server_state_save(struct section_file *file);
 
-/* Signals. */
-void script_server_signal_emit(const char *signal_name, ...);
+/* Signals. The signal is looked up by name only on the first emission
+ * from each place. */
+#define script_server_signal_emit(signal_name, ...)                         \
+  do {                                                                      \
+    static struct signal_ref _sig_ref_ = SIGNAL_REF_INIT;                   \
+                                                                            \
+    script_server_signal_emit_ref(&_sig_ref_, signal_name, ## __VA_ARGS__); \
+  } while (FALSE)
+
+void script_server_signal_emit_ref(struct signal_ref *ref,
+                                   const char *signal_name, ...);
+
+/* Profiling of signal callbacks. */
+void script_server_profile_set(bool enable);
+void script_server_profile_report(struct connection *caller);
 
 /* Functions */
 bool script_server_call(const char *func_name, ...);
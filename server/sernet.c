@@ -81,6 +81,7 @@
 /* server */
 #include "aiiface.h"
 #include "auth.h"
+#include "citytools.h"
 #include "connecthand.h"
 #include "console.h"
 #include "meta.h"
@@ -117,6 +118,10 @@ static int socklan;
 
 #define PROCESSING_TIME_STATISTICS 0
 
+/* How often to look for fcdb authentication results while some are
+ * still being worked on. */
+#define AUTH_POLLS_PER_SEC 20
+
 static int server_accept_connection(int sockfd);
 static void start_processing_request(struct connection *pconn,
                                      int request_id);
@@ -489,8 +494,11 @@ static void incoming_client_packets(struct connection *pconn)
     connection_do_buffer(pconn);
     start_processing_request(pconn, pconn->server.last_request_id_seen);
 
+    /* Send each city changed by the request only once, at its end */
+    city_info_freeze();
     command_ok = server_packet_input(pconn, packet.data, packet.type);
     packet_destroy(packet.data, packet.type);
+    city_info_thaw();
 
     finish_processing_request(pconn);
     connection_do_unbuffer(pconn);
@@ -524,6 +532,7 @@ enum server_events server_sniff_all_input(void)
   int i, s;
   int max_desc;
   bool excepting;
+  int auth_polls = 0;
   fd_set readfs, writefs, exceptfs;
   fc_timeval tv;
 #ifdef FREECIV_SOCKET_ZERO_NOT_STDIN
@@ -573,6 +582,7 @@ enum server_events server_sniff_all_input(void)
 
   while (TRUE) {
     int selret;
+    bool auth_poll;
 
     con_prompt_on();   /* accepting new input */
 
@@ -670,6 +680,10 @@ enum server_events server_sniff_all_input(void)
       game.server.last_ping = time(NULL);
     }
 
+    if (srvarg.auth_enabled) {
+      auth_process_results();
+    }
+
     /* if we've waited long enough after a failure, respond to the client */
     conn_list_iterate(game.all_connections, pconn) {
       if (srvarg.auth_enabled
@@ -690,6 +704,12 @@ enum server_events server_sniff_all_input(void)
     tv.tv_sec = 1;
     tv.tv_usec = 0;
 
+    auth_poll = auth_results_pending();
+    if (auth_poll) {
+      tv.tv_sec = 0;
+      tv.tv_usec = 1000000 / AUTH_POLLS_PER_SEC;
+    }
+
     FC_FD_ZERO(&readfs);
     FC_FD_ZERO(&writefs);
     FC_FD_ZERO(&exceptfs);
@@ -726,6 +746,13 @@ enum server_events server_sniff_all_input(void)
     con_prompt_off();    /* output doesn't generate a new prompt */
 
     selret = fc_select(max_desc + 1, &readfs, &writefs, &exceptfs, &tv);
+    if (selret == 0 && auth_poll && ++auth_polls < AUTH_POLLS_PER_SEC) {
+      /* Only polling for authentication results; the timeout handling
+       * below still runs about once a second. */
+      continue;
+    }
+    auth_polls = 0;
+
     if (selret == 0) {
       /* timeout */
       call_ai_refresh();
@@ -1092,6 +1119,7 @@ int server_make_connection(int new_sock, const char *client_addr,
       pconn->server.auth_tries = 0;
       pconn->server.auth_settime = 0;
       pconn->server.status = AS_NOT_ESTABLISHED;
+      pconn->server.auth_pending = FALSE;
       pconn->server.ping_timers = timer_list_new_full(timer_destroy);
       pconn->server.granted_access_level = pconn->access_level;
       pconn->server.ignore_list =
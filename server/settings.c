@@ -432,6 +432,19 @@ static const struct sset_val_name *trait_dist_name(int trait_dist)
   return nullptr;
 }
 
+/************************************************************************//**
+  Worker planner setting names accessor.
+****************************************************************************/
+static const struct sset_val_name *workerplanner_name(int planner)
+{
+  switch (planner) {
+  NAME_CASE(WP_GREEDY, "GREEDY", N_("Each worker picks its own work"));
+  NAME_CASE(WP_BATCHED, "BATCHED", N_("Work assigned to all workers at once"));
+  }
+
+  return nullptr;
+}
+
 /************************************************************************//**
   Player colors configuration setting names accessor.
 ****************************************************************************/
@@ -2425,6 +2438,21 @@ static struct setting settings[] = {
            nullptr, nullptr, nullptr, trait_dist_name,
            GAME_DEFAULT_TRAIT_DIST_MODE)
 
+  GEN_ENUM("workerplanner", game.server.worker_planner,
+           SSET_RULES_FLEXIBLE, SSET_INTERNAL, SSET_RARE,
+           ALLOW_NONE, ALLOW_BASIC,
+           N_("How auto workers get their work"),
+           N_("With \"Each worker picks its own work\" (GREEDY) every "
+              "auto worker searches the best work for itself in turn, "
+              "displacing others when it is closer. With \"Work assigned "
+              "to all workers at once\" (BATCHED) the tile improvement "
+              "values are evaluated once per worker type, workers starting "
+              "from the same place share their path-finding, and the "
+              "jobs are then matched to all the idle workers together. "
+              "Workers left without a job fall back to the greedy search."),
+           nullptr, nullptr, nullptr, workerplanner_name,
+           GAME_DEFAULT_WORKER_PLANNER)
+
   GEN_INT("razechance", game.server.razechance,
           SSET_RULES, SSET_MILITARY, SSET_RARE, ALLOW_NONE, ALLOW_BASIC,
           N_("Chance for conquered building destruction"),
@@ -89,6 +89,8 @@ int main(int argc, char *argv[])
       break;
     } else if ((option = get_option_malloc("--log", argv, &inx, argc, TRUE))) {
       srvarg.log_filename = option;
+    } else if (is_option("--Queuelog", argv[inx])) {
+      srvarg.log_queued = TRUE;
 #ifndef FREECIV_NDEBUG
     } else if (is_option("--Fatal", argv[inx])) {
       if (inx + 1 >= argc || '-' == argv[inx + 1][0]) {
@@ -104,6 +106,8 @@ int main(int argc, char *argv[])
 #endif /* FREECIV_NDEBUG */
     } else if ((option = get_option_malloc("--Ranklog", argv, &inx, argc, TRUE))) {
       srvarg.ranklog_filename = option;
+    } else if ((option = get_option_malloc("--Timing", argv, &inx, argc, TRUE))) {
+      srvarg.timing_filename = option;
     } else if (is_option("--keep", argv[inx])) {
       srvarg.metaconnection_persistent = TRUE;
       /* Implies --meta */
@@ -276,6 +280,9 @@ int main(int argc, char *argv[])
                 /* TRANS: "log" is exactly what user must type, do not translate. */
                 _("log FILE"),
                 _("Use FILE as logfile"));
+    cmdhelp_add(help, "Q", "Queuelog",
+                _("Write the logfile from a background thread, dropping "
+                  "messages if it falls behind"));
     cmdhelp_add(help, "m", "meta",
                 _("Notify metaserver and send server's info"));
     cmdhelp_add(help, "M",
@@ -321,6 +328,10 @@ int main(int argc, char *argv[])
                 /* TRANS: "Ranklog" is exactly what user must type, do not translate. */
                 _("Ranklog FILE"),
                 _("Use FILE as ranking logfile"));
+    cmdhelp_add(help, "T",
+                /* TRANS: "Timing" is exactly what user must type, do not translate. */
+                _("Timing FILE"),
+                _("Write per-turn phase timings to FILE"));
     cmdhelp_add(help, NULL,
                 /* TRANS: "ruleset" is exactly what user must type, do not translate. */
                 _("ruleset RULESET"),
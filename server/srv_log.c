@@ -19,7 +19,9 @@
 
 /* utility */
 #include "astring.h"
+#include "fcintl.h"
 #include "log.h"
+#include "mem.h"
 #include "shared.h"
 #include "support.h"
 #include "timing.h"
@@ -33,6 +35,7 @@
 #include "unit.h"
 
 /* server */
+#include "citytools.h"
 #include "notify.h"
 #include "srv_main.h"
 
@@ -43,6 +46,71 @@
 
 static struct timer *aitimer[AIT_LAST][2];
 static int recursion[AIT_LAST];
+static prof_time ai_prof_start[AIT_LAST];
+static int ai_prof_zone[AIT_LAST];
+
+#ifndef FREECIV_DEBUG
+bool timing_log_active = FALSE;
+#endif
+
+/* Column names of the timing report. */
+static const char *ai_timer_names[AIT_LAST] = {
+  [AIT_ALL] = "ai_all",
+  [AIT_MOVEMAP] = "ai_movemap",
+  [AIT_UNITS] = "ai_units",
+  [AIT_SETTLERS] = "ai_settlers",
+  [AIT_WORKERS] = "ai_workers",
+  [AIT_AIDATA] = "ai_aidata",
+  [AIT_GOVERNMENT] = "ai_government",
+  [AIT_TAXES] = "ai_taxes",
+  [AIT_CITIES] = "ai_cities",
+  [AIT_CITIZEN_ARRANGE] = "ai_citizen_arrange",
+  [AIT_BUILDINGS] = "ai_buildings",
+  [AIT_DANGER] = "ai_danger",
+  [AIT_TECH] = "ai_tech",
+  [AIT_FSTK] = "ai_fstk",
+  [AIT_DEFENDERS] = "ai_defenders",
+  [AIT_CARAVAN] = "ai_caravan",
+  [AIT_HUNTER] = "ai_hunter",
+  [AIT_AIRLIFT] = "ai_airlift",
+  [AIT_DIPLOMAT] = "ai_diplomat",
+  [AIT_AIRUNIT] = "ai_airunit",
+  [AIT_EXPLORER] = "ai_explorer",
+  [AIT_EMERGENCY] = "ai_emergency",
+  [AIT_CITY_MILITARY] = "ai_city_military",
+  [AIT_CITY_TERRAIN] = "ai_city_terrain",
+  [AIT_CITY_SETTLERS] = "ai_city_settlers",
+  [AIT_ATTACK] = "ai_attack",
+  [AIT_MILITARY] = "ai_military",
+  [AIT_RECOVER] = "ai_recover",
+  [AIT_BODYGUARD] = "ai_bodyguard",
+  [AIT_FERRY] = "ai_ferry",
+  [AIT_RAMPAGE] = "ai_rampage"
+};
+
+static const char *phase_timer_names[PHT_LAST] = {
+  [PHT_BEGIN_TURN] = "begin_turn",
+  [PHT_BEGIN_PHASE] = "begin_phase",
+  [PHT_AI_START_PHASE] = "ai_start_phase",
+  [PHT_END_PHASE] = "end_phase",
+  [PHT_END_TURN] = "end_turn",
+  [PHT_AUTOSAVE] = "autosave"
+};
+
+static struct {
+  FILE *fp;
+  struct timer *timer[PHT_LAST];
+  unsigned long allocs[PHT_LAST];
+  unsigned long alloc_start[PHT_LAST];
+  struct timer *turn_timer;
+  unsigned long turn_alloc_start;
+} phase_timing = { .fp = nullptr };
+
+static prof_time phase_prof_start[PHT_LAST];
+static int phase_prof_zone[PHT_LAST];
+
+/* File to save the profiling data to when profiling stops */
+static char *profiling_filename = nullptr;
 
 /* General AI logging functions */
 
@@ -143,10 +211,14 @@ void timing_log_real(enum ai_timer timer, enum ai_timer_activity activity)
   if (activity == TIMER_START && recursion[timer] == 0) {
     timer_start(aitimer[timer][0]);
     timer_start(aitimer[timer][1]);
+    ai_prof_start[timer] = (prof_active ? prof_begin() : 0);
     recursion[timer]++;
   } else if (activity == TIMER_STOP && recursion[timer] == 1) {
     timer_stop(aitimer[timer][0]);
     timer_stop(aitimer[timer][1]);
+    if (ai_prof_start[timer] != 0) {
+      prof_zone_record(ai_prof_zone[timer], ai_prof_start[timer]);
+    }
     recursion[timer]--;
   }
 }
@@ -212,6 +284,127 @@ void timing_results_real(void)
   AILOG_OUT("Tech", AIT_TECH);
 }
 
+/**********************************************************************//**
+  Start writing the per-turn timing report to the given file. The file
+  gets a header line with the column names and then one line per turn
+  with comma separated values, to be compared between builds:
+
+    turn, players, cities, units, total wall time and allocations,
+    wall time and allocations of each phase_timer, CPU time of
+    each ai_timer, city info sends saved by coalescing
+
+  Phase times are wall clock seconds and allocations count calls of
+  fc_malloc() and friends. begin_phase and end_phase are summed over
+  all phases of the turn.
+**************************************************************************/
+bool phase_timing_open(const char *filename)
+{
+  int i;
+
+  fc_assert_ret_val(phase_timing.fp == nullptr, FALSE);
+
+  phase_timing.fp = fc_fopen(filename, "w");
+  if (phase_timing.fp == nullptr) {
+    log_error(_("Can't open timing log file '%s'."), filename);
+    return FALSE;
+  }
+
+  fprintf(phase_timing.fp, "turn,players,cities,units,turn_sec,turn_allocs");
+  for (i = 0; i < PHT_LAST; i++) {
+    fprintf(phase_timing.fp, ",%s_sec,%s_allocs",
+            phase_timer_names[i], phase_timer_names[i]);
+    phase_timing.timer[i] = timer_new(TIMER_USER, TIMER_ACTIVE,
+                                      phase_timer_names[i]);
+    phase_timing.allocs[i] = 0;
+  }
+  for (i = 0; i < AIT_LAST; i++) {
+    fprintf(phase_timing.fp, ",%s_sec", ai_timer_names[i]);
+  }
+  fprintf(phase_timing.fp, ",city_info_coalesced\n");
+
+  phase_timing.turn_timer = timer_new(TIMER_USER, TIMER_ACTIVE, "turn");
+
+#ifndef FREECIV_DEBUG
+  timing_log_active = TRUE;
+#endif
+
+  return TRUE;
+}
+
+/**********************************************************************//**
+  Measure one of the server turn phases for the timing report.
+**************************************************************************/
+void phase_timing_log(enum phase_timer timer,
+                      enum ai_timer_activity activity)
+{
+  if (activity == TIMER_START) {
+    phase_prof_start[timer] = (prof_active ? prof_begin() : 0);
+  } else if (phase_prof_start[timer] != 0) {
+    prof_zone_record(phase_prof_zone[timer], phase_prof_start[timer]);
+    phase_prof_start[timer] = 0;
+  }
+
+  if (phase_timing.fp == nullptr) {
+    return;
+  }
+
+  if (activity == TIMER_START) {
+    if (timer == PHT_BEGIN_TURN) {
+      /* The turn is measured from here to phase_timing_turn_done() */
+      timer_clear(phase_timing.turn_timer);
+      timer_start(phase_timing.turn_timer);
+      phase_timing.turn_alloc_start = fc_mem_alloc_count();
+    }
+    phase_timing.alloc_start[timer] = fc_mem_alloc_count();
+    timer_start(phase_timing.timer[timer]);
+  } else {
+    timer_stop(phase_timing.timer[timer]);
+    phase_timing.allocs[timer]
+      += fc_mem_alloc_count() - phase_timing.alloc_start[timer];
+  }
+}
+
+/**********************************************************************//**
+  Write the timing report line of the turn that just ended, and reset
+  the phase timers for the next one.
+**************************************************************************/
+void phase_timing_turn_done(int turn)
+{
+  unsigned long allocs;
+  int cities = 0, units = 0;
+  int i;
+
+  prof_turn_done(turn);
+
+  if (phase_timing.fp == nullptr) {
+    return;
+  }
+
+  players_iterate(pplayer) {
+    cities += city_list_size(pplayer->cities);
+    units += unit_list_size(pplayer->units);
+  } players_iterate_end;
+
+  timer_stop(phase_timing.turn_timer);
+  allocs = fc_mem_alloc_count() - phase_timing.turn_alloc_start;
+
+  fprintf(phase_timing.fp, "%d,%d,%d,%d,%f,%lu", turn,
+          player_count(), cities, units,
+          timer_read_seconds(phase_timing.turn_timer), allocs);
+  for (i = 0; i < PHT_LAST; i++) {
+    fprintf(phase_timing.fp, ",%f,%lu",
+            timer_read_seconds(phase_timing.timer[i]),
+            phase_timing.allocs[i]);
+    timer_clear(phase_timing.timer[i]);
+    phase_timing.allocs[i] = 0;
+  }
+  for (i = 0; i < AIT_LAST; i++) {
+    fprintf(phase_timing.fp, ",%f", timer_read_seconds(aitimer[i][0]));
+  }
+  fprintf(phase_timing.fp, ",%d\n", city_info_coalesced_count());
+  fflush(phase_timing.fp);
+}
+
 /**********************************************************************//**
   Initialize AI timing system
 **************************************************************************/
@@ -227,6 +420,11 @@ void timing_log_init(void)
     fc_snprintf(buf, sizeof(buf), "AI type %d game", i);
     aitimer[i][1] = timer_new(TIMER_CPU, TIMER_ACTIVE, buf);
     recursion[i] = 0;
+    ai_prof_zone[i] = prof_zone_id(ai_timer_names[i]);
+  }
+
+  for (i = 0; i < PHT_LAST; i++) {
+    phase_prof_zone[i] = prof_zone_id(phase_timer_names[i]);
   }
 }
 
@@ -241,4 +439,73 @@ void timing_log_free(void)
     timer_destroy(aitimer[i][0]);
     timer_destroy(aitimer[i][1]);
   }
+
+  if (prof_active) {
+    profiling_stop();
+  }
+  prof_free();
+
+  if (phase_timing.fp != nullptr) {
+    fclose(phase_timing.fp);
+    phase_timing.fp = nullptr;
+    for (i = 0; i < PHT_LAST; i++) {
+      timer_destroy(phase_timing.timer[i]);
+    }
+    timer_destroy(phase_timing.turn_timer);
+  }
+}
+
+/**********************************************************************//**
+  Start profiling the server: the turn phases, the AI timers, path
+  finding, CM and savegames. If 'filename' is given, the data is saved
+  to it when profiling stops, at the latest at server exit.
+**************************************************************************/
+bool profiling_start(const char *filename)
+{
+  if (!prof_start()) {
+    return FALSE;
+  }
+
+  free(profiling_filename);
+  profiling_filename = (filename != nullptr && filename[0] != '\0'
+                        ? fc_strdup(filename) : nullptr);
+
+  return TRUE;
+}
+
+/**********************************************************************//**
+  Stop profiling the server, saving the data if a file was given when
+  starting.
+**************************************************************************/
+bool profiling_stop(void)
+{
+  bool ret = TRUE;
+
+  if (!prof_active) {
+    return FALSE;
+  }
+
+  prof_stop();
+  if (profiling_filename != nullptr) {
+    ret = profiling_save(profiling_filename);
+    FC_FREE(profiling_filename);
+  }
+
+  return ret;
+}
+
+/**********************************************************************//**
+  Save the profiling data. Files with the ".json" extension get the
+  trace in Chrome trace-event format, others the per-turn statistics
+  as csv.
+**************************************************************************/
+bool profiling_save(const char *filename)
+{
+  size_t len = strlen(filename);
+
+  if (len >= 5 && !fc_strcasecmp(filename + len - 5, ".json")) {
+    return prof_save_trace(filename);
+  }
+
+  return prof_save_csv(filename);
 }
@@ -17,6 +17,7 @@
 #include "bitvector.h"
 #include "log.h"
 #include "support.h"
+#include "timing.h"
 
 /* common */
 #include "fc_types.h"
@@ -76,6 +77,17 @@ enum ai_timer_activity  {
   TIMER_START, TIMER_STOP
 };
 
+/* Server turn phases measured for the --Timing report. */
+enum phase_timer {
+  PHT_BEGIN_TURN,
+  PHT_BEGIN_PHASE,
+  PHT_AI_START_PHASE,           /* Part of PHT_BEGIN_PHASE */
+  PHT_END_PHASE,
+  PHT_END_TURN,
+  PHT_AUTOSAVE,
+  PHT_LAST
+};
+
 void real_city_log(const char *file, const char *function, int line,
                    enum log_level level, bool notify,
                    const struct city *pcity, const char *msg, ...)
@@ -118,11 +130,28 @@ void timing_log_free(void);
 void timing_log_real(enum ai_timer timer, enum ai_timer_activity activity);
 void timing_results_real(void);
 
+bool phase_timing_open(const char *filename);
+void phase_timing_log(enum phase_timer timer,
+                      enum ai_timer_activity activity);
+void phase_timing_turn_done(int turn);
+
+bool profiling_start(const char *filename);
+bool profiling_stop(void);
+bool profiling_save(const char *filename);
+
 #ifdef FREECIV_DEBUG
 #define TIMING_LOG(timer, activity) timing_log_real(timer, activity)
 #define TIMING_RESULTS() timing_results_real()
 #else  /* FREECIV_DEBUG */
-#define TIMING_LOG(timer, activity)
+/* AI timers are only fed when a timing report is being written, or
+ * profiling is active. */
+extern bool timing_log_active;
+#define TIMING_LOG(timer, activity)                                         \
+  do {                                                                      \
+    if (timing_log_active || prof_active) {                                 \
+      timing_log_real(timer, activity);                                     \
+    }                                                                       \
+  } while (FALSE)
 #define TIMING_RESULTS()
 #endif /* FREECIV_DEBUG */
 
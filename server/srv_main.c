@@ -277,8 +277,10 @@ void srv_init(void)
   srvarg.loglevel = LOG_NORMAL;
 
   srvarg.log_filename = nullptr;
+  srvarg.log_queued = FALSE;
   srvarg.fatal_assertions = -1;
   srvarg.ranklog_filename = nullptr;
+  srvarg.timing_filename = nullptr;
   srvarg.load_filename[0] = '\0';
   srvarg.script_filename = nullptr;
   srvarg.saves_pathname = "";
@@ -1200,9 +1202,7 @@ static void begin_turn(bool is_new_turn)
     /* We build scores at the beginning of every turn. We have to
      * build them at the beginning so that the AI can use the data,
      * and we are sure to have it when we need it. */
-    players_iterate(pplayer) {
-      calc_civ_score(pplayer);
-    } players_iterate_end;
+    calc_civ_scores();
     log_civ_score_now();
 
     /* Retire useless barbarian units */
@@ -1397,7 +1397,9 @@ static void begin_phase(bool is_new_phase)
     } phase_players_iterate_end;
 
     log_debug("Aistartturn");
+    phase_timing_log(PHT_AI_START_PHASE, TIMER_START);
     ai_start_phase();
+    phase_timing_log(PHT_AI_START_PHASE, TIMER_STOP);
 
     flush_packets();
     phase_players_iterate(pplayer) {
@@ -2971,12 +2973,19 @@ static void srv_running(void)
 
   fc_assert(S_S_RUNNING == server_state());
   while (S_S_RUNNING == server_state()) {
+    int turn;
+
     /* The beginning of a turn.
      *
      * We have to initialize data as well as do some actions.  However when
      * loading a game we don't want to do these actions (like AI unit
      * movement and AI diplomacy). */
+    phase_timing_log(PHT_BEGIN_TURN, TIMER_START);
+    city_info_freeze();
     begin_turn(is_new_turn);
+    city_info_thaw();
+    phase_timing_log(PHT_BEGIN_TURN, TIMER_STOP);
+    turn = game.info.turn;
 
     if (game.server.num_phases != 1) {
       /* We allow everyone to begin adjusting cities and such
@@ -2989,7 +2998,11 @@ static void srv_running(void)
     for (; game.info.phase < game.server.num_phases; game.info.phase++) {
       log_debug("Starting phase %d/%d.", game.info.phase,
                 game.server.num_phases);
+      phase_timing_log(PHT_BEGIN_PHASE, TIMER_START);
+      city_info_freeze();
       begin_phase(is_new_turn);
+      city_info_thaw();
+      phase_timing_log(PHT_BEGIN_PHASE, TIMER_STOP);
       if (need_send_pending_events) {
         /* When loading a savegame, we need to send loaded events, after
          * the clients switched to the game page (after the first
@@ -3024,7 +3037,9 @@ static void srv_running(void)
         if (save_counter >= game.server.save_nturns
             && game.server.save_nturns > 0) {
           save_counter = 0;
+          phase_timing_log(PHT_AUTOSAVE, TIMER_START);
           save_game_auto("Autosave", AS_TURN);
+          phase_timing_log(PHT_AUTOSAVE, TIMER_STOP);
         }
         save_counter++;
 
@@ -3064,7 +3079,11 @@ static void srv_running(void)
        */
       lsend_packet_freeze_client(game.est_connections);
 
+      phase_timing_log(PHT_END_PHASE, TIMER_START);
+      city_info_freeze();
       end_phase();
+      city_info_thaw();
+      phase_timing_log(PHT_END_PHASE, TIMER_STOP);
 
       conn_list_do_unbuffer(game.est_connections);
 
@@ -3081,7 +3100,12 @@ static void srv_running(void)
      * where phase is too high for is_new_turn to get set. */
     is_new_turn = TRUE;
 
+    phase_timing_log(PHT_END_TURN, TIMER_START);
+    city_info_freeze();
     end_turn();
+    city_info_thaw();
+    phase_timing_log(PHT_END_TURN, TIMER_STOP);
+    phase_timing_turn_done(turn);
     log_debug("Sendinfotometaserver");
     (void) send_server_info_to_metaserver(META_REFRESH);
 
@@ -3138,6 +3162,9 @@ static void srv_prepare(void)
   init_connections();
   con_log_init(srvarg.log_filename, srvarg.loglevel,
                srvarg.fatal_assertions);
+  if (srvarg.log_queued) {
+    log_set_async(TRUE);
+  }
   /* Logging available after this point */
 
   server_open_socket();
@@ -3164,6 +3191,11 @@ static void srv_prepare(void)
               mapimg_server_tile_unit, mapimg_server_plrcolor_count,
               mapimg_server_plrcolor_get);
 
+  if (srvarg.timing_filename != nullptr
+      && !phase_timing_open(srvarg.timing_filename)) {
+    exit(EXIT_FAILURE);
+  }
+
 #ifdef HAVE_FCDB
   if (srvarg.fcdb_enabled) {
     bool success;
@@ -3220,9 +3252,7 @@ static void srv_prepare(void)
 static void srv_scores(void)
 {
   /* Recalculate the scores in case of a spaceship victory */
-  players_iterate(pplayer) {
-    calc_civ_score(pplayer);
-  } players_iterate_end;
+  calc_civ_scores();
 
   log_civ_score_now();
 
@@ -3608,6 +3638,7 @@ void server_game_free(void)
   log_civ_score_free();
   playercolor_free();
   citymap_free();
+  map_borders_free();
   game_free();
 }
 
@@ -3839,7 +3870,7 @@ static struct terrain
 {
   if (knowledge && pplayer) {
     struct player_tile *plrtile = map_get_player_tile(ptile, pplayer);
-    return plrtile->terrain;
+    return player_tile_terrain(plrtile);
   }
 
   return tile_terrain(ptile);
@@ -3855,7 +3886,7 @@ static struct player *mapimg_server_tile_owner(const struct tile *ptile,
   if (knowledge && pplayer
       && tile_get_known(ptile, pplayer) != TILE_KNOWN_SEEN) {
     struct player_tile *plrtile = map_get_player_tile(ptile, pplayer);
-    return plrtile->owner;
+    return player_tile_owner(plrtile);
   }
 
   return tile_owner(ptile);
@@ -40,7 +40,9 @@ struct server_arguments {
   enum log_level loglevel;
   /* Filenames */
   char *log_filename;
+  bool log_queued;              /* Write logfile from a thread of its own */
   char *ranklog_filename;
+  char *timing_filename;
   char load_filename[512]; /* FIXME: May not be long enough? use MAX_PATH? */
   char *script_filename;
   char *saves_pathname;
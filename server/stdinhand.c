@@ -174,6 +174,9 @@ static bool playernation_command(struct connection *caller,
                                  char *str, bool check);
 static bool mapimg_command(struct connection *caller, char *arg, bool check);
 static const char *mapimg_accessor(int i);
+static bool profile_command(struct connection *caller, char *arg,
+                            bool check);
+static const char *profile_accessor(int i);
 
 static void show_delegations(struct connection *caller);
 
@@ -4705,6 +4708,8 @@ static bool handle_stdin_input_real(struct connection *caller, char *str,
     return fcdb_command(caller, arg, check);
   case CMD_MAPIMG:
     return mapimg_command(caller, arg, check);
+  case CMD_PROFILE:
+    return profile_command(caller, arg, check);
   case CMD_LOCK:
     return lock_command(caller, arg, check);
   case CMD_UNLOCK:
@@ -4978,6 +4983,8 @@ static bool default_command(struct connection *caller, char *arg, bool check)
 #define SPECENUM_VALUE2NAME "unsafe-cmd"
 #define SPECENUM_VALUE3     LUA_UNSAFE_FILE
 #define SPECENUM_VALUE3NAME "unsafe-file"
+#define SPECENUM_VALUE4     LUA_PROFILE
+#define SPECENUM_VALUE4NAME "profile"
 #include "specenum_gen.h"
 
 /**********************************************************************//**
@@ -5047,6 +5054,15 @@ static bool lua_command(struct connection *caller, char *arg, bool check,
   case LUA_CMD:
     /* Nothing to check. */
     break;
+  case LUA_PROFILE:
+    if (luaarg[0] != '\0'
+        && fc_strcasecmp(luaarg, "on") && fc_strcasecmp(luaarg, "off")) {
+      cmd_reply(CMD_LUA, caller, C_SYNTAX,
+                _("Usage: lua profile [on|off]"));
+      ret = FALSE;
+      goto cleanup;
+    }
+    break;
   case LUA_UNSAFE_CMD:
     if (read_recursion > 0) {
       cmd_reply(CMD_LUA, caller, C_FAIL,
@@ -5121,6 +5137,20 @@ static bool lua_command(struct connection *caller, char *arg, bool check,
   case LUA_CMD:
     ret = script_server_do_string(caller, luaarg);
     break;
+  case LUA_PROFILE:
+    if (luaarg[0] == '\0') {
+      script_server_profile_report(caller);
+    } else if (!fc_strcasecmp(luaarg, "on")) {
+      script_server_profile_set(TRUE);
+      cmd_reply(CMD_LUA, caller, C_OK,
+                _("Profiling of signal callbacks started."));
+    } else {
+      script_server_profile_set(FALSE);
+      cmd_reply(CMD_LUA, caller, C_OK,
+                _("Profiling of signal callbacks stopped."));
+    }
+    ret = TRUE;
+    break;
   case LUA_UNSAFE_CMD:
     ret = script_server_unsafe_do_string(caller, luaarg);
     break;
@@ -6099,6 +6129,150 @@ static bool fcdb_command(struct connection *caller, char *arg, bool check)
   return ret;
 }
 
+/* Define the possible arguments to the profile command */
+#define SPECENUM_NAME profile_args
+#define SPECENUM_VALUE0     PROFILE_START
+#define SPECENUM_VALUE0NAME "start"
+#define SPECENUM_VALUE1     PROFILE_STOP
+#define SPECENUM_VALUE1NAME "stop"
+#define SPECENUM_VALUE2     PROFILE_SAVE
+#define SPECENUM_VALUE2NAME "save"
+#define SPECENUM_VALUE3     PROFILE_STATUS
+#define SPECENUM_VALUE3NAME "status"
+#define SPECENUM_COUNT      PROFILE_COUNT
+#include "specenum_gen.h"
+
+/**********************************************************************//**
+  Returns possible parameters for the profile command.
+**************************************************************************/
+static const char *profile_accessor(int i)
+{
+  i = CLIP(0, i, profile_args_max());
+
+  return profile_args_name((enum profile_args) i);
+}
+
+/**********************************************************************//**
+  Handle profile command
+**************************************************************************/
+static bool profile_command(struct connection *caller, char *arg,
+                            bool check)
+{
+  enum m_pre_result result;
+  int ind, ntokens;
+  char *token[2];
+  bool ret = TRUE;
+
+  ntokens = get_tokens(arg, token, 2, TOKEN_DELIMITERS);
+
+  if (ntokens > 0) {
+    /* Match the argument */
+    result = match_prefix(profile_accessor, PROFILE_COUNT, 0,
+                          fc_strncasecmp, nullptr, token[0], &ind);
+
+    switch (result) {
+    case M_PRE_EXACT:
+    case M_PRE_ONLY:
+      /* We have a match */
+      break;
+    case M_PRE_AMBIGUOUS:
+      cmd_reply(CMD_PROFILE, caller, C_FAIL,
+                _("Ambiguous 'profile' command."));
+      ret = FALSE;
+      goto cleanup;
+    case M_PRE_EMPTY:
+      ind = PROFILE_STATUS;
+      break;
+    case M_PRE_LONG:
+    case M_PRE_FAIL:
+    case M_PRE_LAST:
+      {
+        char buf[256] = "";
+        enum profile_args valid_args;
+
+        for (valid_args = profile_args_begin();
+             valid_args != profile_args_end();
+             valid_args = profile_args_next(valid_args)) {
+          cat_snprintf(buf, sizeof(buf), "'%s'",
+                       profile_args_name(valid_args));
+          if (valid_args != profile_args_max()) {
+            cat_snprintf(buf, sizeof(buf), ", ");
+          }
+        }
+
+        cmd_reply(CMD_PROFILE, caller, C_FAIL,
+                  _("The valid arguments are: %s."), buf);
+        ret = FALSE;
+        goto cleanup;
+      }
+    }
+  } else {
+    ind = PROFILE_STATUS;
+  }
+
+  if (ind == PROFILE_SAVE && ntokens < 2) {
+    cmd_reply(CMD_PROFILE, caller, C_FAIL,
+              _("Missing argument for 'profile save'."));
+    ret = FALSE;
+    goto cleanup;
+  }
+
+  if (check) {
+    goto cleanup;
+  }
+
+  switch (ind) {
+  case PROFILE_START:
+    if (!profiling_start(ntokens > 1 ? token[1] : nullptr)) {
+      cmd_reply(CMD_PROFILE, caller, C_FAIL,
+                _("Profiling is already active."));
+      ret = FALSE;
+    } else {
+      cmd_reply(CMD_PROFILE, caller, C_OK, _("Profiling started."));
+    }
+    break;
+
+  case PROFILE_STOP:
+    if (!prof_active) {
+      cmd_reply(CMD_PROFILE, caller, C_FAIL, _("Profiling is not active."));
+      ret = FALSE;
+    } else if (!profiling_stop()) {
+      cmd_reply(CMD_PROFILE, caller, C_FAIL,
+                _("Profiling stopped, but saving the data failed."));
+      ret = FALSE;
+    } else {
+      cmd_reply(CMD_PROFILE, caller, C_OK, _("Profiling stopped."));
+    }
+    break;
+
+  case PROFILE_SAVE:
+    if (!profiling_save(token[1])) {
+      cmd_reply(CMD_PROFILE, caller, C_FAIL,
+                _("Can't save the profiling data to '%s'."), token[1]);
+      ret = FALSE;
+    } else {
+      cmd_reply(CMD_PROFILE, caller, C_OK,
+                _("Profiling data saved to '%s'."), token[1]);
+    }
+    break;
+
+  case PROFILE_STATUS:
+    cmd_reply(CMD_PROFILE, caller, C_COMMENT,
+              /* TRANS: Profiling active/stopped: <n> turns, <n> events */
+              PL_("Profiling %s: %d turn, %lu trace events.",
+                  "Profiling %s: %d turns, %lu trace events.",
+                  prof_turn_count()),
+              prof_active ? _("active") : _("stopped"),
+              prof_turn_count(), (unsigned long) prof_event_count());
+    break;
+  }
+
+ cleanup:
+  free_tokens(token, ntokens);
+
+  return ret;
+}
+
 /**********************************************************************//**
   Send start command related message
 **************************************************************************/
@@ -7417,6 +7591,14 @@ static char *mapimg_generator(const char *text, int state)
                            mapimg_accessor);
 }
 
+/**********************************************************************//**
+  The valid arguments for the first argument to "profile".
+**************************************************************************/
+static char *profile_generator(const char *text, int state)
+{
+  return generic_generator(text, state, PROFILE_COUNT, profile_accessor);
+}
+
 /**********************************************************************//**
   The valid arguments for the argument to "fcdb".
 **************************************************************************/
@@ -7799,6 +7981,16 @@ static bool is_mapimg(int start)
                                    FALSE);
 }
 
+/**********************************************************************//**
+  Return whether we are completing first argument for profile command
+**************************************************************************/
+static bool is_profile(int start)
+{
+  return contains_str_before_start(start,
+                                   command_name_by_number(CMD_PROFILE),
+                                   FALSE);
+}
+
 /**********************************************************************//**
   Return whether we are completing argument for fcdb command
 **************************************************************************/
@@ -7879,6 +8071,8 @@ char **freeciv_completion(const char *text, int start, int end)
     matches = rl_completion_matches(text, delegate_generator);
   } else if (is_mapimg(start)) {
     matches = rl_completion_matches(text, mapimg_generator);
+  } else if (is_profile(start)) {
+    matches = rl_completion_matches(text, profile_generator);
   } else if (is_fcdb(start)) {
     matches = rl_completion_matches(text, fcdb_generator);
   } else if (is_lua(start)) {
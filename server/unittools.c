@@ -95,6 +95,7 @@ struct unit_move_data {
   bv_player can_see_unit;
   bv_player can_see_move;
   struct vision *old_vision;
+  v_radius_t radius_sq; /* Sight at the destination. */
 };
 
 #define SPECLIST_TAG unit_move_data
@@ -3155,24 +3156,23 @@ bool do_paradrop(struct unit *punit, struct tile *ptile,
   if (!map_is_known_and_seen(ptile, pplayer, V_MAIN)) {
     /* Only take in account values from player map. */
     const struct player_tile *plrtile = map_get_player_tile(ptile, pplayer);
+    struct player *powner = player_tile_owner(plrtile);
 
     if (plrtile->site == nullptr) {
-      bv_extras fbv;
+      struct terrain *pterrain = player_tile_terrain(plrtile);
 
-      dbv_to_bv(fbv.vec, &(plrtile->extras));
-
-      if (!is_native_to_class(unit_class_get(punit), plrtile->terrain,
-                              &fbv)) {
+      if (!is_native_to_class(unit_class_get(punit), pterrain,
+                              &(plrtile->extras))) {
         notify_player(pplayer, ptile, E_BAD_COMMAND, ftc_server,
                       _("This unit cannot paradrop into %s."),
-                      terrain_name_translation(plrtile->terrain));
+                      terrain_name_translation(pterrain));
         return FALSE;
       }
     }
 
     if (plrtile->site != nullptr
-        && plrtile->owner != nullptr
-        && !pplayers_allied(pplayer, plrtile->owner)
+        && powner != nullptr
+        && !pplayers_allied(pplayer, powner)
         && !action_has_result(paction, ACTRES_PARADROP_CONQUER)) {
       notify_player(pplayer, ptile, E_BAD_COMMAND, ftc_server,
                     /* TRANS: Paratroopers ... Paradrop Unit */
@@ -3183,11 +3183,11 @@ bool do_paradrop(struct unit *punit, struct tile *ptile,
     }
 
     if (plrtile->site != nullptr
-        && plrtile->owner != nullptr
-        && (pplayers_non_attack(pplayer, plrtile->owner)
-            || (player_diplstate_get(pplayer, plrtile->owner)->type
+        && powner != nullptr
+        && (pplayers_non_attack(pplayer, powner)
+            || (player_diplstate_get(pplayer, powner)->type
                 == DS_ALLIANCE)
-            || (player_diplstate_get(pplayer, plrtile->owner)->type
+            || (player_diplstate_get(pplayer, powner)->type
                 == DS_TEAM))
         && action_has_result(paction, ACTRES_PARADROP_CONQUER)) {
       notify_player(pplayer, ptile, E_BAD_COMMAND, ftc_server,
@@ -3934,13 +3934,13 @@ static void unit_move_by_data(struct unit_move_data *pdata,
                               const struct tile *psrctile,
                               struct tile *pdesttile)
 {
-  struct vision *new_vision;
   struct unit *punit = pdata->punit;
   int mod = unit_vision_range_modifiers(punit, pdesttile);
-  const v_radius_t radius_sq
-    = V_RADIUS(get_unit_vision_base(punit, V_MAIN, mod),
-               get_unit_vision_base(punit, V_INVIS, mod),
-               get_unit_vision_base(punit, V_SUBSURFACE, mod));
+
+  pdata->radius_sq[V_MAIN] = get_unit_vision_base(punit, V_MAIN, mod);
+  pdata->radius_sq[V_INVIS] = get_unit_vision_base(punit, V_INVIS, mod);
+  pdata->radius_sq[V_SUBSURFACE]
+    = get_unit_vision_base(punit, V_SUBSURFACE, mod);
 
   /* Remove unit from the source tile. */
   fc_assert(unit_tile(punit) == psrctile);
@@ -3965,17 +3965,148 @@ static void unit_move_by_data(struct unit_move_data *pdata,
   unit_did_action(punit);
   unit_forget_last_activity(punit);
 
-  /* We first unfog the destination, then send the move,
-   * and then fog the old territory. This means that the player
-   * gets a chance to see the newly explored territory while the
-   * client moves the unit, and both areas are visible during the
-   * move */
+  /* The sight of the new vision is given to the whole stack at once by
+   * unit_move_data_list_gain_sight(). */
+  punit->server.vision = vision_new(pdata->powner, pdesttile);
+}
+
+/**********************************************************************//**
+  Return the tile the old vision of the moving unit can be paired with
+  its new vision from, or nullptr if the new vision must be filled and
+  the old one cleared as a whole.
+**************************************************************************/
+static const struct tile *
+unit_move_data_sight_from(const struct unit_move_data *pdata)
+{
+  if (pdata->old_vision == nullptr
+      || pdata->old_vision->player != pdata->powner
+      || !pdata->old_vision->can_reveal_tiles) {
+    return nullptr;
+  }
+
+  return pdata->old_vision->tile;
+}
+
+/**********************************************************************//**
+  Return whether the vision of the two moving units changes the same way,
+  so that their seen counts can be updated together.
+**************************************************************************/
+static bool unit_move_data_same_sight(const struct unit_move_data *pdata1,
+                                      const struct unit_move_data *pdata2)
+{
+  const struct vision *old1 = pdata1->old_vision;
+  const struct vision *old2 = pdata2->old_vision;
+
+  if (pdata1->powner != pdata2->powner
+      || memcmp(pdata1->radius_sq, pdata2->radius_sq,
+                sizeof(v_radius_t)) != 0) {
+    return FALSE;
+  }
+
+  if (old1 == nullptr || old2 == nullptr) {
+    return old1 == old2;
+  }
+
+  return (old1->player == old2->player
+          && old1->tile == old2->tile
+          && old1->can_reveal_tiles == old2->can_reveal_tiles
+          && memcmp(old1->radius_sq, old2->radius_sq,
+                    sizeof(v_radius_t)) == 0);
+}
+
+/**********************************************************************//**
+  Return how many units of the list, starting with pdata, move with the
+  same vision as pdata, or 0 if an earlier unit already counted it.
+**************************************************************************/
+static int unit_move_data_sight_count(struct unit_move_data_list *plist,
+                                      const struct unit_move_data *pdata)
+{
+  bool before = TRUE;
+  int count = 0;
+
+  unit_move_data_list_iterate(plist, pother) {
+    if (pother == pdata) {
+      before = FALSE;
+    }
+    if (unit_move_data_same_sight(pother, pdata)) {
+      if (before) {
+        return 0;
+      }
+      count++;
+    }
+  } unit_move_data_list_iterate_end;
 
-  /* Enhance vision if unit steps into a fortress */
-  new_vision = vision_new(pdata->powner, pdesttile);
-  punit->server.vision = new_vision;
-  vision_change_sight(new_vision, radius_sq);
-  ASSERT_VISION(new_vision);
+  return count;
+}
+
+/**********************************************************************//**
+  Unfog the destination for the units of the list. Units moving with the
+  same vision get their seen counts changed together, and only on the
+  tiles they did not already see from where they came.
+**************************************************************************/
+static void unit_move_data_list_gain_sight(struct unit_move_data_list *plist,
+                                           struct tile *pdesttile)
+{
+  unit_move_data_list_iterate(plist, pdata) {
+    int count = unit_move_data_sight_count(plist, pdata);
+
+    if (count > 0) {
+      const struct tile *from_tile = unit_move_data_sight_from(pdata);
+
+      map_vision_shift(pdata->powner, from_tile,
+                       from_tile != nullptr
+                       ? pdata->old_vision->radius_sq : nullptr,
+                       pdesttile, pdata->radius_sq, count, TRUE);
+    }
+  } unit_move_data_list_iterate_end;
+
+  unit_move_data_list_iterate(plist, pdata) {
+    struct vision *new_vision = pdata->punit->server.vision;
+
+    vision_set_sight(new_vision, pdata->radius_sq);
+    ASSERT_VISION(new_vision);
+  } unit_move_data_list_iterate_end;
+}
+
+/**********************************************************************//**
+  Fog the tiles the units of the list no longer see from their old
+  position, and free their old vision. The counterpart of
+  unit_move_data_list_gain_sight().
+**************************************************************************/
+static void unit_move_data_list_lose_sight(struct unit_move_data_list *plist,
+                                           struct tile *pdesttile)
+{
+  const v_radius_t cleared_radius_sq = V_RADIUS(-1, -1, -1);
+
+  unit_move_data_list_iterate(plist, pdata) {
+    struct vision *old_vision = pdata->old_vision;
+    int count;
+
+    if (old_vision == nullptr) {
+      continue;
+    }
+
+    count = unit_move_data_sight_count(plist, pdata);
+    if (count > 0) {
+      bool paired = (unit_move_data_sight_from(pdata) != nullptr);
+
+      map_vision_shift(old_vision->player,
+                       paired ? pdesttile : nullptr,
+                       paired ? pdata->radius_sq : nullptr,
+                       old_vision->tile, old_vision->radius_sq,
+                       -count, old_vision->can_reveal_tiles);
+    }
+  } unit_move_data_list_iterate_end;
+
+  unit_move_data_list_iterate(plist, pdata) {
+    if (pdata->old_vision != nullptr) {
+      vision_set_sight(pdata->old_vision, cleared_radius_sq);
+      vision_free(pdata->old_vision);
+      pdata->old_vision = nullptr;
+    }
+  } unit_move_data_list_iterate_end;
+
+  vision_arrange_fogged_cities();
 }
 
 /**********************************************************************//**
@@ -4040,9 +4171,17 @@ static struct unit_move_data_list *construct_move_data_list(struct unit *punit,
   }
 
   unit_move_data_list_iterate(plist, pmove_data) {
-
     unit_move_by_data(pmove_data, psrctile, pdesttile);
+  } unit_move_data_list_iterate_end;
 
+  /* We first unfog the destination, then send the move,
+   * and then fog the old territory. This means that the player
+   * gets a chance to see the newly explored territory while the
+   * client moves the unit, and both areas are visible during the
+   * move */
+  unit_move_data_list_gain_sight(plist, pdesttile);
+
+  unit_move_data_list_iterate(plist, pmove_data) {
     if (adj && pmove_data->punit == punit) {
       /* If positions are adjacent, we have already handled 'punit'. See
        * above. */
@@ -4260,13 +4399,7 @@ bool unit_move(struct unit *punit, struct tile *pdesttile, int move_cost,
   } unit_move_data_list_iterate_end;
 
   /* Clear old vision. */
-  unit_move_data_list_iterate(plist, pmove_data) {
-    if (pmove_data->old_vision != nullptr) {
-      vision_clear_sight(pmove_data->old_vision);
-      vision_free(pmove_data->old_vision);
-      pmove_data->old_vision = nullptr;
-    }
-  } unit_move_data_list_iterate_end;
+  unit_move_data_list_lose_sight(plist, pdesttile);
 
   /* Move consequences. */
   unit_move_data_list_iterate(plist, pmove_data) {
@@ -0,0 +1,260 @@
+/***********************************************************************
+ Freeciv - Copyright (C) 1996-2026 - Freeciv Development Team
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+***********************************************************************/
+
+/**********************************************************************
+  Micro benchmarks of the genhash backends.
+
+  Each key set is inserted into a table, looked up in random order,
+  looked up with keys that are not there, iterated over and removed
+  again, first with chaining and then with open addressing. The key sets
+  mimic the tables switched to open addressing, and one that was not:
+    ids      - unit and city ids of the idex tables, identity hash
+    strings  - section file entry names, string hash
+    packets  - delta cache packets keyed by tile index
+**********************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <fc_config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* utility */
+#include "genhash.h"
+#include "mem.h"
+#include "rand.h"
+#include "shared.h"
+#include "support.h"
+#include "timing.h"
+
+/* Operations timed for each key set, size and backend. */
+#define HASHBENCH_OPERATIONS 2000000
+
+/* Stands for a tile info packet of the delta caches: allocated one by
+ * one, and hashed and compared by its key field only. */
+struct hashbench_packet {
+  int tile;
+  int payload[15];
+};
+
+struct hashbench_keys {
+  const char *name;
+  genhash_val_fn_t val_func;
+  genhash_comp_fn_t comp_func;
+  void **keys;                  /* Inserted */
+  void **misses;                /* Never inserted */
+};
+
+/* Keeps the compiler from dropping the lookups. */
+static volatile size_t hash_sink;
+
+/**********************************************************************//**
+  Put the pointers in random order.
+**************************************************************************/
+static void pointer_shuffle(void **array, int num)
+{
+  int i;
+
+  for (i = num - 1; i > 0; i--) {
+    int j = fc_rand(i + 1);
+    void *tmp = array[i];
+
+    array[i] = array[j];
+    array[j] = tmp;
+  }
+}
+
+/**********************************************************************//**
+  Same as the generated delta cache hash of PACKET_TILE_INFO.
+**************************************************************************/
+static genhash_val_t packet_hash_val(const void *vkey)
+{
+  const struct hashbench_packet *key = vkey;
+
+  return key->tile;
+}
+
+/**********************************************************************//**
+  Same as the generated delta cache comparison of PACKET_TILE_INFO.
+**************************************************************************/
+static bool packet_hash_comp(const void *vkey1, const void *vkey2)
+{
+  const struct hashbench_packet *key1 = vkey1;
+  const struct hashbench_packet *key2 = vkey2;
+
+  return key1->tile == key2->tile;
+}
+
+/**********************************************************************//**
+  Time all the operations on one key set with one backend.
+**************************************************************************/
+static void hashbench_run(const struct hashbench_keys *set, int num,
+                          bool open_addressing)
+{
+  enum { INSERT, HIT, MISS, ITERATE, REMOVE, NUM_OPS };
+  struct timer *op_timers[NUM_OPS];
+  void **order = fc_malloc(num * sizeof(*order));
+  int rounds = MAX(1, HASHBENCH_OPERATIONS / num);
+  int r, i;
+
+  for (i = 0; i < NUM_OPS; i++) {
+    op_timers[i] = timer_new(TIMER_USER, TIMER_ACTIVE, "hash benchmark");
+  }
+
+  for (r = 0; r < rounds; r++) {
+    struct genhash *phash = genhash_new(set->val_func, set->comp_func);
+    void *data;
+
+    genhash_set_open_addressing(phash, open_addressing);
+
+    timer_start(op_timers[INSERT]);
+    for (i = 0; i < num; i++) {
+      genhash_insert(phash, set->keys[i], set->keys[i]);
+    }
+    timer_stop(op_timers[INSERT]);
+
+    memcpy(order, set->keys, num * sizeof(*order));
+    pointer_shuffle(order, num);
+
+    timer_start(op_timers[HIT]);
+    for (i = 0; i < num; i++) {
+      genhash_lookup(phash, order[i], &data);
+      hash_sink += (size_t) data;
+    }
+    timer_stop(op_timers[HIT]);
+
+    timer_start(op_timers[MISS]);
+    for (i = 0; i < num; i++) {
+      hash_sink += genhash_lookup(phash, set->misses[i], &data);
+    }
+    timer_stop(op_timers[MISS]);
+
+    timer_start(op_timers[ITERATE]);
+    genhash_values_iterate(phash, value) {
+      hash_sink += (size_t) value;
+    } genhash_values_iterate_end;
+    timer_stop(op_timers[ITERATE]);
+
+    timer_start(op_timers[REMOVE]);
+    for (i = 0; i < num; i++) {
+      genhash_remove(phash, order[i]);
+    }
+    timer_stop(op_timers[REMOVE]);
+
+    genhash_destroy(phash);
+  }
+
+  printf("keys=%s backend=%s entries=%d"
+         " insert_ns=%.1f hit_ns=%.1f miss_ns=%.1f iterate_ns=%.1f"
+         " remove_ns=%.1f\n",
+         set->name, open_addressing ? "open" : "chained", num,
+         1e9 * timer_read_seconds(op_timers[INSERT]) / rounds / num,
+         1e9 * timer_read_seconds(op_timers[HIT]) / rounds / num,
+         1e9 * timer_read_seconds(op_timers[MISS]) / rounds / num,
+         1e9 * timer_read_seconds(op_timers[ITERATE]) / rounds / num,
+         1e9 * timer_read_seconds(op_timers[REMOVE]) / rounds / num);
+  fflush(stdout);
+
+  for (i = 0; i < NUM_OPS; i++) {
+    timer_destroy(op_timers[i]);
+  }
+  free(order);
+}
+
+/**********************************************************************//**
+  Time both backends on one key set, in random insertion order.
+**************************************************************************/
+static void hashbench_compare(struct hashbench_keys *set, int num)
+{
+  pointer_shuffle(set->keys, num);
+  pointer_shuffle(set->misses, num);
+
+  hashbench_run(set, num, FALSE);
+  hashbench_run(set, num, TRUE);
+}
+
+/**********************************************************************//**
+  Entry point of the hash table benchmark. Results go to stdout, one
+  line per key set, size and backend, in nanoseconds per operation.
+**************************************************************************/
+int main(int argc, char **argv)
+{
+  const int sizes[] = { 1000, 10000, 100000 };
+  struct hashbench_keys set;
+  int s, i;
+
+  fc_support_init();
+  fc_srand(1);
+
+  for (s = 0; s < ARRAY_SIZE(sizes); s++) {
+    int num = sizes[s];
+
+    set.keys = fc_malloc(num * sizeof(*set.keys));
+    set.misses = fc_malloc(num * sizeof(*set.misses));
+
+    /* Ids are handed out in order, with other objects in between. */
+    set.name = "ids";
+    set.val_func = nullptr;
+    set.comp_func = nullptr;
+    for (i = 0; i < num; i++) {
+      set.keys[i] = FC_INT_TO_PTR(101 + 3 * i);
+      set.misses[i] = FC_INT_TO_PTR(102 + 3 * i);
+    }
+    hashbench_compare(&set, num);
+
+    set.name = "strings";
+    set.val_func = (genhash_val_fn_t) genhash_str_val_func;
+    set.comp_func = (genhash_comp_fn_t) genhash_str_comp_func;
+    for (i = 0; i < num; i++) {
+      char buf[64];
+
+      fc_snprintf(buf, sizeof(buf), "player%d.u%d_activity", i % 16, i);
+      set.keys[i] = fc_strdup(buf);
+      fc_snprintf(buf, sizeof(buf), "player%d.c%d_name", i % 16, i);
+      set.misses[i] = fc_strdup(buf);
+    }
+    hashbench_compare(&set, num);
+    for (i = 0; i < num; i++) {
+      free(set.keys[i]);
+      free(set.misses[i]);
+    }
+
+    set.name = "packets";
+    set.val_func = packet_hash_val;
+    set.comp_func = packet_hash_comp;
+    for (i = 0; i < num; i++) {
+      struct hashbench_packet *packet;
+
+      packet = fc_calloc(1, sizeof(*packet));
+      packet->tile = i;
+      set.keys[i] = packet;
+      packet = fc_calloc(1, sizeof(*packet));
+      packet->tile = num + i;
+      set.misses[i] = packet;
+    }
+    hashbench_compare(&set, num);
+    for (i = 0; i < num; i++) {
+      free(set.keys[i]);
+      free(set.misses[i]);
+    }
+
+    free(set.keys);
+    free(set.misses);
+  }
+
+  fc_support_free();
+
+  return EXIT_SUCCESS;
+}
@@ -19,6 +19,7 @@
 
 #include <errno.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -261,6 +262,42 @@ void dbv_debug(struct dbv *pdbv)
   }
 }
 
+/* Static bitvector operations handle this much of the vector at once. */
+typedef uint64_t bv_word;
+
+/***********************************************************************//**
+  Load one machine word from a possibly unaligned bitvector position.
+***************************************************************************/
+static inline bv_word bv_word_get(const unsigned char *vec)
+{
+  bv_word word;
+
+  memcpy(&word, vec, sizeof(word));
+
+  return word;
+}
+
+/***********************************************************************//**
+  Store one machine word to a possibly unaligned bitvector position.
+***************************************************************************/
+static inline void bv_word_put(unsigned char *vec, bv_word word)
+{
+  memcpy(vec, &word, sizeof(word));
+}
+
+/***********************************************************************//**
+  Return number of bits set in the word.
+***************************************************************************/
+static inline int bv_word_count(bv_word word)
+{
+  word = word - ((word >> 1) & 0x5555555555555555ULL);
+  word = (word & 0x3333333333333333ULL)
+         + ((word >> 2) & 0x3333333333333333ULL);
+  word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+
+  return (int) ((word * 0x0101010101010101ULL) >> 56);
+}
+
 /***********************************************************************//**
   Return whether two vectors: vec1 and vec2 have common
   bits. I.e. (vec1 & vec2) != 0.
@@ -275,12 +312,15 @@ bool bv_check_mask(const unsigned char *vec1, const unsigned char *vec2,
 
   fc_assert_ret_val(size1 == size2, FALSE);
 
-  for (i = 0; i < size1; i++) {
-    if ((vec1[0] & vec2[0]) != 0) {
+  for (i = 0; i + sizeof(bv_word) <= size1; i += sizeof(bv_word)) {
+    if ((bv_word_get(vec1 + i) & bv_word_get(vec2 + i)) != 0) {
+      return TRUE;
+    }
+  }
+  for (; i < size1; i++) {
+    if ((vec1[i] & vec2[i]) != 0) {
       return TRUE;
     }
-    vec1++;
-    vec2++;
   }
 
   return FALSE;
@@ -297,17 +337,122 @@ bool bv_are_equal(const unsigned char *vec1, const unsigned char *vec2,
 
   fc_assert_ret_val(size1 == size2, FALSE);
 
-  for (i = 0; i < size1; i++) {
-    if (vec1[0] != vec2[0]) {
+  for (i = 0; i + sizeof(bv_word) <= size1; i += sizeof(bv_word)) {
+    if (bv_word_get(vec1 + i) != bv_word_get(vec2 + i)) {
+      return FALSE;
+    }
+  }
+  for (; i < size1; i++) {
+    if (vec1[i] != vec2[i]) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/***********************************************************************//**
+  Compare the bits of vec1 and vec2 that are set in mask. Bits outside
+  the mask may differ. I.e. ((vec1 ^ vec2) & mask) == 0.
+
+  All the vectors are expected to have same number of elements.
+
+  Don't call this function directly, use BV_MATCH_MASK macro instead.
+***************************************************************************/
+bool bv_match_mask(const unsigned char *vec1, const unsigned char *vec2,
+                   const unsigned char *mask,
+                   size_t size1, size_t size2, size_t size_mask)
+{
+  size_t i;
+
+  fc_assert_ret_val(size1 == size2 && size1 == size_mask, FALSE);
+
+  for (i = 0; i + sizeof(bv_word) <= size1; i += sizeof(bv_word)) {
+    if (((bv_word_get(vec1 + i) ^ bv_word_get(vec2 + i))
+         & bv_word_get(mask + i)) != 0) {
+      return FALSE;
+    }
+  }
+  for (; i < size1; i++) {
+    if (((vec1[i] ^ vec2[i]) & mask[i]) != 0) {
       return FALSE;
     }
-    vec1++;
-    vec2++;
   }
 
   return TRUE;
 }
 
+/***********************************************************************//**
+  Return number of bits set in the bitvector.
+
+  Don't call this function directly, use BV_COUNT macro instead.
+***************************************************************************/
+int bv_count(const unsigned char *vec, size_t size)
+{
+  size_t i;
+  int count = 0;
+
+  for (i = 0; i + sizeof(bv_word) <= size; i += sizeof(bv_word)) {
+    count += bv_word_count(bv_word_get(vec + i));
+  }
+  for (; i < size; i++) {
+    count += bv_word_count(vec[i]);
+  }
+
+  return count;
+}
+
+/***********************************************************************//**
+  Return the first bit set in the bitvector at or after the bit 'start',
+  or -1 if there's no such bit. Whole zero words are skipped at once.
+
+  Don't call this function directly, use bv_iterate_set() macro instead.
+***************************************************************************/
+int bv_next_set(const unsigned char *vec, size_t size, int start)
+{
+  size_t i = _BV_BYTE_INDEX(start);
+  unsigned char byte;
+
+  if (start < 0 || i >= size) {
+    return -1;
+  }
+
+  /* Rest of the byte the search starts from. */
+  byte = vec[i] & (unsigned char) (0xff << (start & 0x7));
+  if (byte == 0) {
+    /* Bytes up to the next word boundary, then whole words. */
+    for (i++; i < size && (i % sizeof(bv_word)) != 0; i++) {
+      if (vec[i] != 0) {
+        break;
+      }
+    }
+    if (i < size && vec[i] == 0) {
+      for (; i + sizeof(bv_word) <= size; i += sizeof(bv_word)) {
+        if (bv_word_get(vec + i) != 0) {
+          break;
+        }
+      }
+      for (; i < size; i++) {
+        if (vec[i] != 0) {
+          break;
+        }
+      }
+    }
+    if (i >= size) {
+      return -1;
+    }
+    byte = vec[i];
+  }
+
+  start = i * 8;
+  while ((byte & 0x1) == 0) {
+    byte >>= 1;
+    start++;
+  }
+
+  return start;
+}
+
 /***********************************************************************//**
   Set everything that is true in vec_from in vec_to. Stuff that already is
   true in vec_to aren't touched. (Bitwise inclusive OR assignment)
@@ -325,7 +470,11 @@ void bv_set_all_from(unsigned char *vec_to,
 
   fc_assert_ret(size_to == size_from);
 
-  for (i = 0; i < size_to; i++) {
+  for (i = 0; i + sizeof(bv_word) <= size_to; i += sizeof(bv_word)) {
+    bv_word_put(vec_to + i,
+                bv_word_get(vec_to + i) | bv_word_get(vec_from + i));
+  }
+  for (; i < size_to; i++) {
     vec_to[i] |= vec_from[i];
   }
 }
@@ -347,7 +496,37 @@ void bv_clr_all_from(unsigned char *vec_to,
 
   fc_assert_ret(size_to == size_from);
 
-  for (i = 0; i < size_to; i++) {
+  for (i = 0; i + sizeof(bv_word) <= size_to; i += sizeof(bv_word)) {
+    bv_word_put(vec_to + i,
+                bv_word_get(vec_to + i) & ~bv_word_get(vec_from + i));
+  }
+  for (; i < size_to; i++) {
     vec_to[i] &= ~vec_from[i];
   }
 }
+
+/***********************************************************************//**
+  Clear everything in vec_to that is not true in vec_from.
+  (Bitwise AND assignment)
+
+  Both vectors are expected to have same number of elements,
+  i.e. , size1 must be equal to size2.
+
+  Don't call this function directly, use BV_KEEP_ALL_FROM macro instead.
+***************************************************************************/
+void bv_keep_all_from(unsigned char *vec_to,
+                      const unsigned char *vec_from,
+                      size_t size_to, size_t size_from)
+{
+  size_t i;
+
+  fc_assert_ret(size_to == size_from);
+
+  for (i = 0; i + sizeof(bv_word) <= size_to; i += sizeof(bv_word)) {
+    bv_word_put(vec_to + i,
+                bv_word_get(vec_to + i) & bv_word_get(vec_from + i));
+  }
+  for (; i < size_to; i++) {
+    vec_to[i] &= vec_from[i];
+  }
+}
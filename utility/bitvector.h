@@ -136,6 +136,38 @@ void bv_clr_all_from(unsigned char *vec_to,
   bv_clr_all_from((vec_to).vec, (vec_from).vec,                           \
                   sizeof((vec_to).vec), sizeof((vec_from).vec))
 
+bool bv_match_mask(const unsigned char *vec1, const unsigned char *vec2,
+                   const unsigned char *mask,
+                   size_t size1, size_t size2, size_t size_mask);
+#define BV_MATCH_MASK(vec1, vec2, mask)                                   \
+  bv_match_mask((vec1).vec, (vec2).vec, (mask).vec, sizeof((vec1).vec),   \
+                sizeof((vec2).vec), sizeof((mask).vec))
+
+int bv_count(const unsigned char *vec, size_t size);
+#define BV_COUNT(bv) bv_count((bv).vec, sizeof((bv).vec))
+
+int bv_next_set(const unsigned char *vec, size_t size, int start);
+
+/* Iterate over the bits set in the static bitvector, in increasing
+ * order. The vector must not be changed during the iteration. */
+#define bv_iterate_set(bv, _bit)                                          \
+{                                                                         \
+  int _bit;                                                               \
+                                                                          \
+  for (_bit = bv_next_set((bv).vec, sizeof((bv).vec), 0);                 \
+       _bit >= 0;                                                         \
+       _bit = bv_next_set((bv).vec, sizeof((bv).vec), _bit + 1)) {
+#define bv_iterate_set_end                                                \
+  }                                                                       \
+}
+
+void bv_keep_all_from(unsigned char *vec_to,
+                      const unsigned char *vec_from,
+                      size_t size_to, size_t size_from);
+#define BV_KEEP_ALL_FROM(vec_to, vec_from)                                \
+  bv_keep_all_from((vec_to).vec, (vec_from).vec,                          \
+                   sizeof((vec_to).vec), sizeof((vec_from).vec))
+
 /* Used to make a BV typedef. Such types are usually called "bv_foo". */
 #define BV_DEFINE(name, bits)                                               \
   typedef struct { unsigned char vec[_BV_BYTES(bits)]; } name
@@ -16,6 +16,7 @@
 #endif
 
 /* utility */
+#include "genlist.h"
 #include "log.h"
 #include "mem.h"
 #include "support.h"
@@ -51,6 +52,8 @@ static void at_thread_exit(void)
   if (ate_cb != nullptr) {
     ate_cb();
   }
+
+  genlist_thread_exit();
 }
 
 #ifdef FREECIV_C11_THR
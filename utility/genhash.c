@@ -53,6 +53,14 @@
    Implementation uses open hashing. Collision resolution is done by
    separate chaining with linked lists. Resize hash table when deemed
    necessary by making and populating a new table.
+
+   Alternatively, a table can be switched to closed hashing (open
+   addressing) with genhash_set_open_addressing(). Then the entries are
+   stored directly in the table array with their hash values, and
+   collisions are resolved by linear probing with Robin Hood ordering.
+   This avoids an allocation per entry and the pointer chasing on
+   lookups, which suits tables with many entries and frequent lookups.
+   Keys and data pointers are handled the same way in both cases.
 ****************************************************************************/
 
 #ifdef HAVE_CONFIG_H
@@ -79,17 +87,27 @@ struct genhash_entry {
   struct genhash_entry *next;
 };
 
+/* Entry of an open addressing table, stored in the table array. */
+struct genhash_cell {
+  void *key;
+  void *data;
+  genhash_val_t hash_val;
+  unsigned int dist;            /* Probe distance + 1, 0 for free cells. */
+};
+
 /* Contents of the opaque type: */
 struct genhash {
-  struct genhash_entry **buckets;
+  struct genhash_entry **buckets;       /* nullptr for open addressing. */
+  struct genhash_cell *cells;           /* Only for open addressing. */
   genhash_val_fn_t key_val_func;
   genhash_comp_fn_t key_comp_func;
   genhash_copy_fn_t key_copy_func;
   genhash_free_fn_t key_free_func;
   genhash_copy_fn_t data_copy_func;
   genhash_free_fn_t data_free_func;
-  size_t num_buckets;
+  size_t num_buckets;           /* Or number of cells. */
   size_t num_entries;
+  int cell_bits;                /* num_buckets == 1 << cell_bits for cells. */
   bool no_shrink;               /* Do not auto-shrink when set. */
 };
 
@@ -97,6 +115,7 @@ struct genhash_iter {
   struct iterator vtable;
   struct genhash_entry *const *bucket, *const *end;
   const struct genhash_entry *iterator;
+  const struct genhash_cell *cell, *cell_end;   /* For open addressing. */
 };
 
 #define GENHASH_ITER(p) ((struct genhash_iter *) (p))
@@ -186,6 +205,26 @@ static size_t genhash_calc_num_buckets(size_t num_entries)
   return *pframe;
 }
 
+/************************************************************************//**
+  Calculate the number of cells (as a power of 2) for a given number of
+  entries in an open addressing table. The table ends up between a third
+  and two thirds full, the rounding up to a power of 2 gives the rest of
+  the breathing room.
+****************************************************************************/
+#define MIN_CELL_BITS 5
+static int genhash_calc_cell_bits(size_t num_entries)
+{
+  int bits = MIN_CELL_BITS;
+
+  num_entries += num_entries >> 1; /* breathing room */
+
+  while (((size_t) 1 << bits) < num_entries) {
+    bits++;
+  }
+
+  return bits;
+}
+
 /************************************************************************//**
   Internal constructor, specifying exact number of buckets.
   Allows to specify functions to free the memory allocated for the key and
@@ -210,6 +249,7 @@ genhash_new_nbuckets(genhash_val_fn_t key_val_func,
             (long unsigned) num_buckets);
 
   pgenhash->buckets = fc_calloc(num_buckets, sizeof(*pgenhash->buckets));
+  pgenhash->cells = nullptr;
   pgenhash->key_val_func = key_val_func;
   pgenhash->key_comp_func = key_comp_func;
   pgenhash->key_copy_func = key_copy_func;
@@ -218,6 +258,7 @@ genhash_new_nbuckets(genhash_val_fn_t key_val_func,
   pgenhash->data_free_func = data_free_func;
   pgenhash->num_buckets = num_buckets;
   pgenhash->num_entries = 0;
+  pgenhash->cell_bits = 0;
   pgenhash->no_shrink = FALSE;
 
   return pgenhash;
@@ -292,9 +333,118 @@ void genhash_destroy(struct genhash *pgenhash)
   pgenhash->no_shrink = TRUE;
   genhash_clear(pgenhash);
   free(pgenhash->buckets);
+  free(pgenhash->cells);
   free(pgenhash);
 }
 
+/************************************************************************//**
+  Return the home cell of the hash value in an open addressing table.
+  Fibonacci hashing spreads also keys that differ only in their high
+  bits, such as pointers.
+****************************************************************************/
+static inline size_t genhash_cell_home(const struct genhash *pgenhash,
+                                       genhash_val_t hash_val)
+{
+  return (uint32_t) (hash_val * 2654435769u) >> (32 - pgenhash->cell_bits);
+}
+
+/************************************************************************//**
+  Store an entry whose key is not in the open addressing table yet,
+  moving entries closer to their home cell out of the way.
+****************************************************************************/
+static void genhash_cell_place(struct genhash *pgenhash, void *key,
+                               void *data, genhash_val_t hash_val)
+{
+  struct genhash_cell entry = { key, data, hash_val, 1 };
+  size_t mask = pgenhash->num_buckets - 1;
+  size_t i = genhash_cell_home(pgenhash, hash_val);
+
+  for (;; i = (i + 1) & mask, entry.dist++) {
+    struct genhash_cell *cell = pgenhash->cells + i;
+
+    if (cell->dist == 0) {
+      *cell = entry;
+      return;
+    }
+    if (cell->dist < entry.dist) {
+      struct genhash_cell tmp = *cell;
+
+      *cell = entry;
+      entry = tmp;
+    }
+  }
+}
+
+/************************************************************************//**
+  Return the cell where the key resides, or nullptr if the key is not in
+  the open addressing table.
+****************************************************************************/
+static inline struct genhash_cell *
+genhash_cell_lookup(const struct genhash *pgenhash, const void *key,
+                    genhash_val_t hash_val)
+{
+  genhash_comp_fn_t key_comp_func = pgenhash->key_comp_func;
+  size_t mask = pgenhash->num_buckets - 1;
+  size_t i = genhash_cell_home(pgenhash, hash_val);
+  unsigned int dist;
+
+  /* Stop at the first cell closer to its home than the key would be. */
+  for (dist = 1; dist <= pgenhash->cells[i].dist;
+       dist++, i = (i + 1) & mask) {
+    struct genhash_cell *cell = pgenhash->cells + i;
+
+    if (cell->hash_val == hash_val
+        && (key_comp_func != nullptr
+            ? key_comp_func(cell->key, key) : cell->key == key)) {
+      return cell;
+    }
+  }
+
+  return nullptr;
+}
+
+/************************************************************************//**
+  Free the cell in the open addressing table, shifting the following
+  entries back towards their home cells.
+****************************************************************************/
+static void genhash_cell_erase(struct genhash *pgenhash,
+                               struct genhash_cell *cell)
+{
+  size_t mask = pgenhash->num_buckets - 1;
+  size_t i = cell - pgenhash->cells;
+  size_t next;
+
+  for (next = (i + 1) & mask; pgenhash->cells[next].dist > 1;
+       i = next, next = (i + 1) & mask) {
+    pgenhash->cells[i] = pgenhash->cells[next];
+    pgenhash->cells[i].dist--;
+  }
+  pgenhash->cells[i].dist = 0;
+}
+
+/************************************************************************//**
+  Resize the open addressing table: replace all the entries.
+****************************************************************************/
+static void genhash_resize_cells(struct genhash *pgenhash, int new_bits)
+{
+  struct genhash_cell *old_cells = pgenhash->cells, *cell, *end;
+
+  end = old_cells + pgenhash->num_buckets;
+
+  pgenhash->cell_bits = new_bits;
+  pgenhash->num_buckets = (size_t) 1 << new_bits;
+  pgenhash->cells = fc_calloc(pgenhash->num_buckets,
+                              sizeof(*pgenhash->cells));
+
+  for (cell = old_cells; cell < end; cell++) {
+    if (cell->dist != 0) {
+      genhash_cell_place(pgenhash, cell->key, cell->data, cell->hash_val);
+    }
+  }
+
+  free(old_cells);
+}
+
 /************************************************************************//**
   Resize the genhash table: relink entries.
 ****************************************************************************/
@@ -346,7 +496,9 @@ static bool genhash_maybe_resize(struct genhash *pgenhash, bool expandingp)
       return FALSE;
     }
   } else {
-    if (pgenhash->num_buckets <= MIN_BUCKETS) {
+    if (pgenhash->num_buckets
+        <= (pgenhash->cells != nullptr
+            ? (size_t) 1 << MIN_CELL_BITS : MIN_BUCKETS)) {
       return FALSE;
     }
     limit = MIN_RATIO * pgenhash->num_buckets;
@@ -355,6 +507,20 @@ static bool genhash_maybe_resize(struct genhash *pgenhash, bool expandingp)
     }
   }
 
+  if (pgenhash->cells != nullptr) {
+    int new_bits = genhash_calc_cell_bits(pgenhash->num_entries);
+
+    log_debug("%s open addressing genhash (entries = %lu, cells = %lu, "
+              "new = %lu, %s limit = %lu)",
+              expandingp ? "Expanding" : "Shrinking",
+              (long unsigned) pgenhash->num_entries,
+              (long unsigned) pgenhash->num_buckets,
+              (long unsigned) 1 << new_bits,
+              expandingp ? "up": "down", (long unsigned) limit);
+    genhash_resize_cells(pgenhash, new_bits);
+    return TRUE;
+  }
+
   new_nbuckets = genhash_calc_num_buckets(pgenhash->num_entries);
 
   log_debug("%s genhash (entries = %lu, buckets =  %lu, new = %lu, "
@@ -503,6 +669,97 @@ static inline void genhash_slot_set(struct genhash *pgenhash,
                  ? pgenhash->data_copy_func(data) : (void *) data);
 }
 
+/************************************************************************//**
+  Call the copy callbacks and store the entry in the open addressing
+  table. The key must not be in the table yet.
+****************************************************************************/
+static inline void genhash_cell_create(struct genhash *pgenhash,
+                                       const void *key, const void *data,
+                                       genhash_val_t hash_val)
+{
+  genhash_cell_place(pgenhash,
+                     (pgenhash->key_copy_func != nullptr
+                      ? pgenhash->key_copy_func(key) : (void *) key),
+                     (pgenhash->data_copy_func != nullptr
+                      ? pgenhash->data_copy_func(data) : (void *) data),
+                     hash_val);
+}
+
+/************************************************************************//**
+  Call the free callbacks for the contents of the cell.
+****************************************************************************/
+static inline void genhash_cell_free(struct genhash *pgenhash,
+                                     struct genhash_cell *cell)
+{
+  if (pgenhash->key_free_func != nullptr) {
+    pgenhash->key_free_func(cell->key);
+  }
+  if (pgenhash->data_free_func != nullptr) {
+    pgenhash->data_free_func(cell->data);
+  }
+}
+
+/************************************************************************//**
+  Switch the genhash table between separate chaining and open addressing.
+  Returns the old value of the setting.
+****************************************************************************/
+bool genhash_set_open_addressing(struct genhash *pgenhash,
+                                 bool open_addressing)
+{
+  bool old = (pgenhash->cells != nullptr);
+
+  if (open_addressing == old) {
+    return old;
+  }
+
+  if (open_addressing) {
+    struct genhash_entry **bucket, **end, *iter, *next;
+
+    bucket = pgenhash->buckets;
+    end = bucket + pgenhash->num_buckets;
+
+    pgenhash->cell_bits = genhash_calc_cell_bits(pgenhash->num_entries);
+    pgenhash->num_buckets = (size_t) 1 << pgenhash->cell_bits;
+    pgenhash->cells = fc_calloc(pgenhash->num_buckets,
+                                sizeof(*pgenhash->cells));
+
+    for (; bucket < end; bucket++) {
+      for (iter = *bucket; iter != nullptr; iter = next) {
+        next = iter->next;
+        genhash_cell_place(pgenhash, iter->key, iter->data, iter->hash_val);
+        free(iter);
+      }
+    }
+    FC_FREE(pgenhash->buckets);
+  } else {
+    struct genhash_cell *cell = pgenhash->cells;
+    struct genhash_cell *end = cell + pgenhash->num_buckets;
+
+    pgenhash->num_buckets = genhash_calc_num_buckets(pgenhash->num_entries);
+    pgenhash->buckets = fc_calloc(pgenhash->num_buckets,
+                                  sizeof(*pgenhash->buckets));
+
+    for (; cell < end; cell++) {
+      if (cell->dist != 0) {
+        struct genhash_entry **slot = (pgenhash->buckets
+                                       + (cell->hash_val
+                                          % pgenhash->num_buckets));
+        struct genhash_entry *entry = fc_malloc(sizeof(*entry));
+
+        entry->key = cell->key;
+        entry->data = cell->data;
+        entry->hash_val = cell->hash_val;
+        entry->next = *slot;
+        *slot = entry;
+      }
+    }
+    FC_FREE(pgenhash->cells);
+    pgenhash->cell_bits = 0;
+  }
+
+  return old;
+}
+
 /************************************************************************//**
   Prevent or allow the genhash table automatically shrinking. Returns the
   old value of the setting.
@@ -526,7 +783,7 @@ size_t genhash_size(const struct genhash *pgenhash)
 }
 
 /************************************************************************//**
-  Returns the number of buckets in the genhash table.
+  Returns the number of buckets (or cells) in the genhash table.
 ****************************************************************************/
 size_t genhash_capacity(const struct genhash *pgenhash)
 {
@@ -548,6 +805,31 @@ struct genhash *genhash_copy(const struct genhash *pgenhash)
   /* Copy fields. */
   *new_genhash = *pgenhash;
 
+  if (pgenhash->cells != nullptr) {
+    const struct genhash_cell *src_cell = pgenhash->cells;
+    const struct genhash_cell *src_end = src_cell + pgenhash->num_buckets;
+    struct genhash_cell *dest_cell;
+
+    /* Same cells, same positions. */
+    new_genhash->cells = fc_calloc(new_genhash->num_buckets,
+                                   sizeof(*new_genhash->cells));
+    dest_cell = new_genhash->cells;
+    for (; src_cell < src_end; src_cell++, dest_cell++) {
+      if (src_cell->dist != 0) {
+        dest_cell->key = (pgenhash->key_copy_func != nullptr
+                          ? pgenhash->key_copy_func(src_cell->key)
+                          : src_cell->key);
+        dest_cell->data = (pgenhash->data_copy_func != nullptr
+                           ? pgenhash->data_copy_func(src_cell->data)
+                           : src_cell->data);
+        dest_cell->hash_val = src_cell->hash_val;
+        dest_cell->dist = src_cell->dist;
+      }
+    }
+
+    return new_genhash;
+  }
+
   /* But make fresh buckets. */
   new_genhash->buckets = fc_calloc(new_genhash->num_buckets,
                                    sizeof(*new_genhash->buckets));
@@ -577,6 +859,22 @@ void genhash_clear(struct genhash *pgenhash)
 {
   struct genhash_entry **bucket, **end;
 
+  if (pgenhash->cells != nullptr) {
+    struct genhash_cell *cell = pgenhash->cells;
+    struct genhash_cell *cell_end = cell + pgenhash->num_buckets;
+
+    for (; cell < cell_end; cell++) {
+      if (cell->dist != 0) {
+        genhash_cell_free(pgenhash, cell);
+        cell->dist = 0;
+      }
+    }
+
+    pgenhash->num_entries = 0;
+    genhash_maybe_shrink(pgenhash);
+    return;
+  }
+
   bucket = pgenhash->buckets;
   end = bucket + pgenhash->num_buckets;
   for (; bucket < end; bucket++) {
@@ -600,6 +898,16 @@ bool genhash_insert(struct genhash *pgenhash, const void *key,
   genhash_val_t hash_val;
 
   hash_val = genhash_val_calc(pgenhash, key);
+  if (pgenhash->cells != nullptr) {
+    if (genhash_cell_lookup(pgenhash, key, hash_val) != nullptr) {
+      return FALSE;
+    }
+    genhash_maybe_expand(pgenhash);
+    genhash_cell_create(pgenhash, key, data, hash_val);
+    pgenhash->num_entries++;
+    return TRUE;
+  }
+
   slot = genhash_slot_lookup(pgenhash, key, hash_val);
   if (*slot != nullptr) {
     return FALSE;
@@ -642,6 +950,33 @@ bool genhash_replace_full(struct genhash *pgenhash, const void *key,
   genhash_val_t hash_val;
 
   hash_val = genhash_val_calc(pgenhash, key);
+  if (pgenhash->cells != nullptr) {
+    struct genhash_cell *cell = genhash_cell_lookup(pgenhash, key, hash_val);
+
+    if (cell != nullptr) {
+      /* Replace. */
+      if (old_pkey != nullptr) {
+        *old_pkey = cell->key;
+      }
+      if (old_pdata != nullptr) {
+        *old_pdata = cell->data;
+      }
+      genhash_cell_free(pgenhash, cell);
+      cell->key = (pgenhash->key_copy_func != nullptr
+                   ? pgenhash->key_copy_func(key) : (void *) key);
+      cell->data = (pgenhash->data_copy_func != nullptr
+                    ? pgenhash->data_copy_func(data) : (void *) data);
+      return TRUE;
+    }
+
+    /* Insert. */
+    genhash_maybe_expand(pgenhash);
+    genhash_default_get(old_pkey, old_pdata);
+    genhash_cell_create(pgenhash, key, data, hash_val);
+    pgenhash->num_entries++;
+    return FALSE;
+  }
+
   slot = genhash_slot_lookup(pgenhash, key, hash_val);
   if (*slot != nullptr) {
     /* Replace. */
@@ -670,6 +1005,20 @@ bool genhash_lookup(const struct genhash *pgenhash, const void *key,
 {
   struct genhash_entry **slot;
 
+  if (pgenhash->cells != nullptr) {
+    const struct genhash_cell *cell
+      = genhash_cell_lookup(pgenhash, key, genhash_val_calc(pgenhash, key));
+
+    if (cell != nullptr) {
+      if (pdata != nullptr) {
+        *pdata = cell->data;
+      }
+      return TRUE;
+    }
+    genhash_default_get(nullptr, pdata);
+    return FALSE;
+  }
+
   slot = genhash_slot_lookup(pgenhash, key, genhash_val_calc(pgenhash, key));
   if (*slot != nullptr) {
     genhash_slot_get(slot, nullptr, pdata);
@@ -700,6 +1049,30 @@ bool genhash_remove_full(struct genhash *pgenhash, const void *key,
 {
   struct genhash_entry **slot;
 
+  if (pgenhash->cells != nullptr) {
+    struct genhash_cell *cell
+      = genhash_cell_lookup(pgenhash, key, genhash_val_calc(pgenhash, key));
+
+    if (cell == nullptr) {
+      genhash_default_get(deleted_pkey, deleted_pdata);
+      return FALSE;
+    }
+    if (deleted_pkey != nullptr) {
+      *deleted_pkey = cell->key;
+    }
+    if (deleted_pdata != nullptr) {
+      *deleted_pdata = cell->data;
+    }
+    genhash_cell_free(pgenhash, cell);
+    genhash_cell_erase(pgenhash, cell);
+
+    fc_assert(0 < pgenhash->num_entries);
+
+    pgenhash->num_entries--;
+    genhash_maybe_shrink(pgenhash);
+    return TRUE;
+  }
+
   slot = genhash_slot_lookup(pgenhash, key, genhash_val_calc(pgenhash, key));
   if (*slot != nullptr) {
     genhash_slot_get(slot, deleted_pkey, deleted_pdata);
@@ -726,6 +1099,38 @@ bool genhashes_are_equal(const struct genhash *pgenhash1,
   return genhashes_are_equal_full(pgenhash1, pgenhash2, nullptr);
 }
 
+/************************************************************************//**
+  Returns TRUE iff the genhash table contains the key with equal data.
+****************************************************************************/
+static bool genhash_has_pair(const struct genhash *pgenhash,
+                             const void *key, const void *data,
+                             genhash_val_t hash_val,
+                             genhash_comp_fn_t data_comp_func)
+{
+  const void *found;
+
+  if (pgenhash->cells != nullptr) {
+    const struct genhash_cell *cell
+      = genhash_cell_lookup(pgenhash, key, hash_val);
+
+    if (cell == nullptr) {
+      return FALSE;
+    }
+    found = cell->data;
+  } else {
+    struct genhash_entry *const *slot
+      = genhash_slot_lookup(pgenhash, key, hash_val);
+
+    if (*slot == nullptr) {
+      return FALSE;
+    }
+    found = (*slot)->data;
+  }
+
+  return (data == found
+          || (data_comp_func != nullptr && data_comp_func(data, found)));
+}
+
 /************************************************************************//**
   Returns TRUE iff the hash tables contains the same pairs of key/data.
 ****************************************************************************/
@@ -733,7 +1138,7 @@ bool genhashes_are_equal_full(const struct genhash *pgenhash1,
                               const struct genhash *pgenhash2,
                               genhash_comp_fn_t data_comp_func)
 {
-  struct genhash_entry *const *bucket1, *const *max1, *const *slot2;
+  struct genhash_entry *const *bucket1, *const *max1;
   const struct genhash_entry *iter1;
 
   /* Check pointers. */
@@ -752,16 +1157,28 @@ bool genhashes_are_equal_full(const struct genhash *pgenhash1,
     return FALSE;
   }
 
+  if (pgenhash1->cells != nullptr) {
+    const struct genhash_cell *cell1 = pgenhash1->cells;
+    const struct genhash_cell *end1 = cell1 + pgenhash1->num_buckets;
+
+    for (; cell1 < end1; cell1++) {
+      if (cell1->dist != 0
+          && !genhash_has_pair(pgenhash2, cell1->key, cell1->data,
+                               cell1->hash_val, data_comp_func)) {
+        return FALSE;
+      }
+    }
+
+    return TRUE;
+  }
+
   /* Compare buckets. */
   bucket1 = pgenhash1->buckets;
   max1 = bucket1 + pgenhash1->num_buckets;
   for (; bucket1 < max1; bucket1++) {
     for (iter1 = *bucket1; iter1 != nullptr; iter1 = iter1->next) {
-      slot2 = genhash_slot_lookup(pgenhash2, iter1->key, iter1->hash_val);
-      if (*slot2 == nullptr
-          || (iter1->data != (*slot2)->data
-              && (data_comp_func == nullptr
-                  || !data_comp_func(iter1->data, (*slot2)->data)))) {
+      if (!genhash_has_pair(pgenhash2, iter1->key, iter1->data,
+                            iter1->hash_val, data_comp_func)) {
         return FALSE;
       }
     }
@@ -785,6 +1202,10 @@ size_t genhash_iter_sizeof(void)
 void *genhash_iter_key(const struct iterator *genhash_iter)
 {
   struct genhash_iter *iter = GENHASH_ITER(genhash_iter);
+
+  if (iter->cell != nullptr) {
+    return iter->cell->key;
+  }
   return (void *) iter->iterator->key;
 }
 
@@ -794,6 +1215,10 @@ void *genhash_iter_key(const struct iterator *genhash_iter)
 void *genhash_iter_value(const struct iterator *genhash_iter)
 {
   struct genhash_iter *iter = GENHASH_ITER(genhash_iter);
+
+  if (iter->cell != nullptr) {
+    return iter->cell->data;
+  }
   return (void *) iter->iterator->data;
 }
 
@@ -804,6 +1229,15 @@ static void genhash_iter_next(struct iterator *genhash_iter)
 {
   struct genhash_iter *iter = GENHASH_ITER(genhash_iter);
 
+  if (iter->cell != nullptr) {
+    for (iter->cell++; iter->cell < iter->cell_end; iter->cell++) {
+      if (iter->cell->dist != 0) {
+        return;
+      }
+    }
+    return;
+  }
+
   iter->iterator = iter->iterator->next;
   if (iter->iterator != nullptr) {
     return;
@@ -833,6 +1267,10 @@ static void *genhash_iter_get(const struct iterator *genhash_iter)
 static bool genhash_iter_valid(const struct iterator *genhash_iter)
 {
   struct genhash_iter *iter = GENHASH_ITER(genhash_iter);
+
+  if (iter->cell != nullptr) {
+    return iter->cell < iter->cell_end;
+  }
   return iter->bucket < iter->end;
 }
 
@@ -851,6 +1289,22 @@ genhash_iter_init_common(struct genhash_iter *iter,
   iter->vtable.next = genhash_iter_next;
   iter->vtable.get = get;
   iter->vtable.valid = genhash_iter_valid;
+
+  if (pgenhash->cells != nullptr) {
+    iter->cell = pgenhash->cells;
+    iter->cell_end = pgenhash->cells + pgenhash->num_buckets;
+
+    /* Seek to the first used cell. */
+    for (; iter->cell < iter->cell_end; iter->cell++) {
+      if (iter->cell->dist != 0) {
+        break;
+      }
+    }
+
+    return ITERATOR(iter);
+  }
+
+  iter->cell = nullptr;
   iter->bucket = pgenhash->buckets;
   iter->end = pgenhash->buckets + pgenhash->num_buckets;
 
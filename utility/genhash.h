@@ -77,6 +77,9 @@ void genhash_destroy(struct genhash *pgenhash)
 
 bool genhash_set_no_shrink(struct genhash *pgenhash, bool no_shrink)
   fc__attribute((nonnull (1)));
+bool genhash_set_open_addressing(struct genhash *pgenhash,
+                                 bool open_addressing)
+  fc__attribute((nonnull (1)));
 size_t genhash_size(const struct genhash *pgenhash)
   fc__attribute((nonnull (1)));
 size_t genhash_capacity(const struct genhash *pgenhash)
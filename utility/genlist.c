@@ -25,6 +25,99 @@
 
 #include "genlist.h"
 
+/* Links are allocated in blocks of this many. */
+#define GENLIST_SLAB_SIZE 256
+
+/* Links are carved from the current block of the thread, and freed links
+ * go to the free list of the thread that frees them. Freed links are
+ * never returned to the system, but there are no locks involved. When
+ * a thread finishes, its blocks and free links go to a common pool,
+ * where threads running out of links pick them up a block worth at a
+ * time. */
+struct genlist_slab {
+  struct genlist_slab *next;
+  int used;
+  struct genlist_link links[GENLIST_SLAB_SIZE];
+};
+
+static _Thread_local struct genlist_slab *link_slabs = nullptr;
+static _Thread_local struct genlist_link *free_links = nullptr;
+
+static struct {
+  bool ready;
+  fc_mutex mutex;
+  struct genlist_slab *slabs;   /* Only kept for reference */
+  struct genlist_link *free_links;
+} link_pool = { .ready = FALSE };
+
+/************************************************************************//**
+  Initialize the pool of links left behind by finished threads.
+****************************************************************************/
+void genlist_pool_init(void)
+{
+  fc_mutex_init(&link_pool.mutex);
+  link_pool.ready = TRUE;
+}
+
+/************************************************************************//**
+  Free the pool of links left behind by finished threads.
+****************************************************************************/
+void genlist_pool_free(void)
+{
+  if (link_pool.ready) {
+    link_pool.ready = FALSE;
+    fc_mutex_destroy(&link_pool.mutex);
+  }
+}
+
+/************************************************************************//**
+  The calling thread is finishing. Hand its links over to the pool.
+****************************************************************************/
+void genlist_thread_exit(void)
+{
+  struct genlist_slab *last_slab = nullptr;
+  struct genlist_link *last_link = nullptr;
+
+  if (!link_pool.ready) {
+    return;
+  }
+
+  if (link_slabs != nullptr) {
+    /* The unused part of the current block becomes free links too. */
+    while (link_slabs->used < GENLIST_SLAB_SIZE) {
+      struct genlist_link *plink = &link_slabs->links[link_slabs->used++];
+
+      plink->next = free_links;
+      free_links = plink;
+    }
+
+    for (last_slab = link_slabs; last_slab->next != nullptr;
+         last_slab = last_slab->next) {
+      /* Nothing. */
+    }
+  }
+  if (free_links != nullptr) {
+    for (last_link = free_links; last_link->next != nullptr;
+         last_link = last_link->next) {
+      /* Nothing. */
+    }
+  }
+
+  fc_mutex_allocate(&link_pool.mutex);
+  if (last_slab != nullptr) {
+    last_slab->next = link_pool.slabs;
+    link_pool.slabs = link_slabs;
+  }
+  if (last_link != nullptr) {
+    last_link->next = link_pool.free_links;
+    link_pool.free_links = free_links;
+  }
+  fc_mutex_release(&link_pool.mutex);
+
+  link_slabs = nullptr;
+  free_links = nullptr;
+}
+
 /************************************************************************//**
   Create a new empty genlist.
 ****************************************************************************/
@@ -44,13 +137,27 @@ struct genlist *genlist_new_full(genlist_free_fn_t free_data_func)
   pgenlist->nelements = 0;
   pgenlist->head_link = nullptr;
   pgenlist->tail_link = nullptr;
+  pgenlist->mutex = nullptr;
 #endif /* ZERO_VARIABLES_FOR_SEARCHING */
-  fc_mutex_init(&pgenlist->mutex);
   pgenlist->free_data_func = free_data_func;
 
   return pgenlist;
 }
 
+/************************************************************************//**
+  Create a new empty genlist that can be locked with
+  genlist_allocate_mutex(), for lists shared between threads.
+****************************************************************************/
+struct genlist *genlist_new_mutexed(void)
+{
+  struct genlist *pgenlist = genlist_new_full(nullptr);
+
+  pgenlist->mutex = fc_malloc(sizeof(*pgenlist->mutex));
+  fc_mutex_init(pgenlist->mutex);
+
+  return pgenlist;
+}
+
 /************************************************************************//**
   Destroys the genlist.
 ****************************************************************************/
@@ -61,10 +168,71 @@ void genlist_destroy(struct genlist *pgenlist)
   }
 
   genlist_clear(pgenlist);
-  fc_mutex_destroy(&pgenlist->mutex);
+  if (pgenlist->mutex != nullptr) {
+    fc_mutex_destroy(pgenlist->mutex);
+    free(pgenlist->mutex);
+  }
   free(pgenlist);
 }
 
+/************************************************************************//**
+  Take a link from the slabs of the calling thread.
+****************************************************************************/
+static struct genlist_link *genlist_link_alloc(void)
+{
+  struct genlist_link *plink = free_links;
+
+  if (plink != nullptr) {
+    free_links = plink->next;
+    return plink;
+  }
+
+  if (link_slabs == nullptr || link_slabs->used == GENLIST_SLAB_SIZE) {
+    struct genlist_slab *pslab;
+
+    if (link_pool.ready) {
+      /* Take at most a block worth of links, so that threads running
+       * at the same time share what there is. */
+      fc_mutex_allocate(&link_pool.mutex);
+      plink = link_pool.free_links;
+      if (plink != nullptr) {
+        struct genlist_link *last = plink;
+        int count = 1;
+
+        while (count < GENLIST_SLAB_SIZE && last->next != nullptr) {
+          last = last->next;
+          count++;
+        }
+        link_pool.free_links = last->next;
+        last->next = nullptr;
+      }
+      fc_mutex_release(&link_pool.mutex);
+
+      if (plink != nullptr) {
+        free_links = plink->next;
+        return plink;
+      }
+    }
+
+    pslab = fc_malloc(sizeof(*pslab));
+
+    pslab->next = link_slabs;
+    pslab->used = 0;
+    link_slabs = pslab;
+  }
+
+  return &link_slabs->links[link_slabs->used++];
+}
+
+/************************************************************************//**
+  Put a link to the free list of the calling thread.
+****************************************************************************/
+static inline void genlist_link_free(struct genlist_link *plink)
+{
+  plink->next = free_links;
+  free_links = plink;
+}
+
 /************************************************************************//**
   Create a new link.
 ****************************************************************************/
@@ -72,7 +240,7 @@ static void genlist_link_new(struct genlist *pgenlist, void *dataptr,
                              struct genlist_link *prev,
                              struct genlist_link *next)
 {
-  struct genlist_link *plink = fc_malloc(sizeof(*plink));
+  struct genlist_link *plink = genlist_link_alloc();
 
   plink->dataptr = dataptr;
   plink->prev = prev;
@@ -115,7 +283,7 @@ static void genlist_link_destroy(struct genlist *pgenlist,
   if (pgenlist->free_data_func != nullptr) {
     pgenlist->free_data_func(plink->dataptr);
   }
-  free(plink);
+  genlist_link_free(plink);
 }
 
 /************************************************************************//**
@@ -259,12 +427,12 @@ void genlist_clear(struct genlist *pgenlist)
       do {
         plink2 = plink->next;
         free_data_func(plink->dataptr);
-        free(plink);
+        genlist_link_free(plink);
       } while ((plink = plink2) != nullptr);
     } else {
       do {
         plink2 = plink->next;
-        free(plink);
+        genlist_link_free(plink);
       } while ((plink = plink2) != nullptr);
     }
   }
@@ -642,11 +810,14 @@ void genlist_reverse(struct genlist *pgenlist)
 }
 
 /************************************************************************//**
-  Allocates list mutex
+  Allocates list mutex. The list must have been created with
+  genlist_new_mutexed().
 ****************************************************************************/
 void genlist_allocate_mutex(struct genlist *pgenlist)
 {
-  fc_mutex_allocate(&pgenlist->mutex);
+  fc_assert_ret(pgenlist->mutex != nullptr);
+
+  fc_mutex_allocate(pgenlist->mutex);
 }
 
 /************************************************************************//**
@@ -654,5 +825,7 @@ void genlist_allocate_mutex(struct genlist *pgenlist)
 ****************************************************************************/
 void genlist_release_mutex(struct genlist *pgenlist)
 {
-  fc_mutex_release(&pgenlist->mutex);
+  fc_assert_ret(pgenlist->mutex != nullptr);
+
+  fc_mutex_release(pgenlist->mutex);
 }
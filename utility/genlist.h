@@ -37,6 +37,11 @@ extern "C" {
   iterator is active, in particular removing the next element pointed
   to by the iterator (see further comments below).
 
+  Lists are not protected by a mutex unless they are created with
+  genlist_new_mutexed(). The links are taken from per-thread slabs
+  rather than allocated one by one, and passed on to other threads when
+  the thread finishes.
+
   See also the speclist module.
 ****************************************************************************/
 
@@ -58,7 +63,7 @@ typedef bool (*genlist_comp_fn_t) (const void *, const void *);
  * of the list. */
 struct genlist {
   int nelements;
-  fc_mutex mutex;
+  fc_mutex *mutex;              /* Only for genlist_new_mutexed() lists. */
   struct genlist_link *head_link;
   struct genlist_link *tail_link;
   genlist_free_fn_t free_data_func;
@@ -67,8 +72,13 @@ struct genlist {
 struct genlist *genlist_new(void) fc__warn_unused_result;
 struct genlist *genlist_new_full(genlist_free_fn_t free_data_func)
                 fc__warn_unused_result;
+struct genlist *genlist_new_mutexed(void) fc__warn_unused_result;
 void genlist_destroy(struct genlist *pgenlist);
 
+void genlist_pool_init(void);
+void genlist_pool_free(void);
+void genlist_thread_exit(void);
+
 struct genlist *genlist_copy(const struct genlist *pgenlist)
                 fc__warn_unused_result;
 struct genlist *genlist_copy_full(const struct genlist *pgenlist,
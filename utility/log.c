@@ -17,6 +17,8 @@
 
 #include <signal.h>
 #include <stdarg.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -43,6 +45,34 @@ static log_prefix_fn log_prefix = nullptr;
 
 static fc_mutex logfile_mutex;
 
+/* Asynchronous logfile writing. Producers put the finished lines to a
+ * bounded ring (one sequence number per slot, so they never need to
+ * lock anything), and a writer thread appends them to the logfile in
+ * batches. When the ring is full, the message is dropped and counted. */
+#define LOG_QUEUE_SIZE    4096   /* Must be a power of 2 */
+#define LOG_RECORD_LEN    256    /* Longer lines are copied to the heap */
+#define LOG_BATCH_LEN     65536
+#define LOG_WRITER_USEC   2000
+
+struct log_record {
+  atomic_size_t seq;
+  char *long_text;
+  char text[LOG_RECORD_LEN];
+};
+
+static struct {
+  struct log_record *slots;
+  atomic_size_t head;      /* Next slot for producers to claim */
+  size_t tail;             /* Next slot for the writer to take */
+  atomic_size_t written;   /* Records the writer has written out */
+  atomic_uint dropped;
+  atomic_bool quit;
+  fc_thread thread;
+  bool atexit_done;
+} log_queue;
+
+static atomic_bool log_async = FALSE;
+
 #ifdef FREECIV_DEBUG
 static const enum log_level max_level = LOG_DEBUG;
 #else
@@ -277,9 +307,246 @@ void log_init(const char *filename, enum log_level initial_level,
 **************************************************************************/
 void log_close(void)
 {
+  log_set_async(FALSE);
   fc_mutex_destroy(&logfile_mutex);
 }
 
+/**********************************************************************//**
+  Put a finished logfile line to the queue of the writer thread. If the
+  queue is full, the line is dropped unless 'wait' is set.
+  Returns whether the line was queued.
+**************************************************************************/
+static bool log_queue_push(const char *line, bool wait)
+{
+  struct log_record *rec;
+  size_t pos = atomic_load_explicit(&log_queue.head, memory_order_relaxed);
+  size_t len;
+
+  for (;;) {
+    size_t seq;
+    intptr_t diff;
+
+    rec = &log_queue.slots[pos & (LOG_QUEUE_SIZE - 1)];
+    seq = atomic_load_explicit(&rec->seq, memory_order_acquire);
+    diff = (intptr_t)seq - (intptr_t)pos;
+
+    if (diff == 0) {
+      if (atomic_compare_exchange_weak_explicit(&log_queue.head, &pos,
+                                                pos + 1,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      /* Full */
+      if (!wait) {
+        atomic_fetch_add(&log_queue.dropped, 1);
+        return FALSE;
+      }
+      fc_usleep(LOG_WRITER_USEC);
+      pos = atomic_load_explicit(&log_queue.head, memory_order_relaxed);
+    } else {
+      pos = atomic_load_explicit(&log_queue.head, memory_order_relaxed);
+    }
+  }
+
+  len = strlen(line);
+  if (len < sizeof(rec->text)) {
+    memcpy(rec->text, line, len + 1);
+    rec->long_text = nullptr;
+  } else {
+    rec->long_text = fc_strdup(line);
+  }
+  atomic_store_explicit(&rec->seq, pos + 1, memory_order_release);
+
+  return TRUE;
+}
+
+/**********************************************************************//**
+  Write one batch of lines to the logfile, or to stderr if the logfile
+  cannot be opened.
+**************************************************************************/
+static void log_writer_output(FILE **fs, const char *text)
+{
+  char *local;
+
+  if (*fs == nullptr) {
+    if (!(*fs = fc_fopen(log_filename, "a"))) {
+      fprintf(stderr, "Couldn't open logfile: %s for appending.\n",
+              log_filename);
+      *fs = stderr;
+    }
+  }
+
+  local = internal_to_local_string_malloc(text);
+  fputs(local, *fs);
+  free(local);
+}
+
+/**********************************************************************//**
+  Main loop of the logfile writer thread.
+**************************************************************************/
+static void log_writer_thread(void *arg)
+{
+  char *batch = fc_malloc(LOG_BATCH_LEN);
+
+  for (;;) {
+    FILE *fs = nullptr;
+    size_t taken = 0;
+    size_t len = 0;
+    unsigned int dropped;
+    bool quit = atomic_load(&log_queue.quit);
+
+    for (;;) {
+      struct log_record *rec
+        = &log_queue.slots[log_queue.tail & (LOG_QUEUE_SIZE - 1)];
+      const char *text;
+      size_t tlen;
+
+      if (atomic_load_explicit(&rec->seq, memory_order_acquire)
+          != log_queue.tail + 1) {
+        break;
+      }
+
+      text = (rec->long_text != nullptr ? rec->long_text : rec->text);
+      tlen = strlen(text);
+      if (len + tlen >= LOG_BATCH_LEN) {
+        if (len > 0) {
+          log_writer_output(&fs, batch);
+          len = 0;
+        }
+        if (tlen >= LOG_BATCH_LEN) {
+          log_writer_output(&fs, text);
+          tlen = 0;
+        }
+      }
+      memcpy(batch + len, text, tlen);
+      len += tlen;
+      batch[len] = '\0';
+
+      free(rec->long_text);
+      rec->long_text = nullptr;
+      atomic_store_explicit(&rec->seq, log_queue.tail + LOG_QUEUE_SIZE,
+                            memory_order_release);
+      log_queue.tail++;
+      taken++;
+    }
+
+    dropped = atomic_exchange(&log_queue.dropped, 0);
+    if (dropped > 0) {
+      char buf[128];
+
+      fc_snprintf(buf, sizeof(buf), "%d: %u log messages dropped\n",
+                  LOG_WARN, dropped);
+      if (len + strlen(buf) >= LOG_BATCH_LEN) {
+        log_writer_output(&fs, batch);
+        len = 0;
+      }
+      fc_strlcpy(batch + len, buf, LOG_BATCH_LEN - len);
+      len += strlen(buf);
+    }
+
+    if (len > 0) {
+      log_writer_output(&fs, batch);
+    }
+    if (fs != nullptr) {
+      fflush(fs);
+      if (fs != stderr) {
+        fclose(fs);
+      }
+    }
+
+    if (taken > 0) {
+      atomic_fetch_add(&log_queue.written, taken);
+    } else if (quit
+               && atomic_load(&log_queue.written)
+                  == atomic_load(&log_queue.head)) {
+      break;
+    } else if (dropped == 0) {
+      fc_usleep(LOG_WRITER_USEC);
+    }
+  }
+
+  free(batch);
+}
+
+/**********************************************************************//**
+  Stop the writer thread when the program exits, so that nothing queued
+  is lost.
+**************************************************************************/
+static void log_async_atexit(void)
+{
+  log_set_async(FALSE);
+}
+
+/**********************************************************************//**
+  Switch asynchronous logfile writing on or off. While on, logfile lines
+  are written by a background thread instead of the logging thread.
+  Console output through the log callback is not affected. Does nothing
+  when there's no logfile. Returns whether asynchronous writing is on.
+**************************************************************************/
+bool log_set_async(bool async)
+{
+  if (async == atomic_load(&log_async)) {
+    return async;
+  }
+
+  if (!async) {
+    atomic_store(&log_async, FALSE);
+    atomic_store(&log_queue.quit, TRUE);
+    fc_thread_wait(&log_queue.thread);
+    free(log_queue.slots);
+    log_queue.slots = nullptr;
+
+    return FALSE;
+  }
+
+  if (log_filename == nullptr) {
+    return FALSE;
+  }
+
+  log_queue.slots = fc_malloc(LOG_QUEUE_SIZE * sizeof(*log_queue.slots));
+  for (size_t i = 0; i < LOG_QUEUE_SIZE; i++) {
+    atomic_init(&log_queue.slots[i].seq, i);
+    log_queue.slots[i].long_text = nullptr;
+  }
+  atomic_store(&log_queue.head, 0);
+  log_queue.tail = 0;
+  atomic_store(&log_queue.written, 0);
+  atomic_store(&log_queue.dropped, 0);
+  atomic_store(&log_queue.quit, FALSE);
+
+  if (fc_thread_start(&log_queue.thread, log_writer_thread, nullptr) != 0) {
+    free(log_queue.slots);
+    log_queue.slots = nullptr;
+    log_error("Failed to start logfile writer thread.");
+
+    return FALSE;
+  }
+
+  if (!log_queue.atexit_done) {
+    atexit(log_async_atexit);
+    log_queue.atexit_done = TRUE;
+  }
+  atomic_store(&log_async, TRUE);
+
+  return TRUE;
+}
+
+/**********************************************************************//**
+  Wait until everything logged so far has been written to the logfile.
+**************************************************************************/
+void log_flush(void)
+{
+  if (atomic_load(&log_async)) {
+    size_t target = atomic_load(&log_queue.head);
+
+    while (atomic_load(&log_queue.written) < target) {
+      fc_usleep(LOG_WRITER_USEC / 4);
+    }
+  }
+}
+
 /**********************************************************************//**
   Adjust the log preparation callback function.
 **************************************************************************/
@@ -368,7 +635,8 @@ bool log_do_output_for_level_at_location(enum log_level level,
 #endif /* FREECIV_DEBUG */
 
 /**********************************************************************//**
-  Unconditionally print a simple string.
+  Unconditionally print a simple string. 'fs' is nullptr when the
+  logfile is written asynchronously.
   Let the callback do its own level formatting and add a '\n' if it wants.
 **************************************************************************/
 static void log_write(FILE *fs, enum log_level level, bool print_from_where,
@@ -384,12 +652,21 @@ static void log_write(FILE *fs, enum log_level level, bool print_from_where,
       prefix[0] = '\0';
     }
 
-    if (log_filename || (print_from_where && where)) {
-      fc_fprintf(fs, "%d: %s%s%s\n", level, prefix, where, message);
+    if (fs == nullptr) {
+      /* Asynchronous logfile; the writer thread converts and writes. */
+      char line[2 * MAX_LEN_LOG_LINE + 256];
+
+      fc_snprintf(line, sizeof(line), "%d: %s%s%s\n",
+                  level, prefix, where, message);
+      log_queue_push(line, level == LOG_FATAL);
     } else {
-      fc_fprintf(fs, "%d: %s%s\n", level, prefix, message);
+      if (log_filename || (print_from_where && where)) {
+        fc_fprintf(fs, "%d: %s%s%s\n", level, prefix, where, message);
+      } else {
+        fc_fprintf(fs, "%d: %s%s\n", level, prefix, message);
+      }
+      fflush(fs);
     }
-    fflush(fs);
   }
 
   if (log_callback) {
@@ -420,8 +697,13 @@ void vdo_log(const char *file, const char *function, int line,
    * simultaneously. */
 
   fc_vsnprintf(buf, buflen, message, args);
-  fc_snprintf(buf_where, sizeof(buf_where), "in %s() [%s::%d]: ",
-              function, file, line);
+  /* Logfile lines always have the location. */
+  if (print_from_where || log_filename != nullptr) {
+    fc_snprintf(buf_where, sizeof(buf_where), "in %s() [%s::%d]: ",
+                function, file, line);
+  } else {
+    buf_where[0] = '\0';
+  }
 
   /* In the default configuration log_pre_callback is equal to log_real(). */
   if (log_pre_callback) {
@@ -438,16 +720,22 @@ void vdo_log(const char *file, const char *function, int line,
 static void log_real(enum log_level level, bool print_from_where,
                      const char *where, const char *msg)
 {
-  static char last_msg[MAX_LEN_LOG_LINE] = "";
-  static unsigned int repeated = 0; /* Total times current message repeated */
-  static unsigned int next = 2; /* Next total to print update */
-  static unsigned int prev = 0; /* Total on last update */
+  /* Repeats are tracked per thread, so that the asynchronous mode
+   * needs no lock here. */
+  static _Thread_local char last_msg[MAX_LEN_LOG_LINE] = "";
+  /* Total times current message repeated */
+  static _Thread_local unsigned int repeated = 0;
+  static _Thread_local unsigned int next = 2; /* Next total to print update */
+  static _Thread_local unsigned int prev = 0; /* Total on last update */
   /* Only count as repeat if same level */
-  static enum log_level prev_level = -1;
+  static _Thread_local enum log_level prev_level = -1;
   char buf[MAX_LEN_LOG_LINE];
+  bool async = (log_filename != nullptr && atomic_load(&log_async));
   FILE *fs;
 
-  if (log_filename) {
+  if (async) {
+    fs = nullptr;
+  } else if (log_filename) {
     fc_mutex_allocate(&logfile_mutex);
     if (!(fs = fc_fopen(log_filename, "a"))) {
       fc_fprintf(stderr,
@@ -505,10 +793,17 @@ static void log_real(enum log_level level, bool print_from_where,
   /* Save last message. */
   sz_strlcpy(last_msg, msg);
 
-  fflush(fs);
-  if (log_filename) {
-    fclose(fs);
-    fc_mutex_release(&logfile_mutex);
+  if (async) {
+    if (level == LOG_FATAL) {
+      /* The program is probably about to die. */
+      log_flush();
+    }
+  } else {
+    fflush(fs);
+    if (log_filename) {
+      fclose(fs);
+      fc_mutex_release(&logfile_mutex);
+    }
   }
 }
 
@@ -572,6 +867,7 @@ void fc_assert_fail(const char *file, const char *function, int line,
          _("Please report this message at %s"), BUG_URL);
 
   if (0 <= fc_fatal_assertions) {
+    log_flush();
     /* Emit a signal. */
     raise(fc_fatal_assertions);
   }
@@ -21,6 +21,7 @@
 #include <fc_config.h>
 #endif
 
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -31,6 +32,11 @@
 
 #include "mem.h"
 
+/* Number of allocations made through fc_malloc() and friends.
+ * Worker threads allocate too, so it is counted atomically. Relaxed
+ * ordering is enough, nothing else is synchronized through it. */
+static atomic_ulong alloc_count = 0;
+
 /******************************************************************//**
   Do whatever we should do when fc_malloc() fails.
   At the moment this just prints a log message and calls exit(EXIT_FAILURE)
@@ -86,6 +92,7 @@ void *fc_real_malloc(size_t size,
   size = MAX(size, 1);
 #endif
 
+  atomic_fetch_add_explicit(&alloc_count, 1, memory_order_relaxed);
   ptr = malloc(size);
   if (ptr == nullptr) {
     handle_alloc_failure(size, called_as, line, file);
@@ -111,6 +118,7 @@ void *fc_real_realloc(void *ptr, size_t size,
   sanity_check_size(size, called_as, line, file);
 #endif /* FREECIV_DEBUG */
 
+  atomic_fetch_add_explicit(&alloc_count, 1, memory_order_relaxed);
   new_ptr = realloc(ptr, size);
   if (!new_ptr) {
     handle_alloc_failure(size, called_as, line, file);
@@ -155,3 +163,13 @@ char *real_fc_strdup(const char *str,
 
   return dest;
 }
+
+/******************************************************************//**
+  Return the number of fc_malloc(), fc_calloc(), fc_realloc() and
+  fc_strdup() calls made so far. Meant for comparing allocation
+  counts between two points in time.
+**********************************************************************/
+unsigned long fc_mem_alloc_count(void)
+{
+  return atomic_load_explicit(&alloc_count, memory_order_relaxed);
+}
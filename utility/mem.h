@@ -61,6 +61,8 @@ char *real_fc_strdup(const char *str,
                      const char *called_as, int line, const char *file)
                      fc__warn_unused_result;
 
+unsigned long fc_mem_alloc_count(void);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -84,6 +84,29 @@ void enable_randlog(bool enable)
  */
 static RANDOM_STATE rand_state;
 
+/* Private state of the calling thread, set by fc_rand_use_state().
+ * When set, all the functions below use it instead of rand_state. */
+static _Thread_local RANDOM_STATE *thread_rand_state = nullptr;
+
+/*********************************************************************//**
+  Return the state the calling thread draws its random numbers from.
+*************************************************************************/
+static inline RANDOM_STATE *current_rand_state(void)
+{
+  return thread_rand_state != nullptr ? thread_rand_state : &rand_state;
+}
+
+/*********************************************************************//**
+  Make fc_rand() and the other functions of this module use pstate in
+  the calling thread, instead of the global state. This lets worker
+  threads draw reproducible sequences of their own. Pass nullptr to
+  return to the global state.
+*************************************************************************/
+void fc_rand_use_state(RANDOM_STATE *pstate)
+{
+  thread_rand_state = pstate;
+}
+
 /*********************************************************************//**
   Returns a new random value from the sequence, in the interval 0 to
   (size-1) inclusive, and updates global state for next call.
@@ -114,9 +137,10 @@ static RANDOM_STATE rand_state;
 RANDOM_TYPE fc_rand_debug(RANDOM_TYPE size, const char *called_as,
                           int line, const char *file)
 {
+  RANDOM_STATE *pstate = current_rand_state();
   RANDOM_TYPE new_rand;
 
-  fc_assert_ret_val(rand_state.is_init, 0);
+  fc_assert_ret_val(pstate->is_init, 0);
 
   if (size > 1) {
     RANDOM_TYPE divisor, max;
@@ -126,13 +150,13 @@ RANDOM_TYPE fc_rand_debug(RANDOM_TYPE size, const char *called_as,
     max = size * divisor - 1;
 
     do {
-      new_rand = (rand_state.v[rand_state.j]
-                  + rand_state.v[rand_state.k]) & MAX_UINT32;
+      new_rand = (pstate->v[pstate->j]
+                  + pstate->v[pstate->k]) & MAX_UINT32;
 
-      rand_state.x = (rand_state.x +1) % 56;
-      rand_state.j = (rand_state.j +1) % 56;
-      rand_state.k = (rand_state.k +1) % 56;
-      rand_state.v[rand_state.x] = new_rand;
+      pstate->x = (pstate->x +1) % 56;
+      pstate->j = (pstate->j +1) % 56;
+      pstate->k = (pstate->k +1) % 56;
+      pstate->v[pstate->x] = new_rand;
 
       if (++bailout > 10000) {
         log_error("%s(%lu) = %lu bailout at %s:%d",
@@ -160,19 +184,20 @@ RANDOM_TYPE fc_rand_debug(RANDOM_TYPE size, const char *called_as,
 *************************************************************************/
 void fc_srand(RANDOM_TYPE seed)
 {
+  RANDOM_STATE *pstate = current_rand_state();
   int i;
 
-  rand_state.v[0] = (seed & MAX_UINT32);
+  pstate->v[0] = (seed & MAX_UINT32);
 
   for (i = 1; i < 56; i++) {
-    rand_state.v[i] = (3 * rand_state.v[i-1] + 257) & MAX_UINT32;
+    pstate->v[i] = (3 * pstate->v[i-1] + 257) & MAX_UINT32;
   }
 
-  rand_state.j = (55 - 55);
-  rand_state.k = (55 - 24);
-  rand_state.x = (55 - 0);
+  pstate->j = (55 - 55);
+  pstate->k = (55 - 24);
+  pstate->x = (55 - 0);
 
-  rand_state.is_init = TRUE;
+  pstate->is_init = TRUE;
 
   /* Heat it up a bit:
    * Using modulus in fc_rand() this was important to pass
@@ -191,7 +216,9 @@ void fc_srand(RANDOM_TYPE seed)
 *************************************************************************/
 void fc_rand_uninit(void)
 {
-  rand_state.is_init = FALSE;
+  RANDOM_STATE *pstate = current_rand_state();
+
+  pstate->is_init = FALSE;
 }
 
 /*********************************************************************//**
@@ -199,7 +226,9 @@ void fc_rand_uninit(void)
 *************************************************************************/
 bool fc_rand_is_init(void)
 {
-  return rand_state.is_init;
+  RANDOM_STATE *pstate = current_rand_state();
+
+  return pstate->is_init;
 }
 
 /*********************************************************************//**
@@ -207,19 +236,20 @@ bool fc_rand_is_init(void)
 *************************************************************************/
 RANDOM_STATE fc_rand_state(void)
 {
+  RANDOM_STATE *pstate = current_rand_state();
   int i;
 
   log_rand("fc_rand_state J=%d K=%d X=%d",
-           rand_state.j, rand_state.k, rand_state.x);
+           pstate->j, pstate->k, pstate->x);
   for (i  = 0; i < 8; i++) {
     log_rand("fc_rand_state %d, %08x %08x %08x %08x %08x %08x %08x",
-             i, rand_state.v[7 * i],
-             rand_state.v[7 * i + 1], rand_state.v[7 * i + 2],
-             rand_state.v[7 * i + 3], rand_state.v[7 * i + 4],
-             rand_state.v[7 * i + 5], rand_state.v[7 * i + 6]);
+             i, pstate->v[7 * i],
+             pstate->v[7 * i + 1], pstate->v[7 * i + 2],
+             pstate->v[7 * i + 3], pstate->v[7 * i + 4],
+             pstate->v[7 * i + 5], pstate->v[7 * i + 6]);
   }
 
-  return rand_state;
+  return *pstate;
 }
 
 /*********************************************************************//**
@@ -228,18 +258,19 @@ RANDOM_STATE fc_rand_state(void)
 *************************************************************************/
 void fc_rand_set_state(RANDOM_STATE state)
 {
+  RANDOM_STATE *pstate = current_rand_state();
   int i;
 
-  rand_state = state;
+  *pstate = state;
 
   log_rand("fc_rand_set_state J=%d K=%d X=%d",
-           rand_state.j, rand_state.k, rand_state.x);
+           pstate->j, pstate->k, pstate->x);
   for (i  = 0; i < 8; i++) {
     log_rand("fc_rand_set_state %d, %08x %08x %08x %08x %08x %08x %08x",
-             i, rand_state.v[7 * i],
-             rand_state.v[7 * i + 1], rand_state.v[7 * i + 2],
-             rand_state.v[7 * i + 3], rand_state.v[7 * i + 4],
-             rand_state.v[7 * i + 5], rand_state.v[7 * i + 6]);
+             i, pstate->v[7 * i],
+             pstate->v[7 * i + 1], pstate->v[7 * i + 2],
+             pstate->v[7 * i + 3], pstate->v[7 * i + 4],
+             pstate->v[7 * i + 5], pstate->v[7 * i + 6]);
   }
 }
 
@@ -91,6 +91,8 @@
  *                               size_t nentries);
  *    void foo_hash_destroy(struct foo_hash *phash);
  *    bool foo_hash_set_no_shrink(struct foo_hash *phash, bool no_shrink);
+ *    bool foo_hash_set_open_addressing(struct foo_hash *phash,
+ *                                      bool open_addressing);
  *    size_t foo_hash_size(const struct foo_hash *phash);
  *    size_t foo_hash_capacity(const struct foo_hash *phash);
  *    struct foo_hash *foo_hash_copy(const struct foo_hash *phash);
@@ -440,6 +442,17 @@ static inline bool SPECHASH_FOO(_hash_set_no_shrink) (SPECHASH_HASH *tthis,
   return genhash_set_no_shrink((struct genhash *) tthis, no_shrink);
 }
 
+/************************************************************************//**
+  Switch between separate chaining and open addressing.
+****************************************************************************/
+static inline bool
+SPECHASH_FOO(_hash_set_open_addressing) (SPECHASH_HASH *tthis,
+                                         bool open_addressing)
+{
+  return genhash_set_open_addressing((struct genhash *) tthis,
+                                     open_addressing);
+}
+
 /************************************************************************//**
   Return the number of elements.
 ****************************************************************************/
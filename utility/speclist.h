@@ -40,6 +40,7 @@
  * and prototypes for the following functions:
  *    struct foo_list *foo_list_new(void);
  *    struct foo_list *foo_list_new_full(foo_list_free_fn_t free_data_func);
+ *    struct foo_list *foo_list_new_mutexed(void);
  *    void foo_list_destroy(struct foo_list *plist);
  *    struct foo_list *foo_list_copy(const struct foolist *plist);
  *    struct foo_list *foo_list_copy_full(const struct foolist *plist,
@@ -184,6 +185,17 @@ SPECLIST_FOO(_list_new_full) (SPECLIST_FOO(_list_free_fn_t) free_data_func)
           genlist_new_full((genlist_free_fn_t) free_data_func));
 }
 
+/************************************************************************//**
+  Create a new speclist that can be locked with *_list_allocate_mutex().
+****************************************************************************/
+static inline SPECLIST_LIST *SPECLIST_FOO(_list_new_mutexed) (void)
+fc__warn_unused_result;
+
+static inline SPECLIST_LIST *SPECLIST_FOO(_list_new_mutexed) (void)
+{
+  return (SPECLIST_LIST *) genlist_new_mutexed();
+}
+
 /************************************************************************//**
   Free a speclist.
 ****************************************************************************/
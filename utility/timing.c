@@ -44,6 +44,8 @@
 #include <fc_config.h>
 #endif
 
+#include <stdio.h>
+#include <string.h>
 #include <time.h>
 
 #ifdef HAVE_GETTIMEOFDAY
@@ -56,6 +58,7 @@
 #endif
 
 /* utility */
+#include "fcthread.h"
 #include "log.h"
 #include "mem.h"
 #include "shared.h"    /* TRUE, FALSE */
@@ -439,3 +442,356 @@ void timer_usleep_since_start(struct timer *t, long usec)
   fc_usleep(usec);
 #endif
 }
+
+/* Profiling zones */
+
+#define PROF_MAX_ZONES 128
+#define PROF_HIST_BUCKETS 24            /* The last one is open ended */
+#define PROF_TRACE_MIN_USEC 100         /* Shorter runs are only counted */
+#define PROF_TRACE_MAX_EVENTS (1 << 20)
+
+struct prof_stats {
+  unsigned long count;
+  prof_time total, max;
+  unsigned long hist[PROF_HIST_BUCKETS];
+};
+
+struct prof_turn_stats {
+  int turn;
+  int zone;
+  struct prof_stats stats;
+};
+
+struct prof_event {
+  int zone;                             /* -1 marks the end of a turn */
+  int turn;
+  prof_time start, duration;
+};
+
+bool prof_active = FALSE;
+
+static struct {
+  const char *zone_names[PROF_MAX_ZONES];
+  int num_zones;
+
+  fc_thread_id thread;
+  prof_time origin;
+  int num_turns;
+
+  /* Statistics of the turn in progress, and of the finished ones */
+  struct prof_stats current[PROF_MAX_ZONES];
+  struct prof_turn_stats *turns;
+  int num_turn_stats, max_turn_stats;
+
+  struct prof_event *events;
+  size_t num_events, max_events;
+  unsigned long dropped_events;
+} prof;
+
+/**********************************************************************//**
+  Return the current wall clock time in microseconds, never 0.
+**************************************************************************/
+prof_time prof_clock(void)
+{
+#ifdef HAVE_GETTIMEOFDAY
+  struct timeval now;
+
+  if (gettimeofday(&now, nullptr) == 0) {
+    return (prof_time) now.tv_sec * N_USEC_PER_SEC + now.tv_usec;
+  }
+#elif defined HAVE_FTIME
+  struct timeb now;
+
+  ftime(&now);
+
+  return (prof_time) now.time * N_USEC_PER_SEC + now.millitm * 1000;
+#endif /* HAVE_GETTIMEOFDAY */
+
+  return (prof_time) clock() * N_USEC_PER_SEC / CLOCKS_PER_SEC + 1;
+}
+
+/**********************************************************************//**
+  Return the start time for a profiling zone, or 0 if the calling thread
+  isn't being profiled.
+**************************************************************************/
+prof_time prof_begin(void)
+{
+  if (!prof_active || !fc_threads_equal(fc_thread_self(), prof.thread)) {
+    return 0;
+  }
+
+  return prof_clock();
+}
+
+/**********************************************************************//**
+  Return the id of the named profiling zone, registering it if needed.
+  Returns -1 if there are too many zones.
+**************************************************************************/
+int prof_zone_id(const char *name)
+{
+  int i;
+
+  for (i = 0; i < prof.num_zones; i++) {
+    if (prof.zone_names[i] == name || !strcmp(prof.zone_names[i], name)) {
+      return i;
+    }
+  }
+
+  if (prof.num_zones >= PROF_MAX_ZONES) {
+    log_error("Too many profiling zones, ignoring \"%s\".", name);
+    return -1;
+  }
+
+  prof.zone_names[prof.num_zones] = name;
+
+  return prof.num_zones++;
+}
+
+/**********************************************************************//**
+  Record a run of the profiling zone that started at 'start' and ends
+  now.
+**************************************************************************/
+void prof_zone_record(int zone, prof_time start)
+{
+  struct prof_stats *pstats;
+  prof_time duration, d;
+  int bucket;
+
+  if (!prof_active || zone < 0 || start < prof.origin) {
+    /* Profiling was stopped or restarted during the run */
+    return;
+  }
+
+  duration = prof_clock() - start;
+
+  pstats = prof.current + zone;
+  pstats->count++;
+  pstats->total += duration;
+  pstats->max = MAX(pstats->max, duration);
+  for (bucket = 0, d = duration; d > 0 && bucket < PROF_HIST_BUCKETS - 1;
+       bucket++) {
+    d >>= 1;
+  }
+  pstats->hist[bucket]++;
+
+  if (duration < PROF_TRACE_MIN_USEC) {
+    return;
+  }
+
+  if (prof.num_events >= PROF_TRACE_MAX_EVENTS) {
+    prof.dropped_events++;
+    return;
+  }
+
+  if (prof.num_events >= prof.max_events) {
+    prof.max_events = MAX(1024, prof.max_events * 2);
+    prof.events = fc_realloc(prof.events,
+                             prof.max_events * sizeof(*prof.events));
+  }
+  prof.events[prof.num_events].zone = zone;
+  prof.events[prof.num_events].turn = 0;
+  prof.events[prof.num_events].start = start - prof.origin;
+  prof.events[prof.num_events].duration = duration;
+  prof.num_events++;
+}
+
+/**********************************************************************//**
+  Finish the profiling statistics of a turn.
+**************************************************************************/
+void prof_turn_done(int turn)
+{
+  int i;
+
+  if (!prof_active) {
+    return;
+  }
+
+  for (i = 0; i < prof.num_zones; i++) {
+    if (prof.current[i].count == 0) {
+      continue;
+    }
+
+    if (prof.num_turn_stats >= prof.max_turn_stats) {
+      prof.max_turn_stats = MAX(256, prof.max_turn_stats * 2);
+      prof.turns = fc_realloc(prof.turns,
+                              prof.max_turn_stats * sizeof(*prof.turns));
+    }
+    prof.turns[prof.num_turn_stats].turn = turn;
+    prof.turns[prof.num_turn_stats].zone = i;
+    prof.turns[prof.num_turn_stats].stats = prof.current[i];
+    prof.num_turn_stats++;
+  }
+  memset(prof.current, 0, sizeof(prof.current));
+  prof.num_turns++;
+
+  if (prof.num_events < PROF_TRACE_MAX_EVENTS) {
+    if (prof.num_events >= prof.max_events) {
+      prof.max_events = MAX(1024, prof.max_events * 2);
+      prof.events = fc_realloc(prof.events,
+                               prof.max_events * sizeof(*prof.events));
+    }
+    prof.events[prof.num_events].zone = -1;
+    prof.events[prof.num_events].turn = turn;
+    prof.events[prof.num_events].start = prof_clock() - prof.origin;
+    prof.events[prof.num_events].duration = 0;
+    prof.num_events++;
+  }
+}
+
+/**********************************************************************//**
+  Start profiling on the calling thread, discarding the data of any
+  previous run. Returns FALSE if profiling is already active.
+**************************************************************************/
+bool prof_start(void)
+{
+  if (prof_active) {
+    return FALSE;
+  }
+
+  prof_free();
+  prof.thread = fc_thread_self();
+  prof.origin = prof_clock();
+  prof_active = TRUE;
+
+  return TRUE;
+}
+
+/**********************************************************************//**
+  Stop profiling. The data is kept for saving until the next
+  prof_start() or prof_free().
+**************************************************************************/
+void prof_stop(void)
+{
+  prof_active = FALSE;
+}
+
+/**********************************************************************//**
+  Stop profiling and free the collected data.
+**************************************************************************/
+void prof_free(void)
+{
+  prof_active = FALSE;
+
+  FC_FREE(prof.turns);
+  prof.num_turn_stats = prof.max_turn_stats = 0;
+  prof.num_turns = 0;
+  memset(prof.current, 0, sizeof(prof.current));
+
+  FC_FREE(prof.events);
+  prof.num_events = prof.max_events = 0;
+  prof.dropped_events = 0;
+}
+
+/**********************************************************************//**
+  Number of turns profiled.
+**************************************************************************/
+int prof_turn_count(void)
+{
+  return prof.num_turns;
+}
+
+/**********************************************************************//**
+  Number of events in the profiling trace.
+**************************************************************************/
+size_t prof_event_count(void)
+{
+  return prof.num_events;
+}
+
+/**********************************************************************//**
+  Write one line of the profiling statistics csv.
+**************************************************************************/
+static void prof_write_stats(FILE *fp, int turn, int zone,
+                             const struct prof_stats *pstats)
+{
+  int i;
+
+  fprintf(fp, "%d,%s,%lu,%f,%f", turn, prof.zone_names[zone],
+          pstats->count, (double) pstats->total / N_USEC_PER_SEC,
+          (double) pstats->max / N_USEC_PER_SEC);
+  for (i = 0; i < PROF_HIST_BUCKETS; i++) {
+    fprintf(fp, ",%lu", pstats->hist[i]);
+  }
+  fprintf(fp, "\n");
+}
+
+/**********************************************************************//**
+  Save the profiling statistics as csv: one line per turn and zone with
+  the number of runs, their total and longest wall time in seconds, and
+  a histogram of their durations in powers of two microseconds. Runs
+  after the last finished turn have turn -1.
+**************************************************************************/
+bool prof_save_csv(const char *filename)
+{
+  FILE *fp = fc_fopen(filename, "w");
+  int i;
+
+  if (fp == nullptr) {
+    log_error("Can't open profiling file \"%s\".", filename);
+    return FALSE;
+  }
+
+  fprintf(fp, "turn,zone,count,total_sec,max_sec");
+  for (i = 0; i < PROF_HIST_BUCKETS - 1; i++) {
+    fprintf(fp, ",lt_%luus", 1UL << i);
+  }
+  fprintf(fp, ",ge_%luus\n", 1UL << (PROF_HIST_BUCKETS - 2));
+
+  for (i = 0; i < prof.num_turn_stats; i++) {
+    prof_write_stats(fp, prof.turns[i].turn, prof.turns[i].zone,
+                     &prof.turns[i].stats);
+  }
+  for (i = 0; i < prof.num_zones; i++) {
+    if (prof.current[i].count > 0) {
+      prof_write_stats(fp, -1, i, prof.current + i);
+    }
+  }
+
+  fclose(fp);
+
+  return TRUE;
+}
+
+/**********************************************************************//**
+  Save the profiling trace in Chrome trace-event json, to be opened with
+  chrome://tracing or Perfetto. Runs of zones shorter than
+  PROF_TRACE_MIN_USEC microseconds are left out.
+**************************************************************************/
+bool prof_save_trace(const char *filename)
+{
+  FILE *fp = fc_fopen(filename, "w");
+  size_t i;
+
+  if (fp == nullptr) {
+    log_error("Can't open profiling file \"%s\".", filename);
+    return FALSE;
+  }
+
+  fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  fprintf(fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+          "\"args\":{\"name\":\"freeciv-server\"}}");
+  for (i = 0; i < prof.num_events; i++) {
+    const struct prof_event *pevent = prof.events + i;
+
+    if (pevent->zone < 0) {
+      fprintf(fp, ",\n{\"name\":\"turn %d\",\"ph\":\"i\",\"s\":\"g\","
+              "\"ts\":%llu,\"pid\":1,\"tid\":1}",
+              pevent->turn, pevent->start);
+    } else {
+      fprintf(fp, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%llu,"
+              "\"dur\":%llu,\"pid\":1,\"tid\":1}",
+              prof.zone_names[pevent->zone], pevent->start,
+              pevent->duration);
+    }
+  }
+  fprintf(fp, "\n]}\n");
+
+  fclose(fp);
+
+  if (prof.dropped_events > 0) {
+    log_normal("%lu profiling events didn't fit in the trace.",
+               prof.dropped_events);
+  }
+
+  return TRUE;
+}
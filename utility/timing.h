@@ -92,6 +92,52 @@ double timer_read_seconds(struct timer *t)
 void timer_usleep_since_start(struct timer *t, long usec)
   fc__attribute((nonnull (1)));
 
+/* Profiling zones. While profiling is active, the wall time of each named
+ * zone is collected into per-turn counts, totals and histograms, and
+ * longer runs of the zones into a trace. Both can be saved: the
+ * statistics as csv, and the trace in Chrome trace-event json.
+ *
+ *   PROF_ZONE_BEGIN(start);
+ *   ...
+ *   PROF_ZONE_END(start, "pf_map_path");
+ *
+ * Zone names must be static strings. Only the thread that started
+ * profiling gets measured. When profiling is not active, a zone costs a
+ * check of prof_active. */
+typedef unsigned long long prof_time;
+
+extern bool prof_active;
+
+bool prof_start(void);
+void prof_stop(void);
+void prof_free(void);
+
+int prof_zone_id(const char *name);
+prof_time prof_clock(void);
+prof_time prof_begin(void);
+void prof_zone_record(int zone, prof_time start);
+void prof_turn_done(int turn);
+
+bool prof_save_csv(const char *filename);
+bool prof_save_trace(const char *filename);
+int prof_turn_count(void);
+size_t prof_event_count(void);
+
+#define PROF_ZONE_BEGIN(_start)                                             \
+  prof_time _start = (prof_active ? prof_begin() : 0)
+
+#define PROF_ZONE_END(_start, _name)                                        \
+  do {                                                                      \
+    if (_start != 0) {                                                      \
+      static int _zone_##_start = -1;                                       \
+                                                                            \
+      if (_zone_##_start < 0) {                                             \
+        _zone_##_start = prof_zone_id(_name);                               \
+      }                                                                     \
+      prof_zone_record(_zone_##_start, _start);                             \
+    }                                                                       \
+  } while (FALSE)
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */